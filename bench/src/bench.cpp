@@ -0,0 +1,101 @@
+#include "bench.h"
+
+#include <fmt/format.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <Windows.h>
+#include <Psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace {
+	std::atomic<std::size_t> allocation_count{0};
+	std::atomic<std::size_t> current_bytes{0};
+	std::atomic<std::size_t> peak_bytes{0};
+	void const* volatile escaped_value = nullptr;
+
+	// Each block keeps its size in front of the user data, so that the unsized delete can update the live byte count
+	constexpr std::size_t header_size = alignof(std::max_align_t);
+
+	auto tracked_allocate(std::size_t size) -> void* {
+		void* const block = std::malloc(size + header_size);
+		if(block == nullptr) {
+			throw std::bad_alloc();
+		}
+		*static_cast<std::size_t*>(block) = size;
+
+		allocation_count.fetch_add(1, std::memory_order_relaxed);
+		auto const live = current_bytes.fetch_add(size, std::memory_order_relaxed) + size;
+		auto peak = peak_bytes.load(std::memory_order_relaxed);
+		while(live > peak && !peak_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) { }
+
+		return static_cast<char*>(block) + header_size;
+	}
+
+	void tracked_free(void* p) noexcept {
+		if(p == nullptr) {
+			return;
+		}
+		void* const block = static_cast<char*>(p) - header_size;
+		current_bytes.fetch_sub(*static_cast<std::size_t*>(block), std::memory_order_relaxed);
+		std::free(block);
+	}
+}
+
+auto operator new(std::size_t size) -> void* { return tracked_allocate(size); }
+auto operator new[](std::size_t size) -> void* { return tracked_allocate(size); }
+void operator delete(void* p) noexcept { tracked_free(p); }
+void operator delete[](void* p) noexcept { tracked_free(p); }
+void operator delete(void* p, std::size_t) noexcept { tracked_free(p); }
+void operator delete[](void* p, std::size_t) noexcept { tracked_free(p); }
+
+namespace bench {
+	void reset_heap_stats() noexcept {
+		allocation_count = 0;
+		peak_bytes = current_bytes.load();
+	}
+
+	auto get_heap_stats() noexcept -> heap_stats {
+		return {allocation_count.load(), peak_bytes.load(), current_bytes.load()};
+	}
+
+	auto get_peak_resident_bytes() noexcept -> std::size_t {
+#if defined(_WIN32)
+		PROCESS_MEMORY_COUNTERS counters;
+		if(!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+			return 0;
+		}
+		return counters.PeakWorkingSetSize;
+#else
+		rusage usage;
+		if(getrusage(RUSAGE_SELF, &usage) != 0) {
+			return 0;
+		}
+#if defined(__APPLE__)
+		return static_cast<std::size_t>(usage.ru_maxrss);
+#else
+		return static_cast<std::size_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+	}
+
+	void print_header(std::string_view benchmark_name) {
+		fmt::print("\n{}\n", benchmark_name);
+		fmt::print("{:<40} {:>12} {:>14} {:>14}\n", "", "time (ms)", "heap peak (KB)", "allocations");
+	}
+
+	void print_measurement(std::string_view label, measurement const& m) {
+		fmt::print("{:<40} {:>12.3f} {:>14} {:>14}\n", label, m.seconds * 1000.0, m.heap.peak_bytes / 1024, m.heap.allocations);
+	}
+
+	// Out of line so that the address of the value is seen as used
+	void detail::escape(void const* value) {
+		escaped_value = value;
+	}
+}
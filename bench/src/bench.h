@@ -0,0 +1,66 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <string_view>
+#include <utility>
+
+namespace bench {
+	// Heap usage, as seen by the benchmark executable's global operator new and delete
+	struct heap_stats {
+		// Number of allocations since the last reset
+		std::size_t allocations;
+		// Peak of live heap bytes since the last reset
+		std::size_t peak_bytes;
+		// Live heap bytes right now
+		std::size_t current_bytes;
+	};
+
+	// Sets the peak to the current usage, and the allocation count to zero
+	void reset_heap_stats() noexcept;
+	[[nodiscard]] auto get_heap_stats() noexcept -> heap_stats;
+
+	// Peak resident set size of the process, in bytes. Since it never goes down, run a single benchmark per process
+	// to get a meaningful value. Returns 0 if not supported on the platform
+	[[nodiscard]] auto get_peak_resident_bytes() noexcept -> std::size_t;
+
+	struct measurement {
+		double seconds;
+		heap_stats heap;
+	};
+
+	// Runs f 'iterations' times, and returns the fastest run along with the heap usage of that run
+	template<typename F>
+	auto measure(int iterations, F&& f) -> measurement {
+		measurement best{};
+		for(int i = 0; i < iterations; ++i) {
+			reset_heap_stats();
+			auto const base_bytes = get_heap_stats().current_bytes;
+			auto const start = std::chrono::steady_clock::now();
+			f();
+			auto const end = std::chrono::steady_clock::now();
+			auto heap = get_heap_stats();
+			heap.peak_bytes -= base_bytes;
+			heap.current_bytes -= base_bytes;
+
+			double const seconds = std::chrono::duration<double>(end - start).count();
+			if(i == 0 || seconds < best.seconds) {
+				best = measurement{seconds, heap};
+			}
+		}
+		return best;
+	}
+
+	void print_header(std::string_view benchmark_name);
+	void print_measurement(std::string_view label, measurement const& m);
+
+	namespace detail {
+		void escape(void const* value);
+	}
+
+	// Keeps the compiler from optimizing away a computed value
+	template<typename T>
+	void do_not_optimize(T const& value) {
+		detail::escape(&value);
+	}
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+namespace bench {
+	// Streaming against document loading of a large Tiled map
+	void tiled_load();
+	// Single loader runs, so that the process peak resident set can be compared between separate runs
+	void tiled_load_document();
+	void tiled_load_streaming();
+	// Loading of the same map with each encoding of the tile layer data
+	void tiled_encoding();
+	// Document loading with the layer data converted over thread pools of increasing size
+	void tiled_parallel();
+	// JSON loading against the mapped binary format
+	void binary_map_load();
+	// Scrolling over compiled maps of increasing size with a fixed chunk memory budget
+	void chunk_streaming();
+	// Memory of the packed chunks of loaded maps, against unpacked chunks
+	void chunk_memory();
+	// Tile lookups by position over layers of increasing size, against searching the chunks one by one
+	void tile_query();
+	// Tile neighborhoods around random walks and random tiles, for each layout of the tiles in chunks and of the chunks in a layer
+	void neighborhood_query();
+	// Objects of a type, found by interned handle against comparing their type strings, and objects in a screen
+	void object_query();
+}
@@ -0,0 +1,56 @@
+#include "bench.h"
+#include "benchmarks.h"
+#include "serial/generate_tiled_map.h"
+
+#include <game/map.h>
+#include <serial/tiled.h>
+
+#include <fmt/format.h>
+
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+namespace bench {
+	void object_query() {
+		constexpr int object_count = 200000;
+		constexpr int query_count = 20;
+
+		std::stringstream ss(generate_tiled_map({4, 4, object_count}));
+		auto loaded = serial::load_tiled_json(ss);
+		if(!loaded) {
+			throw std::runtime_error(loaded.error().description);
+		}
+		game::map const& map = *loaded;
+
+		fmt::print("\nobject_query: {} objects, {} distinct strings\n", object_count, map.strings.get_size());
+		measurement const by_handle = measure(query_count, [&] {
+			do_not_optimize(game::find_objects_of_type(map, "trigger").size());
+		});
+		fmt::print("{:<40} {:>12.1f} ns per object\n", "by handle (find_objects_of_type)", by_handle.seconds * 1e9 / object_count);
+
+		// Comparing the type of every object, as done before the types were interned
+		measurement const by_string = measure(query_count, [&] {
+			std::vector<game::object_ref> found;
+			for(std::size_t layer_index = 0; layer_index < map.layers.size(); ++layer_index) {
+				if(auto const objects = std::get_if<game::layer::object_data>(&map.layers[layer_index].data)) {
+					auto const& types = objects->get_types();
+					for(std::size_t i = 0; i < types.size(); ++i) {
+						if(map.strings.get(types[i]) == std::string_view("trigger")) {
+							found.push_back({layer_index, i});
+						}
+					}
+				}
+			}
+			do_not_optimize(found.size());
+		});
+		fmt::print("{:<40} {:>12.1f} ns per object\n", "by string", by_string.seconds * 1e9 / object_count);
+
+		measurement const culling = measure(query_count, [&] {
+			do_not_optimize(game::find_objects_in(map, {0, 0}, {1024, 768}).size());
+		});
+		fmt::print("{:<40} {:>12.1f} ns per object\n", "in a screen (find_objects_in)", culling.seconds * 1e9 / object_count);
+	}
+}
@@ -0,0 +1,143 @@
+#include "bench.h"
+#include "benchmarks.h"
+
+#include <game/map_layout.h>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace bench {
+	namespace {
+		// Tile layer of 'chunks' x 'chunks' chunks, all sharing the same tiles so that millions of them fit in memory
+		auto make_layer(int chunks) -> game::layer::tile_data {
+			game::tile_chunk filled{};
+			filled.tiles.fill(game::tile{game::tile::id{1}});
+			auto const tiles = game::pack_chunk(filled).tiles;
+
+			std::vector<game::packed_chunk> result;
+			result.reserve(static_cast<std::size_t>(chunks) * chunks);
+			for(int y = 0; y < chunks; ++y) {
+				for(int x = 0; x < chunks; ++x) {
+					result.push_back({element_multiply(math::vector2i{x, y}, game::tile_chunk::dimensions), tiles});
+				}
+			}
+			return game::layer::tile_data(std::move(result));
+		}
+	}
+
+	void tile_query() {
+		constexpr std::size_t query_count = 1 << 20;
+		constexpr int linear_search_chunks = 128;
+
+		for(int const chunks : {16, 128, 1024, 2048}) {
+			game::layer::tile_data const layer = make_layer(chunks);
+
+			// Random tiles of the layer, half of them outside of it on the negative side
+			std::mt19937 random(42);
+			std::uniform_int_distribution<int> coordinate(-chunks * game::tile_chunk::dimensions.x / 2, chunks * game::tile_chunk::dimensions.x - 1);
+			std::vector<math::vector2i> queries(query_count);
+			std::generate(queries.begin(), queries.end(), [&] { return math::vector2i{coordinate(random), coordinate(random)}; });
+
+			fmt::print("\ntile_query: {}x{} chunks, {} random tiles\n", chunks, chunks, query_count);
+			measurement const indexed = measure(5, [&] {
+				std::size_t found = 0;
+				for(math::vector2i const query : queries) {
+					found += layer.get_tile(query).data != game::tile::id::none;
+				}
+				do_not_optimize(found);
+			});
+			fmt::print("{:<40} {:>12.1f} ns per tile\n", "indexed", indexed.seconds * 1e9 / query_count);
+
+			// Searching the chunks one by one, as done before the index, on the smaller layers only
+			if(chunks <= linear_search_chunks) {
+				std::size_t const linear_count = query_count / static_cast<std::size_t>(chunks);
+				measurement const linear = measure(1, [&] {
+					std::size_t found = 0;
+					for(std::size_t i = 0; i < linear_count; ++i) {
+						math::vector2i const position = element_multiply(game::get_chunk_coordinates(queries[i]), game::tile_chunk::dimensions);
+						auto const& layer_chunks = layer.get_chunks();
+						found += std::find_if(layer_chunks.begin(), layer_chunks.end(), [position] (game::packed_chunk const& chunk) { return chunk.position == position; }) != layer_chunks.end();
+					}
+					do_not_optimize(found);
+				});
+				fmt::print("{:<40} {:>12.1f} ns per tile\n", "linear search", linear.seconds * 1e9 / linear_count);
+			}
+		}
+	}
+
+	void neighborhood_query() {
+		constexpr int chunks = 128;
+		constexpr int radius = 2;
+		constexpr std::size_t query_count = 1 << 20;
+
+		// Chunks of tiles from 40 ids, so that they are stored as is, listed in random order like a map edited over time
+		std::mt19937 random(42);
+		std::uniform_int_distribution<int> tile_id(1, 40);
+		std::vector<game::packed_chunk> loaded;
+		loaded.reserve(static_cast<std::size_t>(chunks) * chunks);
+		for(int y = 0; y < chunks; ++y) {
+			for(int x = 0; x < chunks; ++x) {
+				game::tile_chunk chunk{element_multiply(math::vector2i{x, y}, game::tile_chunk::dimensions), {}};
+				std::generate(chunk.tiles.begin(), chunk.tiles.end(), [&] { return game::tile{static_cast<game::tile::id>(tile_id(random))}; });
+				loaded.push_back(game::pack_chunk(chunk));
+			}
+		}
+		std::shuffle(loaded.begin(), loaded.end(), random);
+		game::map source;
+		source.layers.push_back({game::layer::id_t{1}, game::layer::tile_data(std::move(loaded))});
+
+		// Centers of random walks, as a search expanding from a tile, and random centers
+		int const side = chunks * game::tile_chunk::dimensions.x;
+		std::uniform_int_distribution<int> coordinate(radius, side - radius - 1);
+		std::uniform_int_distribution<int> step(-1, 1);
+		std::vector<math::vector2i> walk(query_count);
+		math::vector2i center{side / 2, side / 2};
+		for(math::vector2i& query : walk) {
+			if(random() % 4096 == 0) {
+				center = {coordinate(random), coordinate(random)};
+			}
+			center.x = std::clamp(center.x + step(random), radius, side - radius - 1);
+			center.y = std::clamp(center.y + step(random), radius, side - radius - 1);
+			query = center;
+		}
+		std::vector<math::vector2i> scattered(query_count);
+		std::generate(scattered.begin(), scattered.end(), [&] { return math::vector2i{coordinate(random), coordinate(random)}; });
+
+		fmt::print("\nneighborhood_query: {}x{} chunks of raw tiles, {} {}x{} neighborhoods\n", chunks, chunks, query_count, radius * 2 + 1, radius * 2 + 1);
+		struct layout_case {
+			char const* name;
+			game::map_layout layout;
+		};
+		for(layout_case const& c : {layout_case{"row major, loaded order", {game::tile_layout::row_major, false}},
+			                         layout_case{"z-order, loaded order", {game::tile_layout::z_order, false}},
+			                         layout_case{"row major, hilbert order", {game::tile_layout::row_major, true}},
+			                         layout_case{"z-order, hilbert order", {game::tile_layout::z_order, true}}}) {
+			// Repacked in every case, so that the tiles are allocated in the order of their chunks
+			game::map map = source;
+			game::set_layout(map, c.layout);
+			auto const& tiles = std::get<game::layer::tile_data>(map.layers[0].data);
+
+			for(auto const& [queries, label] : {std::pair{&walk, "walk"}, std::pair{&scattered, "scattered"}}) {
+				measurement const m = measure(3, [&] {
+					std::uint32_t sum = 0;
+					for(math::vector2i const query : *queries) {
+						for(int y = query.y - radius; y <= query.y + radius; ++y) {
+							for(int x = query.x - radius; x <= query.x + radius; ++x) {
+								sum += static_cast<std::uint32_t>(tiles.get_tile({x, y}).data);
+							}
+						}
+					}
+					do_not_optimize(sum);
+				});
+				fmt::print("{:<40} {:>12.1f} ns per neighborhood\n", fmt::format("{}, {}", c.name, label), m.seconds * 1e9 / query_count);
+			}
+		}
+	}
+}
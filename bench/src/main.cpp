@@ -0,0 +1,59 @@
+#include "bench.h"
+#include "benchmarks.h"
+
+#include <fmt/format.h>
+
+#include <cstdlib>
+#include <string_view>
+
+namespace {
+	struct benchmark {
+		std::string_view name;
+		void(*run)();
+	};
+
+	constexpr benchmark benchmarks[] = {
+		{"tiled_load", &bench::tiled_load},
+		{"tiled_load_document", &bench::tiled_load_document},
+		{"tiled_load_streaming", &bench::tiled_load_streaming},
+		{"tiled_encoding", &bench::tiled_encoding},
+		{"tiled_parallel", &bench::tiled_parallel},
+		{"binary_map_load", &bench::binary_map_load},
+		{"chunk_streaming", &bench::chunk_streaming},
+		{"chunk_memory", &bench::chunk_memory},
+		{"tile_query", &bench::tile_query},
+		{"neighborhood_query", &bench::neighborhood_query},
+		{"object_query", &bench::object_query},
+	};
+
+	void print_usage() {
+		fmt::print("Usage: AppBench [benchmark...]\nAvailable benchmarks:\n");
+		for(benchmark const& b : benchmarks) {
+			fmt::print("\t{}\n", b.name);
+		}
+	}
+}
+
+// Runs the benchmarks named on the command line, or all of them if none is given
+int main(int argc, char** argv) {
+	bool ran_any = false;
+	for(benchmark const& b : benchmarks) {
+		bool selected = argc <= 1;
+		for(int i = 1; i < argc; ++i) {
+			selected = selected || b.name == argv[i];
+		}
+
+		if(selected) {
+			b.run();
+			ran_any = true;
+		}
+	}
+
+	if(!ran_any) {
+		print_usage();
+		return EXIT_FAILURE;
+	}
+
+	fmt::print("\nProcess peak resident set: {} KB\n", bench::get_peak_resident_bytes() / 1024);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,93 @@
+#include "bench.h"
+#include "benchmarks.h"
+#include "serial/generate_tiled_map.h"
+
+#include <serial/binary_map.h>
+#include <serial/tiled.h>
+#include <sys/mapped_file.h>
+
+#include <fmt/format.h>
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace bench {
+	namespace {
+		auto open_compiled_map(std::filesystem::path const& path) -> sys::mapped_file {
+			auto file = sys::mapped_file::open(path);
+			if(!file) {
+				throw std::runtime_error(file.error().description);
+			}
+			return *std::move(file);
+		}
+
+		auto read_compiled_map(sys::mapped_file const& file) -> serial::binary_map_view {
+			auto const view = serial::read_binary_map(file.data(), file.size());
+			if(!view) {
+				throw std::runtime_error(fmt::format("Compiled map failed to load: {}", view.error().description));
+			}
+			return *view;
+		}
+	}
+
+	void binary_map_load() {
+		std::string const json = generate_tiled_map({128, 128});
+
+		std::istringstream ss(json);
+		auto const map = serial::load_tiled_json(ss);
+		if(!map) {
+			throw std::runtime_error(fmt::format("Generated map failed to load: {}", map.error().description));
+		}
+		auto const binary = serial::compile_binary_map(*map);
+		if(!binary) {
+			throw std::runtime_error(fmt::format("Generated map failed to compile: {}", binary.error().description));
+		}
+
+		auto const path = std::filesystem::temp_directory_path() / "telhar_bench_map.ktmap";
+		{
+			std::ofstream file(path, std::ios::binary | std::ios::trunc);
+			file.write(reinterpret_cast<char const*>(binary->data()), static_cast<std::streamsize>(binary->size()));
+		}
+
+		print_header(fmt::format("binary_map_load: 128x128 chunks, {} KB of JSON, {} KB compiled", json.size() / 1024, binary->size() / 1024));
+
+		print_measurement("JSON (load_tiled_json)", measure(3, [&json] {
+			std::istringstream map_data(json);
+			auto const result = serial::load_tiled_json(map_data);
+			do_not_optimize(result);
+		}));
+
+		// Startup cost of a compiled map: only the tables are read
+		print_measurement("mapped (open + read_binary_map)", measure(3, [&path] {
+			sys::mapped_file const file = open_compiled_map(path);
+			auto const view = read_compiled_map(file);
+			do_not_optimize(view);
+		}));
+
+		print_measurement("mapped + every tile read", measure(3, [&path] {
+			sys::mapped_file const file = open_compiled_map(path);
+			auto const view = read_compiled_map(file);
+			unsigned sum = 0;
+			for(std::size_t layer_index = 0; layer_index < view.get_layer_count(); ++layer_index) {
+				serial::binary_layer_view const layer = view.get_layer(layer_index);
+				for(std::size_t chunk_index = 0; chunk_index < layer.get_chunk_count(); ++chunk_index) {
+					game::tile const* const tiles = layer.get_chunk(chunk_index).tiles;
+					for(int i = 0; i < game::tile_chunk::dimensions.x * game::tile_chunk::dimensions.y; ++i) {
+						sum += static_cast<unsigned>(tiles[i].data);
+					}
+				}
+			}
+			do_not_optimize(sum);
+		}));
+
+		print_measurement("mapped + load_binary_map", measure(3, [&path] {
+			sys::mapped_file const file = open_compiled_map(path);
+			auto const result = serial::load_binary_map(read_compiled_map(file));
+			do_not_optimize(result);
+		}));
+
+		std::filesystem::remove(path);
+	}
+}
@@ -0,0 +1,73 @@
+#include "bench.h"
+#include "benchmarks.h"
+
+#include <serial/binary_map.h>
+#include <serial/chunk_streamer.h>
+#include <sys/thread_pool.h>
+
+#include <fmt/format.h>
+
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+namespace bench {
+	namespace {
+		// Compiled map of a single tile layer of 'chunks' x 'chunks' chunks, in 8 bytes aligned storage
+		auto compile_world(int chunks) -> std::vector<std::uint64_t> {
+			std::vector<game::packed_chunk> tiles;
+			tiles.reserve(static_cast<std::size_t>(chunks) * chunks);
+			for(int y = 0; y < chunks; ++y) {
+				for(int x = 0; x < chunks; ++x) {
+					game::tile_chunk chunk{element_multiply(math::vector2i{x, y}, game::tile_chunk::dimensions), {}};
+					chunk.tiles.fill(game::tile{game::tile::id{1}});
+					tiles.push_back(game::pack_chunk(chunk));
+				}
+			}
+
+			game::map map;
+			map.layers.push_back({game::layer::id_t{1}, game::layer::tile_data(std::move(tiles))});
+			map.tilesets.push_back({"tileset.json", game::tile::id{1}});
+
+			auto const bytes = serial::compile_binary_map(map);
+			if(!bytes) {
+				throw std::runtime_error(fmt::format("Generated map failed to compile: {}", bytes.error().description));
+			}
+			std::vector<std::uint64_t> storage((bytes->size() + 7) / 8);
+			std::memcpy(storage.data(), bytes->data(), bytes->size());
+			return storage;
+		}
+	}
+
+	void chunk_streaming() {
+		// A 1280x720 screen of 32x32 tiles, scrolled diagonally by one tile per frame over the whole world
+		math::vector2i const view_size{40, 23};
+		serial::chunk_streamer_options options;
+		options.memory_budget = 512 * 1024;
+
+		for(int const chunks : {32, 128, 256}) {
+			auto const world = compile_world(chunks);
+			auto const view = serial::read_binary_map(reinterpret_cast<std::byte const*>(world.data()), world.size() * sizeof(std::uint64_t));
+			if(!view) {
+				throw std::runtime_error(fmt::format("Generated map failed to load: {}", view.error().description));
+			}
+
+			int const frames = chunks * game::tile_chunk::dimensions.x - view_size.x;
+			print_header(fmt::format("chunk_streaming: {}x{} chunks, {} KB compiled, {} frames, {} KB budget",
+				chunks, chunks, world.size() * sizeof(std::uint64_t) / 1024, frames, options.memory_budget / 1024));
+
+			sys::thread_pool pool;
+			serial::chunk_streamer_stats stats;
+			print_measurement("scroll, waiting for each frame's loads", measure(1, [&] {
+				serial::chunk_streamer streamer(*view, pool, options);
+				for(int frame = 0; frame < frames; ++frame) {
+					math::vector2i const first{frame, frame * view_size.y / view_size.x};
+					streamer.update(first, first + view_size);
+					streamer.wait();
+				}
+				stats = streamer.get_stats();
+			}));
+			fmt::print("{} chunks loaded, {} evicted, {} resident for {} KB\n", stats.loaded_chunks, stats.evicted_chunks, stats.resident_chunks, stats.resident_bytes / 1024);
+		}
+	}
+}
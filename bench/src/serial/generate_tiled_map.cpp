@@ -0,0 +1,169 @@
+#include "serial/generate_tiled_map.h"
+
+#include "game/tile.h"
+
+#include <fmt/format.h>
+#include <zlib.h>
+
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace bench {
+	namespace {
+		void append_base64(std::string& out, std::vector<std::uint8_t> const& bytes) {
+			constexpr char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+			std::size_t i = 0;
+			for(; i + 3 <= bytes.size(); i += 3) {
+				std::uint32_t const triple = bytes[i] << 16 | bytes[i + 1] << 8 | bytes[i + 2];
+				out += alphabet[triple >> 18 & 0x3F];
+				out += alphabet[triple >> 12 & 0x3F];
+				out += alphabet[triple >> 6 & 0x3F];
+				out += alphabet[triple & 0x3F];
+			}
+
+			if(std::size_t const remainder = bytes.size() - i; remainder != 0) {
+				std::uint32_t const triple = bytes[i] << 16 | (remainder == 2 ? bytes[i + 1] << 8 : 0);
+				out += alphabet[triple >> 18 & 0x3F];
+				out += alphabet[triple >> 12 & 0x3F];
+				out += remainder == 2 ? alphabet[triple >> 6 & 0x3F] : '=';
+				out += '=';
+			}
+		}
+
+		// Window bits of 15 for a zlib stream, or 31 for a gzip stream
+		auto deflate_bytes(std::vector<std::uint8_t> const& bytes, int window_bits) -> std::vector<std::uint8_t> {
+			z_stream stream{};
+			if(deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, window_bits, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+				throw std::runtime_error("Could not initialize zlib");
+			}
+
+			std::vector<std::uint8_t> result(deflateBound(&stream, static_cast<uLong>(bytes.size())));
+			stream.next_in = const_cast<Bytef*>(bytes.data());
+			stream.avail_in = static_cast<uInt>(bytes.size());
+			stream.next_out = result.data();
+			stream.avail_out = static_cast<uInt>(result.size());
+			int const status = deflate(&stream, Z_FINISH);
+			result.resize(stream.total_out);
+			deflateEnd(&stream);
+			if(status != Z_STREAM_END) {
+				throw std::runtime_error("Could not compress tile data");
+			}
+			return result;
+		}
+
+		// Tiled stores encoded tile ids as little-endian 32 bits integers
+		void append_tile_data(std::string& json, std::vector<int> const& tiles, generated_tile_encoding encoding) {
+			if(encoding == generated_tile_encoding::csv) {
+				json += '[';
+				for(std::size_t i = 0; i < tiles.size(); ++i) {
+					if(i != 0) {
+						json += ',';
+					}
+					fmt::format_to(std::back_inserter(json), "{}", tiles[i]);
+				}
+				json += ']';
+				return;
+			}
+
+			std::vector<std::uint8_t> bytes;
+			bytes.reserve(tiles.size() * 4);
+			for(int const tile : tiles) {
+				for(int shift = 0; shift < 32; shift += 8) {
+					bytes.push_back(static_cast<std::uint8_t>(static_cast<std::uint32_t>(tile) >> shift));
+				}
+			}
+
+			if(encoding == generated_tile_encoding::zlib) {
+				bytes = deflate_bytes(bytes, 15);
+			} else if(encoding == generated_tile_encoding::gzip) {
+				bytes = deflate_bytes(bytes, 31);
+			}
+
+			json += '"';
+			append_base64(json, bytes);
+			json += '"';
+		}
+
+		auto encoding_fields(generated_tile_encoding encoding) -> char const* {
+			switch(encoding) {
+			case generated_tile_encoding::base64:
+				return R"("encoding":"base64",)";
+			case generated_tile_encoding::zlib:
+				return R"("compression":"zlib","encoding":"base64",)";
+			case generated_tile_encoding::gzip:
+				return R"("compression":"gzip","encoding":"base64",)";
+			default:
+				return R"("encoding":"csv",)";
+			}
+		}
+	}
+
+	auto generate_tiled_map(generated_map_options const& options) -> std::string {
+		std::mt19937 random(options.seed);
+		std::uniform_int_distribution<int> tile_distribution(1, 8);
+		std::uniform_int_distribution<int> run_distribution(1, 12);
+		std::uniform_int_distribution<int> percent_distribution(0, 99);
+
+		std::string json;
+		auto out = std::back_inserter(json);
+
+		fmt::format_to(out, R"({{"height":{},"infinite":true,"layers":[{{"chunks":[)", options.chunks_y * game::tile_chunk::dimensions.y);
+
+		int const tile_count = game::tile_chunk::dimensions.x * game::tile_chunk::dimensions.y;
+		std::vector<int> tiles;
+		for(int chunk_y = 0; chunk_y < options.chunks_y; ++chunk_y) {
+			for(int chunk_x = 0; chunk_x < options.chunks_x; ++chunk_x) {
+				if(chunk_x != 0 || chunk_y != 0) {
+					json += ',';
+				}
+
+				json += R"({"data":)";
+				tiles.clear();
+				// Drawn only when asked for, so that the other maps keep their pattern
+				int const kind = options.empty_chunk_percent + options.uniform_chunk_percent > 0 ? percent_distribution(random) : 100;
+				if(kind < options.empty_chunk_percent) {
+					tiles.assign(tile_count, 0);
+				} else if(kind < options.empty_chunk_percent + options.uniform_chunk_percent) {
+					tiles.assign(tile_count, tile_distribution(random));
+				} else {
+					int tile = tile_distribution(random);
+					int run = run_distribution(random);
+					for(int i = 0; i < tile_count; ++i) {
+						if(run-- == 0) {
+							tile = tile_distribution(random);
+							run = run_distribution(random);
+						}
+						tiles.push_back(tile);
+					}
+				}
+				append_tile_data(json, tiles, options.encoding);
+				fmt::format_to(out, R"(,"height":{},"width":{},"x":{},"y":{}}})",
+					game::tile_chunk::dimensions.y, game::tile_chunk::dimensions.x,
+					chunk_x * game::tile_chunk::dimensions.x, chunk_y * game::tile_chunk::dimensions.y);
+			}
+		}
+		json += "],";
+		json += encoding_fields(options.encoding);
+		json += R"("height":0,"id":1,"name":"Ground","opacity":1,"startx":0,"starty":0,"type":"tilelayer","visible":true,"width":0,"x":0,"y":0},)";
+
+		json += R"({"draworder":"topdown","id":2,"name":"Objects","objects":[)";
+		std::uniform_int_distribution<int> position_distribution(0, options.chunks_x * game::tile_chunk::dimensions.x * game::tile::dimensions.x);
+		for(int i = 0; i < options.object_count; ++i) {
+			if(i != 0) {
+				json += ',';
+			}
+			fmt::format_to(out, R"({{"height":32,"id":{},"name":"object {}","rotation":0,"type":"{}","visible":true,"width":32,"x":{},"y":{}}})",
+				i + 1, i, i % 2 == 0 ? "spawn" : "trigger", position_distribution(random), position_distribution(random));
+		}
+		json += R"(],"opacity":1,"type":"objectgroup","visible":true,"x":0,"y":0}],)";
+
+		fmt::format_to(out, R"("nextlayerid":3,"nextobjectid":{},"orientation":"orthogonal","renderorder":"right-down","tiledversion":"1.2.2",)", options.object_count + 1);
+		fmt::format_to(out, R"("tileheight":{},"tilesets":[{{"firstgid":1,"source":"test_tileset.json"}},{{"firstgid":5,"source":"test_tileset2.json"}}],)", game::tile::dimensions.y);
+		fmt::format_to(out, R"("tilewidth":{},"type":"map","version":1.2,"width":{}}})", game::tile::dimensions.x, options.chunks_x * game::tile_chunk::dimensions.x);
+
+		return json;
+	}
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <string>
+
+namespace bench {
+	// Encoding of the tile layer data, as offered by Tiled
+	enum class generated_tile_encoding { csv, base64, zlib, gzip };
+
+	struct generated_map_options {
+		// Number of chunks on each axis of the tile layer
+		int chunks_x = 32;
+		int chunks_y = 32;
+		// Number of objects in the object layer
+		int object_count = 1000;
+		// Percentage of the chunks left empty, like the unpainted parts of a large world, and of those filled with a single tile
+		int empty_chunk_percent = 0;
+		int uniform_chunk_percent = 0;
+		// Seed of the tile pattern
+		unsigned seed = 42;
+		generated_tile_encoding encoding = generated_tile_encoding::csv;
+	};
+
+	// Generates the JSON text of an infinite Tiled map, with one tile layer and one object layer.
+	// Tiles come in short runs over two tilesets, like painted terrain would
+	auto generate_tiled_map(generated_map_options const& options) -> std::string;
+}
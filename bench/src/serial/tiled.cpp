@@ -0,0 +1,134 @@
+#include "bench.h"
+#include "benchmarks.h"
+#include "serial/generate_tiled_map.h"
+
+#include <game/map.h>
+#include <serial/tiled.h>
+#include <sys/thread_pool.h>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+namespace bench {
+	namespace {
+		template<typename Loader>
+		auto measure_load(std::string const& json, Loader loader) -> measurement {
+			return measure(3, [&json, loader] {
+				std::istringstream ss(json);
+				auto const result = loader(ss);
+				if(!result) {
+					throw std::runtime_error(fmt::format("Generated map failed to load: {}", result.error().description));
+				}
+				do_not_optimize(result);
+			});
+		}
+	}
+
+	void tiled_load() {
+		// Heap figures are exact per run, while the process peak resident set covers every run: see the single-loader benchmarks
+		for(int const chunks : {16, 64, 128}) {
+			std::string const json = generate_tiled_map({chunks, chunks});
+
+			std::size_t const tile_bytes = static_cast<std::size_t>(chunks) * chunks
+				* game::tile_chunk::dimensions.x * game::tile_chunk::dimensions.y * sizeof(game::tile);
+			print_header(fmt::format("tiled_load: {}x{} chunks, {} KB of JSON, {} KB of tiles", chunks, chunks, json.size() / 1024, tile_bytes / 1024));
+
+			print_measurement("document (load_tiled_json_document)", measure_load(json, &serial::load_tiled_json_document));
+			print_measurement("streaming (load_tiled_json)", measure_load(json, &serial::load_tiled_json));
+		}
+	}
+
+	void tiled_load_document() {
+		std::string const json = generate_tiled_map({128, 128});
+		print_header("tiled_load_document: 128x128 chunks");
+		print_measurement("document (load_tiled_json_document)", measure_load(json, &serial::load_tiled_json_document));
+	}
+
+	void tiled_load_streaming() {
+		std::string const json = generate_tiled_map({128, 128});
+		print_header("tiled_load_streaming: 128x128 chunks");
+		print_measurement("streaming (load_tiled_json)", measure_load(json, &serial::load_tiled_json));
+	}
+
+	void tiled_encoding() {
+		struct encoding_case {
+			char const* name;
+			generated_tile_encoding encoding;
+		};
+
+		constexpr encoding_case cases[] = {
+			{"csv", generated_tile_encoding::csv},
+			{"base64", generated_tile_encoding::base64},
+			{"base64 zlib", generated_tile_encoding::zlib},
+			{"base64 gzip", generated_tile_encoding::gzip},
+		};
+
+		for(encoding_case const& c : cases) {
+			generated_map_options options{64, 64};
+			options.encoding = c.encoding;
+			std::string const json = generate_tiled_map(options);
+			print_header(fmt::format("tiled_encoding: 64x64 chunks, {} tile data, {} KB of JSON", c.name, json.size() / 1024));
+
+			print_measurement("document (load_tiled_json_document)", measure_load(json, &serial::load_tiled_json_document));
+			print_measurement("streaming (load_tiled_json)", measure_load(json, &serial::load_tiled_json));
+		}
+	}
+
+	void tiled_parallel() {
+		for(generated_tile_encoding const encoding : {generated_tile_encoding::csv, generated_tile_encoding::zlib}) {
+			generated_map_options options{128, 128};
+			options.encoding = encoding;
+			std::string const json = generate_tiled_map(options);
+			print_header(fmt::format("tiled_parallel: 128x128 chunks, {} tile data, {} KB of JSON",
+				encoding == generated_tile_encoding::csv ? "csv" : "base64 zlib", json.size() / 1024));
+
+			print_measurement("document (load_tiled_json_document)", measure_load(json, &serial::load_tiled_json_document));
+			print_measurement("streaming (load_tiled_json)", measure_load(json, &serial::load_tiled_json));
+			for(unsigned const thread_count : {1u, 2u, 4u, 8u, 16u}) {
+				sys::thread_pool pool(thread_count);
+				print_measurement(fmt::format("parallel, {} threads", thread_count), measure_load(json, [&pool] (std::istream& map_data) {
+					return serial::load_tiled_json_parallel(map_data, pool);
+				}));
+			}
+		}
+	}
+
+	void chunk_memory() {
+		struct memory_case {
+			char const* name;
+			int empty_chunk_percent;
+			int uniform_chunk_percent;
+		};
+
+		constexpr memory_case cases[] = {
+			{"painted terrain", 0, 0},
+			{"half empty, a quarter uniform", 50, 25},
+			{"mostly empty", 90, 5},
+		};
+
+		for(memory_case const& c : cases) {
+			generated_map_options options{128, 128};
+			options.empty_chunk_percent = c.empty_chunk_percent;
+			options.uniform_chunk_percent = c.uniform_chunk_percent;
+			options.object_count = 0;
+			std::istringstream json(generate_tiled_map(options));
+			auto const map = serial::load_tiled_json(json);
+			if(!map) {
+				throw std::runtime_error(fmt::format("Generated map failed to load: {}", map.error().description));
+			}
+
+			// Against every generated chunk unpacked, empty ones included
+			std::size_t const generated_bytes = static_cast<std::size_t>(options.chunks_x) * options.chunks_y * sizeof(game::tile_chunk);
+			fmt::print("\nchunk_memory: 128x128 chunks, {}, {} KB unpacked\n", c.name, generated_bytes / 1024);
+			for(game::layer_memory const& layer : game::get_memory_report(*map)) {
+				fmt::print("layer {}: {} chunks in {} KB, {} sharing their tiles, {:.1f} times smaller ({} uniform, {} palette, {} palette runs, {} raw)\n",
+					layer.layer_index, layer.chunk_count, layer.packed_bytes / 1024, layer.shared_chunks,
+					static_cast<double>(generated_bytes) / static_cast<double>(std::max<std::size_t>(layer.packed_bytes, 1)),
+					layer.encoding_counts[0], layer.encoding_counts[1], layer.encoding_counts[2], layer.encoding_counts[3]);
+			}
+		}
+	}
+}
@@ -4,6 +4,7 @@
 
 struct SDL_Window;
 struct SDL_Renderer;
+struct SDL_Surface;
 
 namespace sdl {
     struct window_delete {
@@ -14,6 +15,11 @@ namespace sdl {
         void operator()(SDL_Renderer* p) const noexcept;
     };
 
+    struct surface_delete {
+        void operator()(SDL_Surface* p) const noexcept;
+    };
+
     using unique_window = std::unique_ptr<SDL_Window, window_delete>;
     using unique_renderer = std::unique_ptr<SDL_Renderer, renderer_delete>;
+    using unique_surface = std::unique_ptr<SDL_Surface, surface_delete>;
 }
\ No newline at end of file
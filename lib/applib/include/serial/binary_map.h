@@ -0,0 +1,82 @@
+#pragma once
+
+#include "game/map.h"
+
+#include "serial/error.h"
+
+#include <tl/expected.hpp>
+
+#include <cstddef>
+#include <memory_resource>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace serial {
+    namespace detail {
+        struct binary_map_header;
+        struct binary_layer_record;
+    }
+
+    // Compiled binary maps hold the same data as game::map, laid out so that they can be used in place from a mapped file.
+    // Views are only valid as long as the bytes they were read from
+    struct binary_chunk_view {
+        math::vector2i position;
+        // tile_chunk::dimensions.x * tile_chunk::dimensions.y tiles, row by row
+        game::tile const* tiles;
+    };
+
+    struct binary_tileset_view {
+        std::string_view source;
+        game::tile::id starting_id;
+    };
+
+    class binary_layer_view {
+    public:
+        auto get_id() const noexcept -> game::layer::id_t;
+        auto get_type() const noexcept -> game::layer::type;
+
+        // Tile layers: chunks are sorted by row then column
+        auto get_chunk_count() const noexcept -> std::size_t;
+        auto get_chunk(std::size_t index) const noexcept -> binary_chunk_view;
+        auto find_chunk(math::vector2i position) const noexcept -> std::optional<binary_chunk_view>;
+
+        // Object layers: objects are copied out, as they are not stored the same way as game::object. Their names, types and
+        // fonts are interned in 'strings', and their text and points allocated from 'memory'
+        auto get_object_count() const noexcept -> std::size_t;
+        auto get_object(std::size_t index, game::string_pool& strings, std::pmr::memory_resource* memory = std::pmr::get_default_resource()) const -> game::object;
+
+    private:
+        friend class binary_map_view;
+        binary_layer_view(std::byte const* data, detail::binary_layer_record const* record) noexcept : data(data), record(record) {}
+
+        std::byte const* data;
+        detail::binary_layer_record const* record;
+    };
+
+    class binary_map_view {
+    public:
+        auto get_layer_count() const noexcept -> std::size_t;
+        auto get_layer(std::size_t index) const noexcept -> binary_layer_view;
+
+        auto get_tileset_count() const noexcept -> std::size_t;
+        auto get_tileset(std::size_t index) const noexcept -> binary_tileset_view;
+        // See game::map::tile_dimensions
+        auto get_tile_dimensions() const noexcept -> math::vector2i;
+
+    private:
+        friend auto read_binary_map(std::byte const* data, std::size_t size) -> tl::expected<binary_map_view, error>;
+        explicit binary_map_view(std::byte const* data) noexcept : data(data) {}
+
+        std::byte const* data;
+        auto get_header() const noexcept -> detail::binary_map_header const&;
+    };
+
+    // Lays out a map in the binary format
+    auto compile_binary_map(game::map const& map) -> tl::expected<std::vector<std::byte>, error>;
+    // Checks the version, the byte order and every table of a compiled map. Nothing is copied: the returned view reads from 'data',
+    // which must be aligned on 8 bytes
+    auto read_binary_map(std::byte const* data, std::size_t size) -> tl::expected<binary_map_view, error>;
+    // Copies a compiled map into a game::map
+    auto load_binary_map(binary_map_view const& map) -> game::map;
+}
\ No newline at end of file
@@ -0,0 +1,134 @@
+#pragma once
+
+#include "game/chunk_store.h"
+#include "game/packed_chunk.h"
+#include "serial/binary_map.h"
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace sys {
+    class mapped_file;
+    class thread_pool;
+}
+
+namespace serial {
+    struct chunk_streamer_options {
+        // Bytes of resident chunks, packed as game::packed_chunk with identical tiles counted once. Chunks in view are never evicted, even over the budget
+        std::size_t memory_budget = 32 * 1024 * 1024;
+        // Rows or columns of chunks loaded ahead of the view, in the direction it last moved
+        int prefetch_distance = 2;
+        // Loads waiting in the thread pool at once, so that chunks coming into view do not wait behind stale prefetches
+        std::size_t max_pending_loads = 64;
+        // When set, the pages of the map are released once a chunk is copied out of them, so that they do not stay resident too
+        sys::mapped_file const* source_file = nullptr;
+    };
+
+    struct chunk_streamer_stats {
+        std::size_t resident_chunks = 0;
+        std::size_t resident_bytes = 0;
+        std::size_t pending_loads = 0;
+        // Since the streamer was created
+        std::size_t loaded_chunks = 0;
+        std::size_t evicted_chunks = 0;
+    };
+
+    // Keeps the tile layer chunks of a compiled map resident around a view, loading them on a thread pool.
+    // The map view, the bytes it reads and the thread pool must outlive the streamer
+    class chunk_streamer {
+    public:
+        chunk_streamer(binary_map_view map, sys::thread_pool& pool, chunk_streamer_options options = {});
+        chunk_streamer(chunk_streamer const&) = delete;
+        chunk_streamer& operator=(chunk_streamer const&) = delete;
+        // Waits for the loads in progress
+        ~chunk_streamer();
+
+        // Sets the view, in tiles from 'first' to 'last' excluded. Chunks loaded since the last update become resident, missing chunks
+        // in view are requested nearest to its center first, then those ahead of it, and the least recently viewed chunks over the budget are evicted
+        void update(math::vector2i first, math::vector2i last);
+        // Waits for the loads in progress. Their chunks become resident on the next update
+        void wait();
+
+        // Resident chunk of a layer, or nullptr if it is not loaded yet or the layer has no chunk at 'position'
+        auto find_chunk(std::size_t layer_index, math::vector2i position) const -> game::packed_chunk const*;
+
+        // Calls 'f' with the layer index and each resident chunk in view, layer by layer
+        template<typename F>
+        void for_each_in_view(F&& f) const {
+            for(std::size_t const layer_index : tile_layers) {
+                for(int y = view_first.y; y < view_last.y; y += game::tile_chunk::dimensions.y) {
+                    for(int x = view_first.x; x < view_last.x; x += game::tile_chunk::dimensions.x) {
+                        if(game::packed_chunk const* const chunk = find_chunk(layer_index, {x, y})) {
+                            f(layer_index, *chunk);
+                        }
+                    }
+                }
+            }
+        }
+
+        auto get_stats() const -> chunk_streamer_stats;
+
+    private:
+        struct chunk_key {
+            std::size_t layer_index;
+            math::vector2i position;
+
+            auto operator==(chunk_key const& other) const noexcept -> bool {
+                return layer_index == other.layer_index && position == other.position;
+            }
+        };
+
+        struct chunk_key_hash {
+            auto operator()(chunk_key const& key) const noexcept -> std::size_t;
+        };
+
+        struct resident_chunk {
+            game::packed_chunk chunk;
+            std::list<chunk_key>::iterator lru_position;
+            std::uint64_t last_viewed_update;
+        };
+
+        binary_map_view map;
+        sys::thread_pool* pool;
+        chunk_streamer_options options;
+        std::vector<std::size_t> tile_layers;
+
+        std::unordered_map<chunk_key, resident_chunk, chunk_key_hash> resident;
+        // Most recently used first
+        std::list<chunk_key> lru;
+        std::unordered_set<chunk_key, chunk_key_hash> pending;
+        // Identical resident chunks share their tiles, which count once in resident_bytes
+        game::chunk_store chunk_store;
+        std::unordered_map<game::packed_tiles const*, std::size_t> resident_tiles;
+        std::size_t resident_bytes = 0;
+        std::size_t loaded_chunks = 0;
+        std::size_t evicted_chunks = 0;
+
+        // Chunk aligned bounds of the view, in tiles
+        math::vector2i view_first{0, 0};
+        math::vector2i view_last{0, 0};
+        math::vector2i view_center{0, 0};
+        math::vector2i scroll_direction{0, 0};
+        std::uint64_t update_count = 0;
+
+        // Shared with the loads in progress
+        std::mutex loads_mutex;
+        std::condition_variable loads_done;
+        std::vector<std::pair<chunk_key, game::packed_chunk>> loaded;
+        std::size_t loads_in_progress = 0;
+
+        void request(std::vector<chunk_key>& keys);
+        void load(chunk_key key, binary_chunk_view source);
+        void add_resident_bytes(game::packed_chunk const& chunk);
+        void remove_resident_bytes(game::packed_chunk const& chunk);
+        void touch(resident_chunk& chunk);
+        void evict();
+    };
+}
\ No newline at end of file
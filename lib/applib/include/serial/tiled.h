@@ -7,10 +7,34 @@
 
 #include <tl/expected.hpp>
 #include <iosfwd>
+#include <string>
 
 struct SDL_Renderer;
 
+namespace sys {
+    class thread_pool;
+}
+
 namespace serial {
+    // Loads a map in a single pass over the stream, without building a JSON document of the whole map
     auto load_tiled_json(std::istream& map_data) -> tl::expected<game::map, error>;
+    // Loads a map by parsing the whole JSON document first. Accepts and rejects the same maps as load_tiled_json
+    auto load_tiled_json_document(std::istream& map_data) -> tl::expected<game::map, error>;
+    // Same as load_tiled_json_document, with the chunks and objects of every layer converted on the pool threads.
+    // Layer and chunk order, and the error returned for an invalid map, are the same as the sequential loader
+    auto load_tiled_json_parallel(std::istream& map_data, sys::thread_pool& pool) -> tl::expected<game::map, error>;
+    // Whether the stream holds a Tiled map, rather than a tileset or another JSON document
+    auto is_tiled_map(std::istream& data) -> bool;
+
+    struct tiled_tileset_info {
+        // Path as written in the tileset
+        std::string image;
+        math::vector2i tile_dimensions;
+        int tile_count;
+        int columns;
+    };
+
+    // Tiles of any size are accepted, they are drawn at game::tile::dimensions
+    auto get_tiled_tileset_info(std::istream& tileset_data) -> tl::expected<tiled_tileset_info, error>;
     auto get_tiled_tileset_image(std::istream& tileset_data) -> tl::expected<std::string, error>;
 }
\ No newline at end of file
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "serial/error.h"
+#include "serial/tiled.h"
+
+#include <tl/expected.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <string_view>
+
+namespace serial {
+    // Size and modification time of a file, which tell whether it changed without reading it
+    struct file_stamp {
+        std::uintmax_t size;
+        std::int64_t write_time;
+
+        auto operator==(file_stamp const& other) const noexcept -> bool {
+            return size == other.size && write_time == other.write_time;
+        }
+    };
+
+    // Tileset metadata saved between runs, so that unchanged tilesets do not have their whole JSON document parsed again
+    class tileset_cache {
+    public:
+        // Entries of another format version are dropped rather than failing
+        static auto load(std::istream& cache_data) -> tl::expected<tileset_cache, error>;
+        void save(std::ostream& cache_data);
+
+        // Info of tileset 'source' if it was cached with the same stamp
+        auto find(std::string_view source, file_stamp stamp) const -> tiled_tileset_info const*;
+        void insert(std::string source, file_stamp stamp, tiled_tileset_info info);
+
+        // Whether entries were inserted since the cache was loaded or saved
+        auto is_modified() const noexcept -> bool { return modified; }
+
+    private:
+        struct entry {
+            file_stamp stamp;
+            tiled_tileset_info info;
+        };
+
+        std::map<std::string, entry, std::less<>> entries;
+        bool modified = false;
+    };
+}
\ No newline at end of file
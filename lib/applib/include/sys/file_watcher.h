@@ -0,0 +1,39 @@
+#pragma once
+
+#include "serial/error.h"
+
+#include <tl/expected.hpp>
+
+#include <filesystem>
+#include <map>
+#include <vector>
+
+namespace sys {
+    // Reports the watched files modified since the last poll. Their directories are watched rather than the files, so that
+    // files replaced by a rename, as many editors save them, are still reported.
+    // Uses inotify on Linux, and compares modification times on other platforms
+    class file_watcher {
+    public:
+        file_watcher();
+        file_watcher(file_watcher const&) = delete;
+        file_watcher& operator=(file_watcher const&) = delete;
+        ~file_watcher();
+
+        // Replaces the watched files. Files which do not exist yet are reported once created
+        auto watch(std::vector<std::filesystem::path> const& files) -> tl::expected<void, serial::error>;
+        // Does not block. Each modified file is reported once, whatever the number of changes
+        auto poll() -> std::vector<std::filesystem::path>;
+
+    private:
+        std::vector<std::filesystem::path> watched_files;
+#if defined(__linux__)
+        int inotify_descriptor = -1;
+        // Watch descriptor of each directory of the watched files
+        std::map<int, std::filesystem::path> watched_directories;
+#else
+        std::map<std::filesystem::path, std::filesystem::file_time_type> last_write_times;
+#endif
+
+        void unwatch() noexcept;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "serial/error.h"
+
+#include <tl/expected.hpp>
+
+#include <cstddef>
+#include <filesystem>
+
+namespace sys {
+    // Read-only mapping of a whole file in memory. Its pages are only read from disk when first accessed
+    class mapped_file {
+    public:
+        mapped_file() = default;
+        mapped_file(mapped_file&& other) noexcept;
+        mapped_file& operator=(mapped_file&& other) noexcept;
+        ~mapped_file();
+
+        static auto open(std::filesystem::path const& path) -> tl::expected<mapped_file, serial::error>;
+
+        auto data() const noexcept -> std::byte const* { return bytes; }
+        auto size() const noexcept -> std::size_t { return byte_count; }
+
+        // Releases the pages holding 'size' bytes from 'first' from the process' memory. They are read from the file again when accessed
+        void discard(std::byte const* first, std::size_t size) const noexcept;
+
+    private:
+        std::byte const* bytes = nullptr;
+        std::size_t byte_count = 0;
+
+        void close() noexcept;
+    };
+}
\ No newline at end of file
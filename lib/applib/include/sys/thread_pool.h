@@ -0,0 +1,44 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace sys {
+    // Fixed set of worker threads running submitted tasks in submission order
+    class thread_pool {
+    public:
+        // Uses one thread per hardware thread when 'thread_count' is 0
+        explicit thread_pool(unsigned thread_count = 0);
+        thread_pool(thread_pool const&) = delete;
+        thread_pool& operator=(thread_pool const&) = delete;
+        // Finishes the tasks already submitted before joining the threads
+        ~thread_pool();
+
+        auto get_thread_count() const noexcept -> unsigned { return static_cast<unsigned>(threads.size()); }
+
+        template<typename F>
+        auto submit(F f) -> std::future<std::invoke_result_t<F&>> {
+            auto task = std::make_shared<std::packaged_task<std::invoke_result_t<F&>()>>(std::move(f));
+            auto result = task->get_future();
+            push([task] { (*task)(); });
+            return result;
+        }
+
+    private:
+        std::vector<std::thread> threads;
+        std::deque<std::function<void()>> tasks;
+        std::mutex tasks_mutex;
+        std::condition_variable tasks_available;
+        bool stopping = false;
+
+        void push(std::function<void()> task);
+        void work();
+    };
+}
\ No newline at end of file
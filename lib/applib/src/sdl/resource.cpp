@@ -2,6 +2,7 @@
 
 #include <SDL_video.h>
 #include <SDL_render.h>
+#include <SDL_surface.h>
 
 namespace sdl {
     void window_delete::operator()(SDL_Window* p) const noexcept {
@@ -15,4 +16,10 @@ namespace sdl {
             SDL_DestroyRenderer(p);
         }
     }
+
+    void surface_delete::operator()(SDL_Surface* p) const noexcept {
+        if(p != nullptr) {
+            SDL_FreeSurface(p);
+        }
+    }
 }
\ No newline at end of file
@@ -0,0 +1,522 @@
+#include "serial/binary_map.h"
+#include "serial/binary_map_format.h"
+#include "game/chunk_store.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <string>
+#include <tuple>
+
+namespace serial {
+    namespace {
+        using namespace detail;
+
+        template<typename StringT>
+        auto invalid_argument(StringT&& str) {
+            return tl::make_unexpected(error{std::make_error_code(std::errc::invalid_argument), std::forward<StringT>(str)});
+        }
+
+        constexpr std::size_t chunk_tile_count = game::tile_chunk::dimensions.x * game::tile_chunk::dimensions.y;
+
+        static_assert(sizeof(game::tile) == sizeof(std::uint32_t), "Tiles are read in place from 32 bits ids");
+
+        constexpr auto align(std::uint64_t offset) noexcept -> std::uint64_t {
+            return (offset + binary_map_alignment - 1) / binary_map_alignment * binary_map_alignment;
+        }
+
+        template<typename T>
+        auto record_at(std::byte const* data, std::uint64_t offset) noexcept -> T const* {
+            return reinterpret_cast<T const*>(data + offset);
+        }
+
+        // Pools the strings of a map, storing each distinct string once
+        class string_pool_builder {
+        public:
+            auto add(std::string_view s) -> binary_string {
+                auto const it = offsets.find(s);
+                if(it != offsets.end()) {
+                    return {it->second, static_cast<std::uint32_t>(s.size())};
+                }
+
+                auto const offset = static_cast<std::uint32_t>(pool.size());
+                pool.append(s);
+                offsets.emplace(std::string(s), offset);
+                return {offset, static_cast<std::uint32_t>(s.size())};
+            }
+
+            auto get_pool() const noexcept -> std::string const& { return pool; }
+
+        private:
+            std::string pool;
+            std::map<std::string, std::uint32_t, std::less<void>> offsets;
+        };
+
+        auto pack_color(game::rgba32_color color) noexcept -> std::uint32_t {
+            return std::uint32_t(color.r) << 24 | std::uint32_t(color.g) << 16 | std::uint32_t(color.b) << 8 | color.a;
+        }
+
+        auto unpack_color(std::uint32_t color) noexcept -> game::rgba32_color {
+            return {std::uint8_t(color >> 24), std::uint8_t(color >> 16), std::uint8_t(color >> 8), std::uint8_t(color)};
+        }
+
+        // 'map_strings' is the string pool of the map of the objects, and 'strings' the one of the compiled map
+        auto make_object_record(game::layer::object_data const& objects, std::size_t index, game::string_pool const& map_strings, string_pool_builder& strings, std::vector<binary_point>& points) -> binary_object_record {
+            binary_object_record record{};
+            game::object::kind const kind = objects.get_kinds()[index];
+            record.id = static_cast<std::int32_t>(objects.get_ids()[index]);
+            record.kind = static_cast<std::uint32_t>(kind);
+            record.name = strings.add(map_strings.get(objects.get_names()[index]));
+            record.type = strings.add(map_strings.get(objects.get_types()[index]));
+            record.rotation = objects.get_rotations()[index];
+            record.position_x = objects.get_positions()[index].x;
+            record.position_y = objects.get_positions()[index].y;
+            record.width = objects.get_dimensions()[index].x;
+            record.height = objects.get_dimensions()[index].y;
+
+            auto const add_points = [&record, &points] (std::pmr::vector<math::vector2i> const& object_points) {
+                record.first_point = static_cast<std::uint32_t>(points.size());
+                record.point_count = static_cast<std::uint32_t>(object_points.size());
+                for(math::vector2i const point : object_points) {
+                    points.push_back({point.x, point.y});
+                }
+            };
+
+            if(kind == game::object::kind::polygon) {
+                add_points(objects.get_polygon(index).points);
+            } else if(kind == game::object::kind::polyline) {
+                add_points(objects.get_polyline(index).points);
+            } else if(kind == game::object::kind::sprite) {
+                record.gid = static_cast<std::uint32_t>(objects.get_sprite(index).gid);
+            } else if(kind == game::object::kind::text) {
+                game::text_data const& text = objects.get_text(index);
+                record.color = pack_color(text.color);
+                record.text = strings.add(text.text);
+                record.font = strings.add(map_strings.get(text.font));
+                record.point_size = text.point_size;
+                record.valign = static_cast<std::uint8_t>(text.valign);
+                record.halign = static_cast<std::uint8_t>(text.halign);
+                auto const flag = [] (bool set, binary_text_flags value) {
+                    return set ? static_cast<std::uint16_t>(value) : std::uint16_t{0};
+                };
+                record.text_flags = static_cast<std::uint16_t>(flag(text.wrap, text_wrap) | flag(text.kerning, text_kerning)
+                    | flag(text.bold, text_bold) | flag(text.italic, text_italic)
+                    | flag(text.underline, text_underline) | flag(text.strikethrough, text_strikethrough));
+            }
+
+            return record;
+        }
+
+        // Checks that 'count' records of 'element_size' bytes at 'offset' are aligned and inside the file
+        auto is_table_valid(std::uint64_t offset, std::uint64_t count, std::uint64_t element_size, std::uint64_t alignment, std::size_t size) noexcept -> bool {
+            if(offset % alignment != 0 || offset > size) {
+                return false;
+            }
+            return count <= (size - offset) / element_size;
+        }
+
+        auto is_string_valid(binary_string s, binary_map_header const& header) noexcept -> bool {
+            return s.offset <= header.string_pool_size && s.size <= header.string_pool_size - s.offset;
+        }
+
+        auto get_string(std::byte const* data, binary_map_header const& header, binary_string s) noexcept -> std::string_view {
+            return {reinterpret_cast<char const*>(data + header.string_pool_offset + s.offset), s.size};
+        }
+
+        auto validate_object(binary_object_record const& object, binary_map_header const& header) -> tl::expected<void, error> {
+            if(object.kind > static_cast<std::uint32_t>(game::object::kind::sprite)) {
+                return invalid_argument(fmt::format("Object {} has invalid kind {}", object.id, object.kind));
+            }
+            if(!is_string_valid(object.name, header) || !is_string_valid(object.type, header)
+               || !is_string_valid(object.text, header) || !is_string_valid(object.font, header)) {
+                return invalid_argument(fmt::format("Object {} has a string outside of the string pool", object.id));
+            }
+            if(object.first_point > header.point_count || object.point_count > header.point_count - object.first_point) {
+                return invalid_argument(fmt::format("Object {} has points outside of the point table", object.id));
+            }
+            if(object.valign > static_cast<std::uint8_t>(game::text_data::vertical_alignment::bottom)
+               || object.halign > static_cast<std::uint8_t>(game::text_data::horizontal_alignment::justified)) {
+                return invalid_argument(fmt::format("Object {} has invalid text alignment", object.id));
+            }
+            return {};
+        }
+
+        auto validate_layer(std::byte const* data, std::size_t size, binary_map_header const& header, binary_layer_record const& layer) -> tl::expected<void, error> {
+            if(layer.type == binary_layer_type::tile) {
+                if(!is_table_valid(layer.chunk_table_offset, layer.chunk_count, sizeof(binary_chunk_record), alignof(binary_chunk_record), size)) {
+                    return invalid_argument(fmt::format("Layer {} has an invalid chunk table", layer.id));
+                }
+
+                auto const chunks = record_at<binary_chunk_record>(data, layer.chunk_table_offset);
+                for(std::uint32_t i = 0; i < layer.chunk_count; ++i) {
+                    if(!is_table_valid(chunks[i].tiles_offset, chunk_tile_count, sizeof(game::tile), alignof(game::tile), size)) {
+                        return invalid_argument(fmt::format("Layer {} has a chunk with tiles outside of the file", layer.id));
+                    }
+                    if(i != 0 && std::tie(chunks[i].y, chunks[i].x) < std::tie(chunks[i - 1].y, chunks[i - 1].x)) {
+                        return invalid_argument(fmt::format("Layer {} has unsorted chunks", layer.id));
+                    }
+                }
+            } else if(layer.type == binary_layer_type::object) {
+                if(!is_table_valid(layer.object_table_offset, layer.object_count, sizeof(binary_object_record), alignof(binary_object_record), size)) {
+                    return invalid_argument(fmt::format("Layer {} has an invalid object table", layer.id));
+                }
+
+                auto const objects = record_at<binary_object_record>(data, layer.object_table_offset);
+                for(std::uint32_t i = 0; i < layer.object_count; ++i) {
+                    if(auto const valid = validate_object(objects[i], header); !valid) {
+                        return valid;
+                    }
+                }
+            } else {
+                return invalid_argument(fmt::format("Layer {} has invalid type {}", layer.id, static_cast<std::uint32_t>(layer.type)));
+            }
+            return {};
+        }
+    }
+
+    auto binary_layer_view::get_id() const noexcept -> game::layer::id_t {
+        return static_cast<game::layer::id_t>(record->id);
+    }
+
+    auto binary_layer_view::get_type() const noexcept -> game::layer::type {
+        return record->type == binary_layer_type::tile ? game::layer::type::tile : game::layer::type::object;
+    }
+
+    auto binary_layer_view::get_chunk_count() const noexcept -> std::size_t {
+        return record->chunk_count;
+    }
+
+    auto binary_layer_view::get_chunk(std::size_t index) const noexcept -> binary_chunk_view {
+        binary_chunk_record const& chunk = record_at<binary_chunk_record>(data, record->chunk_table_offset)[index];
+        return {{chunk.x, chunk.y}, record_at<game::tile>(data, chunk.tiles_offset)};
+    }
+
+    auto binary_layer_view::find_chunk(math::vector2i position) const noexcept -> std::optional<binary_chunk_view> {
+        auto const first = record_at<binary_chunk_record>(data, record->chunk_table_offset);
+        auto const last = first + record->chunk_count;
+        auto const it = std::lower_bound(first, last, position, [] (binary_chunk_record const& chunk, math::vector2i p) {
+            return std::tie(chunk.y, chunk.x) < std::tie(p.y, p.x);
+        });
+        if(it == last || it->x != position.x || it->y != position.y) {
+            return std::nullopt;
+        }
+        return binary_chunk_view{position, record_at<game::tile>(data, it->tiles_offset)};
+    }
+
+    auto binary_layer_view::get_object_count() const noexcept -> std::size_t {
+        return record->object_count;
+    }
+
+    auto binary_layer_view::get_object(std::size_t index, game::string_pool& strings, std::pmr::memory_resource* memory) const -> game::object {
+        auto const& header = *record_at<binary_map_header>(data, 0);
+        binary_object_record const& record_object = record_at<binary_object_record>(data, record->object_table_offset)[index];
+
+        game::object object;
+        object.id = static_cast<game::object::identifier>(record_object.id);
+        object.name = strings.intern(get_string(data, header, record_object.name));
+        object.type = strings.intern(get_string(data, header, record_object.type));
+        object.rotation = record_object.rotation;
+        object.position = {record_object.position_x, record_object.position_y};
+        object.dimensions = {record_object.width, record_object.height};
+
+        auto const get_points = [this, &header, &record_object] (std::pmr::vector<math::vector2i>& result) {
+            auto const points = record_at<binary_point>(data, header.point_table_offset) + record_object.first_point;
+            result.reserve(record_object.point_count);
+            std::transform(points, points + record_object.point_count, std::back_inserter(result), [] (binary_point p) {
+                return math::vector2i{p.x, p.y};
+            });
+        };
+
+        switch(static_cast<game::object::kind>(record_object.kind)) {
+        case game::object::kind::rectangle:
+            object.kind_data = game::rectangle_data{};
+            break;
+        case game::object::kind::point:
+            object.kind_data = game::point_data{};
+            break;
+        case game::object::kind::ellipse:
+            object.kind_data = game::ellipse_data{};
+            break;
+        case game::object::kind::polygon: {
+            game::polygon_data polygon(memory);
+            get_points(polygon.points);
+            object.kind_data = std::move(polygon);
+            break;
+        }
+        case game::object::kind::polyline: {
+            game::polyline_data polyline(memory);
+            get_points(polyline.points);
+            object.kind_data = std::move(polyline);
+            break;
+        }
+        case game::object::kind::text: {
+            game::text_data text(memory);
+            text.text = get_string(data, header, record_object.text);
+            text.color = unpack_color(record_object.color);
+            text.font = strings.intern(get_string(data, header, record_object.font));
+            text.point_size = record_object.point_size;
+            text.valign = static_cast<game::text_data::vertical_alignment>(record_object.valign);
+            text.halign = static_cast<game::text_data::horizontal_alignment>(record_object.halign);
+            text.wrap = (record_object.text_flags & text_wrap) != 0;
+            text.kerning = (record_object.text_flags & text_kerning) != 0;
+            text.bold = (record_object.text_flags & text_bold) != 0;
+            text.italic = (record_object.text_flags & text_italic) != 0;
+            text.underline = (record_object.text_flags & text_underline) != 0;
+            text.strikethrough = (record_object.text_flags & text_strikethrough) != 0;
+            object.kind_data = std::move(text);
+            break;
+        }
+        case game::object::kind::sprite:
+            object.kind_data = game::sprite_data{static_cast<game::tile::id>(record_object.gid)};
+            break;
+        }
+
+        return object;
+    }
+
+    auto binary_map_view::get_header() const noexcept -> binary_map_header const& {
+        return *record_at<binary_map_header>(data, 0);
+    }
+
+    auto binary_map_view::get_layer_count() const noexcept -> std::size_t {
+        return get_header().layer_count;
+    }
+
+    auto binary_map_view::get_layer(std::size_t index) const noexcept -> binary_layer_view {
+        return {data, record_at<binary_layer_record>(data, get_header().layer_table_offset) + index};
+    }
+
+    auto binary_map_view::get_tile_dimensions() const noexcept -> math::vector2i {
+        auto const& header = get_header();
+        return {static_cast<int>(header.tile_width), static_cast<int>(header.tile_height)};
+    }
+
+    auto binary_map_view::get_tileset_count() const noexcept -> std::size_t {
+        return get_header().tileset_count;
+    }
+
+    auto binary_map_view::get_tileset(std::size_t index) const noexcept -> binary_tileset_view {
+        auto const& header = get_header();
+        binary_tileset_record const& tileset = record_at<binary_tileset_record>(data, header.tileset_table_offset)[index];
+        return {get_string(data, header, tileset.source), static_cast<game::tile::id>(tileset.starting_id)};
+    }
+
+    auto compile_binary_map(game::map const& map) -> tl::expected<std::vector<std::byte>, error> {
+        constexpr auto max_count = std::numeric_limits<std::uint32_t>::max();
+        if(map.layers.size() > max_count || map.tilesets.size() > max_count) {
+            return invalid_argument("Map has too many layers or tilesets");
+        }
+
+        string_pool_builder strings;
+        std::vector<binary_point> points;
+
+        std::vector<binary_tileset_record> tilesets;
+        tilesets.reserve(map.tilesets.size());
+        for(game::tileset const& tileset : map.tilesets) {
+            tilesets.push_back({strings.add(tileset.source), static_cast<std::uint32_t>(tileset.starting_id), 0});
+        }
+
+        // Tables are laid out after the header, layer table and tileset table; tile arrays come after every table
+        std::vector<binary_layer_record> layers;
+        std::vector<std::vector<binary_chunk_record>> chunk_tables(map.layers.size());
+        std::vector<std::vector<game::packed_tiles const*>> chunk_tiles(map.layers.size());
+        std::vector<std::vector<binary_object_record>> object_tables(map.layers.size());
+        layers.reserve(map.layers.size());
+        std::uint64_t tile_array_count = 0;
+        for(std::size_t layer_index = 0; layer_index < map.layers.size(); ++layer_index) {
+            game::layer const& layer = map.layers[layer_index];
+            binary_layer_record record{};
+            record.id = static_cast<std::int32_t>(layer.id);
+
+            if(auto const tile_data = std::get_if<game::layer::tile_data>(&layer.data)) {
+                auto const& chunks = tile_data->get_chunks();
+                record.type = binary_layer_type::tile;
+                if(chunks.size() > max_count) {
+                    return invalid_argument(fmt::format("Layer {} has too many chunks", record.id));
+                }
+                record.chunk_count = static_cast<std::uint32_t>(chunks.size());
+
+                std::vector<std::size_t> order(chunks.size());
+                std::iota(order.begin(), order.end(), std::size_t(0));
+                std::stable_sort(order.begin(), order.end(), [&chunks] (std::size_t lhs, std::size_t rhs) {
+                    return std::tie(chunks[lhs].position.y, chunks[lhs].position.x) < std::tie(chunks[rhs].position.y, chunks[rhs].position.x);
+                });
+
+                for(std::size_t const chunk_index : order) {
+                    game::packed_chunk const& chunk = chunks[chunk_index];
+                    // Tile offsets are relative to the tile arrays until the layout is known
+                    chunk_tables[layer_index].push_back({chunk.position.x, chunk.position.y, tile_array_count++ * chunk_tile_count * sizeof(game::tile)});
+                    chunk_tiles[layer_index].push_back(chunk.tiles.get());
+                }
+            } else {
+                auto const& objects = std::get<game::layer::object_data>(layer.data);
+                record.type = binary_layer_type::object;
+                if(objects.size() > max_count) {
+                    return invalid_argument(fmt::format("Layer {} has too many objects", record.id));
+                }
+                record.object_count = static_cast<std::uint32_t>(objects.size());
+                for(std::size_t object_index = 0; object_index < objects.size(); ++object_index) {
+                    object_tables[layer_index].push_back(make_object_record(objects, object_index, map.strings, strings, points));
+                }
+            }
+            layers.push_back(record);
+        }
+
+        if(points.size() > max_count || strings.get_pool().size() > max_count) {
+            return invalid_argument("Map has too many object points or strings");
+        }
+
+        binary_map_header header{};
+        std::memcpy(header.magic, binary_map_magic, sizeof(header.magic));
+        header.version = binary_map_version;
+        header.byte_order = binary_map_byte_order;
+        header.chunk_size = static_cast<std::uint32_t>(game::tile_chunk::dimensions.x);
+        header.tile_width = static_cast<std::uint32_t>(map.tile_dimensions.x);
+        header.tile_height = static_cast<std::uint32_t>(map.tile_dimensions.y);
+        header.layer_count = static_cast<std::uint32_t>(layers.size());
+        header.tileset_count = static_cast<std::uint32_t>(tilesets.size());
+        header.point_count = static_cast<std::uint32_t>(points.size());
+
+        std::uint64_t offset = sizeof(binary_map_header);
+        header.layer_table_offset = offset;
+        offset = align(offset + layers.size() * sizeof(binary_layer_record));
+        header.tileset_table_offset = offset;
+        offset = align(offset + tilesets.size() * sizeof(binary_tileset_record));
+        for(std::size_t layer_index = 0; layer_index < layers.size(); ++layer_index) {
+            if(layers[layer_index].type == binary_layer_type::tile) {
+                layers[layer_index].chunk_table_offset = offset;
+                offset = align(offset + chunk_tables[layer_index].size() * sizeof(binary_chunk_record));
+            } else {
+                layers[layer_index].object_table_offset = offset;
+                offset = align(offset + object_tables[layer_index].size() * sizeof(binary_object_record));
+            }
+        }
+        header.point_table_offset = offset;
+        offset = align(offset + points.size() * sizeof(binary_point));
+        std::uint64_t const tile_arrays_offset = offset;
+        offset = align(offset + tile_array_count * chunk_tile_count * sizeof(game::tile));
+        header.string_pool_offset = offset;
+        header.string_pool_size = strings.get_pool().size();
+        header.file_size = align(offset + header.string_pool_size);
+
+        std::vector<std::byte> result(header.file_size);
+        auto const write = [&result] (std::uint64_t at, void const* source, std::size_t size) {
+            if(size != 0) {
+                std::memcpy(result.data() + at, source, size);
+            }
+        };
+
+        write(0, &header, sizeof(header));
+        write(header.layer_table_offset, layers.data(), layers.size() * sizeof(binary_layer_record));
+        write(header.tileset_table_offset, tilesets.data(), tilesets.size() * sizeof(binary_tileset_record));
+        // Tiles are stored unpacked, so that they can be used in place
+        game::tile_chunk unpacked;
+        for(std::size_t layer_index = 0; layer_index < layers.size(); ++layer_index) {
+            for(std::size_t chunk_index = 0; chunk_index < chunk_tables[layer_index].size(); ++chunk_index) {
+                binary_chunk_record& chunk = chunk_tables[layer_index][chunk_index];
+                chunk.tiles_offset += tile_arrays_offset;
+                chunk_tiles[layer_index][chunk_index]->decode(unpacked.tiles.data());
+                write(chunk.tiles_offset, unpacked.tiles.data(), chunk_tile_count * sizeof(game::tile));
+            }
+            write(layers[layer_index].chunk_table_offset, chunk_tables[layer_index].data(), chunk_tables[layer_index].size() * sizeof(binary_chunk_record));
+            write(layers[layer_index].object_table_offset, object_tables[layer_index].data(), object_tables[layer_index].size() * sizeof(binary_object_record));
+        }
+        write(header.point_table_offset, points.data(), points.size() * sizeof(binary_point));
+        write(header.string_pool_offset, strings.get_pool().data(), strings.get_pool().size());
+
+        return result;
+    }
+
+    auto read_binary_map(std::byte const* data, std::size_t size) -> tl::expected<binary_map_view, error> {
+        if(reinterpret_cast<std::uintptr_t>(data) % binary_map_alignment != 0) {
+            return invalid_argument("Binary map data is not aligned");
+        }
+        if(size < sizeof(binary_map_header)) {
+            return invalid_argument("Not a binary map");
+        }
+
+        auto const& header = *record_at<binary_map_header>(data, 0);
+        if(std::memcmp(header.magic, binary_map_magic, sizeof(header.magic)) != 0) {
+            return invalid_argument("Not a binary map");
+        }
+        if(header.version != binary_map_version) {
+            return invalid_argument(fmt::format("Binary map version {} is not supported, expected {}", header.version, binary_map_version));
+        }
+        if(header.byte_order != binary_map_byte_order) {
+            return invalid_argument("Binary map was compiled for another byte order");
+        }
+        if(header.chunk_size != static_cast<std::uint32_t>(game::tile_chunk::dimensions.x)) {
+            return invalid_argument(fmt::format("Binary map was compiled for chunks of {} tiles, expected {}", header.chunk_size, game::tile_chunk::dimensions.x));
+        }
+        std::uint32_t const max_tile_side = 4096;
+        if(header.tile_width == 0 || header.tile_width > max_tile_side || header.tile_height == 0 || header.tile_height > max_tile_side) {
+            return invalid_argument("Binary map has invalid tile dimensions");
+        }
+        if(header.file_size != size) {
+            return invalid_argument(fmt::format("Binary map size should be {} bytes, was {}", header.file_size, size));
+        }
+
+        if(!is_table_valid(header.layer_table_offset, header.layer_count, sizeof(binary_layer_record), alignof(binary_layer_record), size)
+           || !is_table_valid(header.tileset_table_offset, header.tileset_count, sizeof(binary_tileset_record), alignof(binary_tileset_record), size)
+           || !is_table_valid(header.point_table_offset, header.point_count, sizeof(binary_point), alignof(binary_point), size)
+           || !is_table_valid(header.string_pool_offset, header.string_pool_size, 1, 1, size)) {
+            return invalid_argument("Binary map has a table outside of the file");
+        }
+
+        auto const tilesets = record_at<binary_tileset_record>(data, header.tileset_table_offset);
+        for(std::uint32_t i = 0; i < header.tileset_count; ++i) {
+            if(!is_string_valid(tilesets[i].source, header)) {
+                return invalid_argument("Binary map has a tileset source outside of the string pool");
+            }
+        }
+
+        auto const layers = record_at<binary_layer_record>(data, header.layer_table_offset);
+        for(std::uint32_t i = 0; i < header.layer_count; ++i) {
+            if(auto const valid = validate_layer(data, size, header, layers[i]); !valid) {
+                return tl::make_unexpected(valid.error());
+            }
+        }
+
+        return binary_map_view(data);
+    }
+
+    auto load_binary_map(binary_map_view const& map) -> game::map {
+        game::map result;
+        result.tile_dimensions = map.get_tile_dimensions();
+        game::chunk_store chunk_store;
+
+        result.tilesets.reserve(map.get_tileset_count());
+        for(std::size_t i = 0; i < map.get_tileset_count(); ++i) {
+            binary_tileset_view const tileset = map.get_tileset(i);
+            result.tilesets.push_back({std::string(tileset.source), tileset.starting_id});
+        }
+
+        result.layers.reserve(map.get_layer_count());
+        for(std::size_t layer_index = 0; layer_index < map.get_layer_count(); ++layer_index) {
+            binary_layer_view const layer = map.get_layer(layer_index);
+            if(layer.get_type() == game::layer::type::tile) {
+                std::vector<game::packed_chunk> chunks;
+                chunks.reserve(layer.get_chunk_count());
+                for(std::size_t chunk_index = 0; chunk_index < layer.get_chunk_count(); ++chunk_index) {
+                    binary_chunk_view const chunk = layer.get_chunk(chunk_index);
+                    chunks.push_back({chunk.position, chunk_store.intern(std::make_shared<game::packed_tiles const>(chunk.tiles))});
+                }
+                game::erase_empty_chunks(chunks);
+                result.layers.push_back({layer.get_id(), game::layer::tile_data(std::move(chunks))});
+            } else {
+                game::layer::object_data objects(result.arena.get());
+                objects.reserve(layer.get_object_count());
+                for(std::size_t object_index = 0; object_index < layer.get_object_count(); ++object_index) {
+                    objects.push_back(layer.get_object(object_index, result.strings, result.arena.get()));
+                }
+                result.layers.push_back({layer.get_id(), std::move(objects)});
+            }
+        }
+
+        return result;
+    }
+}
\ No newline at end of file
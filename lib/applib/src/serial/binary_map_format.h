@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstdint>
+
+// On-disk records of compiled binary maps. Every record is naturally aligned, and every offset is from the start of the file
+namespace serial::detail {
+    constexpr char binary_map_magic[4] = {'K', 'T', 'M', 'P'};
+    constexpr std::uint32_t binary_map_version = 3;
+    // Written as a native integer: a file compiled on a host of another byte order does not match it
+    constexpr std::uint32_t binary_map_byte_order = 0x01020304;
+    constexpr std::uint64_t binary_map_alignment = 8;
+
+    // Range of bytes in the string pool
+    struct binary_string {
+        std::uint32_t offset;
+        std::uint32_t size;
+    };
+
+    struct binary_map_header {
+        char magic[4];
+        std::uint32_t version;
+        std::uint32_t byte_order;
+        std::uint32_t layer_count;
+        std::uint64_t layer_table_offset;
+        std::uint32_t tileset_count;
+        std::uint32_t point_count;
+        std::uint64_t tileset_table_offset;
+        std::uint64_t point_table_offset;
+        std::uint64_t string_pool_offset;
+        std::uint64_t string_pool_size;
+        std::uint64_t file_size;
+        // Of the build which compiled the map, see KT_CHUNK_SIZE: the chunk records are only valid for that size
+        std::uint32_t chunk_size;
+        // Of the source map, see game::map::tile_dimensions
+        std::uint32_t tile_width;
+        std::uint32_t tile_height;
+        std::uint32_t reserved;
+    };
+
+    enum class binary_layer_type : std::uint32_t { tile = 0, object = 1 };
+
+    struct binary_layer_record {
+        std::int32_t id;
+        binary_layer_type type;
+        // Tile layer chunks, sorted by row then column
+        std::uint32_t chunk_count;
+        std::uint32_t object_count;
+        std::uint64_t chunk_table_offset;
+        std::uint64_t object_table_offset;
+    };
+
+    struct binary_chunk_record {
+        std::int32_t x;
+        std::int32_t y;
+        // Packed array of tile_chunk::dimensions.x * tile_chunk::dimensions.y 32 bits tile ids
+        std::uint64_t tiles_offset;
+    };
+
+    struct binary_tileset_record {
+        binary_string source;
+        std::uint32_t starting_id;
+        std::uint32_t reserved;
+    };
+
+    enum binary_text_flags : std::uint32_t {
+        text_wrap = 1 << 0,
+        text_kerning = 1 << 1,
+        text_bold = 1 << 2,
+        text_italic = 1 << 3,
+        text_underline = 1 << 4,
+        text_strikethrough = 1 << 5,
+    };
+
+    // Objects keep every kind of payload in one record, as object layers are small next to tile layers
+    struct binary_object_record {
+        std::int32_t id;
+        std::uint32_t kind;
+        binary_string name;
+        binary_string type;
+        double rotation;
+        std::int32_t position_x;
+        std::int32_t position_y;
+        std::int32_t width;
+        std::int32_t height;
+        // Polygon and polyline points, as a range of the point table
+        std::uint32_t first_point;
+        std::uint32_t point_count;
+        // Sprite
+        std::uint32_t gid;
+        // Text
+        std::uint32_t color;
+        binary_string text;
+        binary_string font;
+        std::int32_t point_size;
+        std::uint8_t valign;
+        std::uint8_t halign;
+        std::uint16_t text_flags;
+    };
+
+    struct binary_point {
+        std::int32_t x;
+        std::int32_t y;
+    };
+
+    static_assert(sizeof(binary_map_header) == 88);
+    static_assert(sizeof(binary_layer_record) == 32);
+    static_assert(sizeof(binary_chunk_record) == 16);
+    static_assert(sizeof(binary_tileset_record) == 16);
+    static_assert(sizeof(binary_object_record) == 88);
+    static_assert(sizeof(binary_point) == 8);
+}
\ No newline at end of file
@@ -0,0 +1,208 @@
+#include "serial/chunk_streamer.h"
+
+#include "sys/mapped_file.h"
+#include "sys/thread_pool.h"
+
+#include <algorithm>
+#include <functional>
+
+namespace serial {
+    namespace {
+        constexpr std::size_t chunk_tile_count = game::tile_chunk::dimensions.x * game::tile_chunk::dimensions.y;
+
+        auto sign(int value) noexcept -> int {
+            return (value > 0) - (value < 0);
+        }
+
+        // Chunk aligned tile coordinates of the chunk holding 'tile'
+        auto get_chunk_origin(math::vector2i tile) noexcept -> math::vector2i {
+            return element_multiply(game::get_chunk_coordinates(tile), game::tile_chunk::dimensions);
+        }
+
+
+        // Squared distance from the center of a chunk to 'doubled_center', in doubled tile coordinates to stay in integers
+        auto get_distance(math::vector2i position, math::vector2i doubled_center) noexcept -> long long {
+            long long const x = 2ll * position.x + game::tile_chunk::dimensions.x - doubled_center.x;
+            long long const y = 2ll * position.y + game::tile_chunk::dimensions.y - doubled_center.y;
+            return x * x + y * y;
+        }
+    }
+
+    auto chunk_streamer::chunk_key_hash::operator()(chunk_key const& key) const noexcept -> std::size_t {
+        std::uint64_t const position = std::uint64_t{static_cast<std::uint32_t>(key.position.x)} << 32 | static_cast<std::uint32_t>(key.position.y);
+        return std::hash<std::uint64_t>{}(position ^ key.layer_index * 0x9E3779B97F4A7C15ull);
+    }
+
+    chunk_streamer::chunk_streamer(binary_map_view map, sys::thread_pool& pool, chunk_streamer_options options)
+        : map(map)
+        , pool(&pool)
+        , options(options) {
+        for(std::size_t i = 0; i < map.get_layer_count(); ++i) {
+            if(map.get_layer(i).get_type() == game::layer::type::tile) {
+                tile_layers.push_back(i);
+            }
+        }
+    }
+
+    chunk_streamer::~chunk_streamer() {
+        wait();
+    }
+
+    void chunk_streamer::wait() {
+        std::unique_lock lock(loads_mutex);
+        loads_done.wait(lock, [this] { return loads_in_progress == 0; });
+    }
+
+    void chunk_streamer::update(math::vector2i first, math::vector2i last) {
+        ++update_count;
+
+        {
+            std::vector<std::pair<chunk_key, game::packed_chunk>> new_chunks;
+            {
+                std::lock_guard lock(loads_mutex);
+                new_chunks.swap(loaded);
+            }
+
+            for(auto& [key, chunk] : new_chunks) {
+                pending.erase(key);
+                lru.push_front(key);
+                chunk.tiles = chunk_store.intern(std::move(chunk.tiles));
+                add_resident_bytes(chunk);
+                resident.emplace(key, resident_chunk{std::move(chunk), lru.begin(), 0});
+                ++loaded_chunks;
+            }
+        }
+
+        // Doubled, to stay in integers
+        math::vector2i const center = first + last;
+        if(center != view_center && update_count > 1) {
+            scroll_direction = {sign(center.x - view_center.x), sign(center.y - view_center.y)};
+        }
+        view_center = center;
+        view_first = get_chunk_origin(first);
+        view_last = get_chunk_origin(last - math::vector2i{1, 1}) + game::tile_chunk::dimensions;
+
+        // The view extended on the sides it is moving towards
+        math::vector2i const prefetch = element_multiply(scroll_direction * options.prefetch_distance, game::tile_chunk::dimensions);
+        math::vector2i const prefetch_first{view_first.x + std::min(prefetch.x, 0), view_first.y + std::min(prefetch.y, 0)};
+        math::vector2i const prefetch_last{view_last.x + std::max(prefetch.x, 0), view_last.y + std::max(prefetch.y, 0)};
+
+        std::vector<chunk_key> visible_requests;
+        std::vector<chunk_key> prefetch_requests;
+        std::vector<resident_chunk*> visible_chunks;
+        for(std::size_t const layer_index : tile_layers) {
+            binary_layer_view const layer = map.get_layer(layer_index);
+            for(int y = prefetch_first.y; y < prefetch_last.y; y += game::tile_chunk::dimensions.y) {
+                for(int x = prefetch_first.x; x < prefetch_last.x; x += game::tile_chunk::dimensions.x) {
+                    bool const visible = x >= view_first.x && x < view_last.x && y >= view_first.y && y < view_last.y;
+                    chunk_key const key{layer_index, {x, y}};
+                    if(auto const it = resident.find(key); it != resident.end()) {
+                        if(visible) {
+                            visible_chunks.push_back(&it->second);
+                        } else {
+                            touch(it->second);
+                        }
+                    } else if(pending.find(key) == pending.end() && layer.find_chunk(key.position)) {
+                        (visible ? visible_requests : prefetch_requests).push_back(key);
+                    }
+                }
+            }
+        }
+
+        // Chunks in view end up the most recently used, so that eviction stops at the first one
+        for(resident_chunk* const chunk : visible_chunks) {
+            chunk->last_viewed_update = update_count;
+            touch(*chunk);
+        }
+
+        auto const nearest_first = [center] (chunk_key const& lhs, chunk_key const& rhs) {
+            return get_distance(lhs.position, center) < get_distance(rhs.position, center);
+        };
+        std::stable_sort(visible_requests.begin(), visible_requests.end(), nearest_first);
+        std::stable_sort(prefetch_requests.begin(), prefetch_requests.end(), nearest_first);
+        request(visible_requests);
+        request(prefetch_requests);
+
+        evict();
+    }
+
+    void chunk_streamer::request(std::vector<chunk_key>& keys) {
+        for(chunk_key const& key : keys) {
+            if(pending.size() >= options.max_pending_loads) {
+                return;
+            }
+
+            auto const source = map.get_layer(key.layer_index).find_chunk(key.position);
+            pending.insert(key);
+            {
+                std::lock_guard lock(loads_mutex);
+                ++loads_in_progress;
+            }
+            pool->submit([this, key, source = *source] { load(key, source); });
+        }
+    }
+
+    void chunk_streamer::load(chunk_key key, binary_chunk_view source) {
+        game::packed_chunk chunk{source.position, std::make_shared<game::packed_tiles const>(source.tiles)};
+        if(options.source_file != nullptr) {
+            options.source_file->discard(reinterpret_cast<std::byte const*>(source.tiles), chunk_tile_count * sizeof(game::tile));
+        }
+
+        std::lock_guard lock(loads_mutex);
+        loaded.emplace_back(key, std::move(chunk));
+        --loads_in_progress;
+        loads_done.notify_all();
+    }
+
+    void chunk_streamer::add_resident_bytes(game::packed_chunk const& chunk) {
+        if(resident_tiles[chunk.tiles.get()]++ == 0) {
+            resident_bytes += game::get_memory_usage(chunk);
+        } else {
+            resident_bytes += sizeof(game::packed_chunk);
+        }
+    }
+
+    void chunk_streamer::remove_resident_bytes(game::packed_chunk const& chunk) {
+        auto const it = resident_tiles.find(chunk.tiles.get());
+        if(--it->second == 0) {
+            resident_tiles.erase(it);
+            resident_bytes -= game::get_memory_usage(chunk);
+        } else {
+            resident_bytes -= sizeof(game::packed_chunk);
+        }
+    }
+
+    void chunk_streamer::touch(resident_chunk& chunk) {
+        lru.splice(lru.begin(), lru, chunk.lru_position);
+    }
+
+    void chunk_streamer::evict() {
+        while(resident_bytes > options.memory_budget && !lru.empty()) {
+            auto const it = resident.find(lru.back());
+            if(it->second.last_viewed_update == update_count) {
+                // Everything left is in view
+                return;
+            }
+
+            remove_resident_bytes(it->second.chunk);
+            resident.erase(it);
+            lru.pop_back();
+            ++evicted_chunks;
+        }
+    }
+
+    auto chunk_streamer::find_chunk(std::size_t layer_index, math::vector2i position) const -> game::packed_chunk const* {
+        auto const it = resident.find({layer_index, position});
+        return it != resident.end() ? &it->second.chunk : nullptr;
+    }
+
+    auto chunk_streamer::get_stats() const -> chunk_streamer_stats {
+        chunk_streamer_stats stats;
+        stats.resident_chunks = resident.size();
+        stats.resident_bytes = resident_bytes;
+        stats.pending_loads = pending.size();
+        stats.loaded_chunks = loaded_chunks;
+        stats.evicted_chunks = evicted_chunks;
+        return stats;
+    }
+}
\ No newline at end of file
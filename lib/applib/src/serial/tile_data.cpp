@@ -0,0 +1,317 @@
+#include "serial/tile_data.h"
+
+#include <fmt/format.h>
+#include <zlib.h>
+#if defined(KT_ENABLE_ZSTD)
+#include <zstd.h>
+#endif
+
+#include <SDL_endian.h>
+
+#include <array>
+#include <climits>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define KT_BASE64_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define KT_TARGET(features)
+#else
+#define KT_TARGET(features) __attribute__((target(features)))
+#endif
+#endif
+
+namespace serial::detail {
+    namespace {
+        template<typename StringT>
+        auto invalid_argument(StringT&& str) {
+            return tl::make_unexpected(error{std::make_error_code(std::errc::invalid_argument), std::forward<StringT>(str)});
+        }
+
+        // Value of each base64 character, or -1 for characters outside the alphabet
+        constexpr auto base64_values = [] {
+            std::array<std::int8_t, 256> values{};
+            for(auto& value : values) {
+                value = -1;
+            }
+            constexpr char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+            for(int i = 0; i < 64; ++i) {
+                values[static_cast<unsigned char>(alphabet[i])] = static_cast<std::int8_t>(i);
+            }
+            return values;
+        }();
+
+        // Decodes the characters in [in, length) which form complete or partial groups of 4, without padding
+        auto decode_base64_scalar(char const* src, std::size_t length, std::uint8_t* dst, std::size_t& in, std::size_t& out) -> bool {
+            for(; in + 4 <= length; in += 4, out += 3) {
+                int const a = base64_values[static_cast<unsigned char>(src[in])];
+                int const b = base64_values[static_cast<unsigned char>(src[in + 1])];
+                int const c = base64_values[static_cast<unsigned char>(src[in + 2])];
+                int const d = base64_values[static_cast<unsigned char>(src[in + 3])];
+                if((a | b | c | d) < 0) {
+                    return false;
+                }
+                std::uint32_t const bits = (a << 18) | (b << 12) | (c << 6) | d;
+                dst[out] = static_cast<std::uint8_t>(bits >> 16);
+                dst[out + 1] = static_cast<std::uint8_t>(bits >> 8);
+                dst[out + 2] = static_cast<std::uint8_t>(bits);
+            }
+
+            std::size_t const remaining = length - in;
+            if(remaining == 0) {
+                return true;
+            } else if(remaining == 1) {
+                return false;
+            }
+
+            int const a = base64_values[static_cast<unsigned char>(src[in])];
+            int const b = base64_values[static_cast<unsigned char>(src[in + 1])];
+            int const c = remaining == 3 ? base64_values[static_cast<unsigned char>(src[in + 2])] : 0;
+            if((a | b | c) < 0) {
+                return false;
+            }
+            std::uint32_t const bits = (a << 18) | (b << 12) | (c << 6);
+            dst[out++] = static_cast<std::uint8_t>(bits >> 16);
+            if(remaining == 3) {
+                dst[out++] = static_cast<std::uint8_t>(bits >> 8);
+            }
+            in = length;
+            return true;
+        }
+
+#if defined(KT_BASE64_X86)
+        // Vectorized decoding, after Wojciech Mula and Daniel Lemire, "Faster Base64 Encoding and Decoding using AVX2 Instructions".
+        // Character classes are found with two nibble lookups, and each 4 characters are packed into 3 bytes with multiply-adds.
+        // The stores write past the decoded bytes: 4 bytes for SSSE3, 8 bytes for AVX2
+        KT_TARGET("ssse3")
+        auto decode_base64_ssse3(char const* src, std::size_t length, std::uint8_t* dst, std::size_t& in, std::size_t& out) -> bool {
+            __m128i const lut_lo = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+            __m128i const lut_hi = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+            __m128i const lut_roll = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+            __m128i const mask_2f = _mm_set1_epi8(0x2F);
+            __m128i const pack_shuffle = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+
+            for(; in + 16 <= length; in += 16, out += 12) {
+                __m128i const input = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + in));
+                __m128i const hi_nibbles = _mm_and_si128(_mm_srli_epi32(input, 4), mask_2f);
+                __m128i const lo_nibbles = _mm_and_si128(input, mask_2f);
+                __m128i const hi = _mm_shuffle_epi8(lut_hi, hi_nibbles);
+                __m128i const lo = _mm_shuffle_epi8(lut_lo, lo_nibbles);
+                if(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_and_si128(lo, hi), _mm_setzero_si128())) != 0) {
+                    return false;
+                }
+
+                __m128i const eq_2f = _mm_cmpeq_epi8(input, mask_2f);
+                __m128i const roll = _mm_shuffle_epi8(lut_roll, _mm_add_epi8(eq_2f, hi_nibbles));
+                __m128i const values = _mm_add_epi8(input, roll);
+
+                __m128i const merged = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+                __m128i const packed = _mm_madd_epi16(merged, _mm_set1_epi32(0x00011000));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + out), _mm_shuffle_epi8(packed, pack_shuffle));
+            }
+            return true;
+        }
+
+        KT_TARGET("avx2")
+        auto decode_base64_avx2(char const* src, std::size_t length, std::uint8_t* dst, std::size_t& in, std::size_t& out) -> bool {
+            __m256i const lut_lo = _mm256_setr_epi8(
+                0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A,
+                0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+            __m256i const lut_hi = _mm256_setr_epi8(
+                0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+                0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+            __m256i const lut_roll = _mm256_setr_epi8(
+                0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0,
+                0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+            __m256i const mask_2f = _mm256_set1_epi8(0x2F);
+            __m256i const pack_shuffle = _mm256_setr_epi8(
+                2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+            __m256i const pack_lanes = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, -1, -1);
+
+            for(; in + 32 <= length; in += 32, out += 24) {
+                __m256i const input = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(src + in));
+                __m256i const hi_nibbles = _mm256_and_si256(_mm256_srli_epi32(input, 4), mask_2f);
+                __m256i const lo_nibbles = _mm256_and_si256(input, mask_2f);
+                __m256i const hi = _mm256_shuffle_epi8(lut_hi, hi_nibbles);
+                __m256i const lo = _mm256_shuffle_epi8(lut_lo, lo_nibbles);
+                if(!_mm256_testz_si256(lo, hi)) {
+                    return false;
+                }
+
+                __m256i const eq_2f = _mm256_cmpeq_epi8(input, mask_2f);
+                __m256i const roll = _mm256_shuffle_epi8(lut_roll, _mm256_add_epi8(eq_2f, hi_nibbles));
+                __m256i const values = _mm256_add_epi8(input, roll);
+
+                __m256i const merged = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+                __m256i const packed = _mm256_madd_epi16(merged, _mm256_set1_epi32(0x00011000));
+                __m256i const shuffled = _mm256_shuffle_epi8(packed, pack_shuffle);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + out), _mm256_permutevar8x32_epi32(shuffled, pack_lanes));
+            }
+            return true;
+        }
+
+        enum class simd_level { scalar, ssse3, avx2 };
+
+        auto detect_simd_level() -> simd_level {
+#if defined(_MSC_VER) && !defined(__clang__)
+            int info[4];
+            __cpuid(info, 0);
+            int const max_leaf = info[0];
+            __cpuid(info, 1);
+            bool const ssse3 = (info[2] & (1 << 9)) != 0;
+            bool const os_saves_avx = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0 && (_xgetbv(0) & 6) == 6;
+            bool avx2 = false;
+            if(max_leaf >= 7 && os_saves_avx) {
+                __cpuidex(info, 7, 0);
+                avx2 = (info[1] & (1 << 5)) != 0;
+            }
+#else
+            __builtin_cpu_init();
+            bool const ssse3 = __builtin_cpu_supports("ssse3");
+            bool const avx2 = __builtin_cpu_supports("avx2");
+#endif
+            if(avx2) {
+                return simd_level::avx2;
+            } else if(ssse3) {
+                return simd_level::ssse3;
+            } else {
+                return simd_level::scalar;
+            }
+        }
+#endif
+
+        // Room for the vectorized stores past the end of the decoded bytes
+        constexpr std::size_t decode_slack = 32;
+
+        auto invalid_size(std::size_t tile_count) {
+            return invalid_argument(fmt::format("Chunk 'data' did not decode to {} tiles", tile_count));
+        }
+
+        // Decompresses a zlib (window_bits 15) or gzip (window_bits 31) stream into exactly 'size' bytes
+        auto inflate_exact(std::uint8_t const* source, std::size_t source_size, int window_bits, std::uint8_t* destination, std::size_t size, std::size_t tile_count)
+            -> tl::expected<void, error> {
+            if(source_size > UINT_MAX || size > UINT_MAX) {
+                return invalid_size(tile_count);
+            }
+
+            z_stream stream{};
+            if(inflateInit2(&stream, window_bits) != Z_OK) {
+                return invalid_argument("Could not initialize zlib");
+            }
+
+            stream.next_in = const_cast<Bytef*>(source);
+            stream.avail_in = static_cast<uInt>(source_size);
+            stream.next_out = destination;
+            stream.avail_out = static_cast<uInt>(size);
+            int const result = inflate(&stream, Z_FINISH);
+            bool const filled = stream.avail_out == 0;
+            inflateEnd(&stream);
+
+            if(result == Z_STREAM_END) {
+                if(!filled) {
+                    return invalid_size(tile_count);
+                }
+                return {};
+            } else if(result == Z_BUF_ERROR && filled) {
+                return invalid_size(tile_count);
+            } else {
+                return invalid_argument(fmt::format("Chunk 'data' was not a valid {} stream", window_bits > 15 ? "gzip" : "zlib"));
+            }
+        }
+
+        auto decompress_zstd(std::uint8_t const* source, std::size_t source_size, std::uint8_t* destination, std::size_t size, std::size_t tile_count)
+            -> tl::expected<void, error> {
+#if defined(KT_ENABLE_ZSTD)
+            std::size_t const result = ZSTD_decompress(destination, size, source, source_size);
+            if(ZSTD_isError(result)) {
+                if(ZSTD_getErrorCode(result) == ZSTD_error_dstSize_tooSmall) {
+                    return invalid_size(tile_count);
+                }
+                return invalid_argument(fmt::format("Chunk 'data' was not a valid zstd stream: {}", ZSTD_getErrorName(result)));
+            }
+            if(result != size) {
+                return invalid_size(tile_count);
+            }
+            return {};
+#else
+            (void)source; (void)source_size; (void)destination; (void)size; (void)tile_count;
+            return invalid_argument("zstd compressed maps are not supported by this build");
+#endif
+        }
+    }
+
+    auto decode_base64(std::string_view text, std::vector<std::uint8_t>& output) -> bool {
+        std::size_t length = text.size();
+        for(int padding = 0; padding < 2 && length > 0 && text[length - 1] == '='; ++padding) {
+            --length;
+        }
+
+        output.resize(length / 4 * 3 + 3 + decode_slack);
+        std::size_t in = 0, out = 0;
+
+#if defined(KT_BASE64_X86)
+        static simd_level const level = detect_simd_level();
+        if(level == simd_level::avx2 && !decode_base64_avx2(text.data(), length, output.data(), in, out)) {
+            return false;
+        }
+        if(level != simd_level::scalar && !decode_base64_ssse3(text.data(), length, output.data(), in, out)) {
+            return false;
+        }
+#endif
+        if(!decode_base64_scalar(text.data(), length, output.data(), in, out)) {
+            return false;
+        }
+
+        output.resize(out);
+        return true;
+    }
+
+    auto decode_tile_data(std::string_view data, tile_compression compression, std::size_t tile_count, game::tile* tiles)
+        -> tl::expected<void, error> {
+        static_assert(sizeof(game::tile) == sizeof(std::uint32_t), "Tiles are decoded in place from 32 bits ids");
+
+        // Reused between chunks, so that decoding a layer does not allocate for every chunk
+        thread_local std::vector<std::uint8_t> decoded;
+        if(!decode_base64(data, decoded)) {
+            return invalid_argument("Chunk 'data' was not a valid base64 string");
+        }
+
+        std::size_t const size = tile_count * sizeof(std::uint32_t);
+        auto* const tile_bytes = reinterpret_cast<std::uint8_t*>(tiles);
+
+        // Ids are little-endian, which is already the tile layout on little-endian hosts: the bytes go straight into the tiles
+        switch(compression) {
+        case tile_compression::none:
+            if(decoded.size() != size) {
+                return invalid_size(tile_count);
+            }
+            std::memcpy(tile_bytes, decoded.data(), size);
+            break;
+        case tile_compression::zlib:
+            if(auto const result = inflate_exact(decoded.data(), decoded.size(), 15, tile_bytes, size, tile_count); !result) {
+                return result;
+            }
+            break;
+        case tile_compression::gzip:
+            if(auto const result = inflate_exact(decoded.data(), decoded.size(), 15 + 16, tile_bytes, size, tile_count); !result) {
+                return result;
+            }
+            break;
+        case tile_compression::zstd:
+            if(auto const result = decompress_zstd(decoded.data(), decoded.size(), tile_bytes, size, tile_count); !result) {
+                return result;
+            }
+            break;
+        }
+
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+        for(std::size_t i = 0; i < tile_count; ++i) {
+            tiles[i].data = static_cast<game::tile::id>(SDL_SwapLE32(static_cast<std::uint32_t>(tiles[i].data)));
+        }
+#endif
+        return {};
+    }
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "game/tile.h"
+
+#include "serial/error.h"
+
+#include <tl/expected.hpp>
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// Decoding of Tiled's encoded tile layer data
+namespace serial::detail {
+    enum class tile_compression { none, zlib, gzip, zstd };
+
+    // How the 'data' field of the chunks of a tile layer is stored
+    struct tile_encoding {
+        // 'data' is either an array of tile ids, or a base64 string of little-endian 32 bits tile ids
+        bool base64 = false;
+        tile_compression compression = tile_compression::none;
+    };
+
+    // Decodes base64 text into 'output', replacing its content. Returns false if the text is not valid base64
+    auto decode_base64(std::string_view text, std::vector<std::uint8_t>& output) -> bool;
+
+    // Decodes the base64 'data' string of a chunk into exactly 'tile_count' tiles from 'tiles'. Flip flags are kept in the tiles
+    auto decode_tile_data(std::string_view data, tile_compression compression, std::size_t tile_count, game::tile* tiles)
+        -> tl::expected<void, error>;
+}
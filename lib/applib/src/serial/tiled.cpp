@@ -1,9 +1,20 @@
 #include "serial/tiled.h"
+#include "serial/tiled_parse.h"
+#include "sys/thread_pool.h"
 
 #include <fmt/format.h>
 #include <nlohmann/json.hpp>
 
+#include <algorithm>
+#include <array>
+#include <exception>
 #include <fstream>
+#include <iterator>
+#include <future>
+#include <memory>
+#include <memory_resource>
+#include <cstdint>
+#include <optional>
 #include <string>
 #include <cctype>
 
@@ -14,9 +25,20 @@ using namespace std::string_literals;
 
 namespace serial {
     namespace {
-        template<typename StringT>
-        auto invalid_argument(StringT&& str) {
-            return tl::make_unexpected(error{std::make_error_code(std::errc::invalid_argument), std::forward<StringT>(str)});
+        using detail::invalid_argument;
+
+        // Appends the elements of a JSON array to 'output', which picks the allocator. The results are moved in
+        template<typename Container, typename F>
+        auto parse_range_into(nlohmann::json const& array, Container& output, F f) -> tl::expected<void, error> {
+            output.reserve(output.size() + array.size());
+            for(auto const& element : array) {
+                auto parse_result = f(element);
+                if(!parse_result) {
+                    return tl::make_unexpected(parse_result.error());
+                }
+                output.push_back(*std::move(parse_result));
+            }
+            return {};
         }
 
         // Utility function to collapse all the intermediary "errors" of a JSON array into a single structure 
@@ -26,15 +48,9 @@ namespace serial {
             using result_type = typename decltype(f(*array.begin()))::value_type;
 
             std::vector<result_type> output;
-            for(auto const& element : array) {
-                auto const parse_result = f(element);
-                if(!parse_result) {
-                    return tl::make_unexpected(parse_result.error());
-                } else {
-                    output.push_back(*std::move(parse_result));
-                }
+            if(auto const parsed = parse_range_into(array, output, f); !parsed) {
+                return tl::make_unexpected(parsed.error());
             }
-            
             return output;
         }
         
@@ -49,6 +65,94 @@ namespace serial {
             return parse_range(*field, f);
         }
 
+        // Parallel counterpart of parse_range: the elements are converted by batches on the pool threads as soon as it is built.
+        // Results keep the element order, and the error returned is the one of the first invalid element
+        template<typename T>
+        class parallel_range {
+        public:
+            template<typename F>
+            parallel_range(nlohmann::json const& array, F f, sys::thread_pool& pool)
+                : slots(array.size()) {
+                std::size_t const min_batch_size = 8;
+                std::size_t const batch_size = std::max(min_batch_size, array.size() / (pool.get_thread_count() * 4) + 1);
+                for(std::size_t first = 0; first < array.size(); first += batch_size) {
+                    std::size_t const last = std::min(first + batch_size, array.size());
+                    batches.push_back(pool.submit([&array, f, slots = slots.data(), first, last] () -> std::optional<error> {
+                        for(std::size_t i = first; i < last; ++i) {
+                            auto result = f(array[i]);
+                            if(!result) {
+                                return result.error();
+                            }
+                            slots[i].emplace(*std::move(result));
+                        }
+                        return std::nullopt;
+                    }));
+                }
+            }
+
+            parallel_range(parallel_range const&) = delete;
+            parallel_range& operator=(parallel_range const&) = delete;
+
+            ~parallel_range() {
+                wait();
+            }
+
+            auto get() -> tl::expected<std::vector<T>, error> {
+                std::vector<T> output;
+                if(auto const converted = get_into(output); !converted) {
+                    return tl::make_unexpected(converted.error());
+                }
+                return output;
+            }
+
+            // Moves the results to the end of 'output', which picks the allocator
+            template<typename Container>
+            auto get_into(Container& output) -> tl::expected<void, error> {
+                // Every batch is waited on, even after an error, as they all read the document and write the output
+                std::optional<error> first_error;
+                std::exception_ptr first_exception;
+                for(auto& batch : batches) {
+                    try {
+                        auto batch_error = batch.get();
+                        if(batch_error && !first_error && !first_exception) {
+                            first_error = std::move(batch_error);
+                        }
+                    } catch(...) {
+                        if(!first_error && !first_exception) {
+                            first_exception = std::current_exception();
+                        }
+                    }
+                }
+                batches.clear();
+
+                if(first_exception) {
+                    std::rethrow_exception(first_exception);
+                } else if(first_error) {
+                    return tl::make_unexpected(*std::move(first_error));
+                }
+
+                output.reserve(output.size() + slots.size());
+                for(std::optional<T>& slot : slots) {
+                    output.push_back(*std::move(slot));
+                }
+                slots.clear();
+                return {};
+            }
+
+        private:
+            // Constructed from the results rather than assigned to, so that the results keep their allocator
+            std::vector<std::optional<T>> slots;
+            std::vector<std::future<std::optional<error>>> batches;
+
+            void wait() noexcept {
+                for(auto& batch : batches) {
+                    if(batch.valid()) {
+                        batch.wait();
+                    }
+                }
+            }
+        };
+
         auto parse_integer(nlohmann::json const& json, std::string_view field) -> tl::expected<int, error> {
             auto const field_value = json.find(field);
         	if(field_value == json.end()) {
@@ -120,25 +224,37 @@ namespace serial {
         	return static_cast<std::string>(*field_value);
         }
 
-    	template<typename String>
-        auto parse_string_default(nlohmann::json const& json, std::string_view field, String&& default_value) -> std::string {
+        // A view of the string in the JSON value, so that it is only copied to where it is stored
+        auto parse_string_default(nlohmann::json const& json, std::string_view field, std::string_view default_value) -> std::string_view {
             auto const field_value = json.find(field);
             if (field_value == json.end() || !field_value->is_string()) {
-                return std::string(std::forward<String>(default_value));
+                return default_value;
             }
-            return static_cast<std::string>(*field_value);
+            return field_value->get_ref<std::string const&>();
         }
-    	
-        auto parse_tile_chunk(nlohmann::json const& chunk) -> tl::expected<game::tile_chunk, error> {
+
+        // Of the 'tilewidth' and 'tileheight' fields of a map or a tileset. Tiles of any size are drawn at game::tile::dimensions
+        auto parse_tile_dimensions(nlohmann::json const& json, std::string_view what) -> tl::expected<math::vector2i, error> {
+            int const max_side = 4096;
+            auto const width = json.find("tilewidth");
+            auto const height = json.find("tileheight");
+            if(width == json.end() || !width->is_number_integer() || *width <= 0 || *width > max_side
+               || height == json.end() || !height->is_number_integer() || *height <= 0 || *height > max_side) {
+                return invalid_argument(fmt::format("{} had invalid 'tilewidth' or 'tileheight', expected from 1 to {} pixels", what, max_side));
+            }
+            return math::vector2i{static_cast<int>(*width), static_cast<int>(*height)};
+        }
+    }
+
+    namespace detail {
+        auto parse_tile_chunk_header(nlohmann::json const& chunk) -> tl::expected<game::tile_rect, error> {
+            // Tiled chunks may have any size, they are spread over the chunks they overlap
+            int const max_side = 4096;
             auto const width = chunk.find("width");
             auto const height = chunk.find("height");
-            if(width == chunk.end() || *width != game::tile_chunk::dimensions.x 
-               || height == chunk.end() || *height != game::tile_chunk::dimensions.y) {
-                return invalid_argument(
-                    fmt::format("Chunk had invalid dimensions, expected ({},{})", 
-                                game::tile_chunk::dimensions.x, game::tile_chunk::dimensions.y
-                    )
-                );
+            if(width == chunk.end() || !width->is_number_integer() || *width <= 0 || *width > max_side
+               || height == chunk.end() || !height->is_number_integer() || *height <= 0 || *height > max_side) {
+                return invalid_argument(fmt::format("Chunk had invalid dimensions, expected from 1 to {} tiles", max_side));
             }
 
             auto const x = chunk.find("x");
@@ -147,30 +263,128 @@ namespace serial {
                 return invalid_argument("Chunk had invalid 'x' and 'y' fields");
             }
 
-            auto const tiles = chunk.find("data");
-            if(tiles == chunk.end() || !tiles->is_array()) {
-                return invalid_argument("Chunk had invalid 'data' field");
+            return game::tile_rect{math::vector2i{*x, *y}, math::vector2i{*width, *height}};
+        }
+
+        auto parse_tile_encoding(nlohmann::json const& layer) -> tl::expected<tile_encoding, error> {
+            tile_encoding result;
+
+            auto const encoding = layer.find("encoding");
+            if(encoding != layer.end()) {
+                if(!encoding->is_string()) {
+                    return invalid_argument("Layer had invalid 'encoding' field");
+                }
+                if(*encoding == "base64") {
+                    result.base64 = true;
+                } else if(*encoding != "csv") {
+                    return invalid_argument(fmt::format("Layer encoding '{}' invalid or not supported.", encoding->get<std::string>()));
+                }
+            }
+
+            // Compression only applies to base64 data
+            auto const compression = layer.find("compression");
+            if(result.base64 && compression != layer.end()) {
+                if(!compression->is_string()) {
+                    return invalid_argument("Layer had invalid 'compression' field");
+                }
+                if(*compression == "") {
+                    result.compression = tile_compression::none;
+                } else if(*compression == "zlib") {
+                    result.compression = tile_compression::zlib;
+                } else if(*compression == "gzip") {
+                    result.compression = tile_compression::gzip;
+                } else if(*compression == "zstd") {
+                    result.compression = tile_compression::zstd;
+                } else {
+                    return invalid_argument(fmt::format("Layer compression '{}' invalid or not supported.", compression->get<std::string>()));
+                }
+            }
+
+            return result;
+        }
+
+        auto parse_tile_chunk(nlohmann::json const& chunk, tile_encoding encoding) -> tl::expected<std::vector<game::packed_chunk>, error> {
+            auto const region = parse_tile_chunk_header(chunk);
+            if(!region) {
+                return tl::make_unexpected(region.error());
+            }
+
+            // Tiled chunks of the size of a tile_chunk are decoded on the stack
+            std::size_t const tile_count = static_cast<std::size_t>(region->size.x) * static_cast<std::size_t>(region->size.y);
+            std::array<game::tile, game::tile_chunk::tile_count> chunk_tiles;
+            std::vector<game::tile> region_tiles;
+            game::tile* tiles = chunk_tiles.data();
+            if(tile_count > chunk_tiles.size()) {
+                region_tiles.resize(tile_count);
+                tiles = region_tiles.data();
             }
 
-            game::tile_chunk result{*x, *y};
-            result.tiles.reserve(tiles->size());
-            for(auto const& tile : *tiles) {
-                if(!tile.is_number_unsigned()) {
-                    return invalid_argument("A tile was not a positive integer");
+            auto const data = chunk.find("data");
+            if(encoding.base64) {
+                if(data == chunk.end() || !data->is_string()) {
+                    return invalid_argument("Chunk had invalid 'data' field");
+                }
+
+                auto const decoded = decode_tile_data(data->get_ref<std::string const&>(), encoding.compression, tile_count, tiles);
+                if(!decoded) {
+                    return tl::make_unexpected(decoded.error());
+                }
+            } else {
+                if(data == chunk.end() || !data->is_array()) {
+                    return invalid_argument("Chunk had invalid 'data' field");
+                }
+
+                if(data->size() != tile_count) {
+                    return invalid_argument(fmt::format("Chunk 'data' did not have {} tiles", tile_count));
+                }
+
+                for(std::size_t i = 0; i < tile_count; ++i) {
+                    auto const& tile = (*data)[i];
+                    // Global ids take 32 bits with their flip flags
+                    if(!tile.is_number_unsigned() || tile.get<std::uint64_t>() > UINT32_MAX) {
+                        return invalid_argument("A tile was not a positive integer");
+                    }
+                    tiles[i] = game::tile{static_cast<game::tile::id>(tile.get<std::uint32_t>())};
                 }
-                result.tiles.push_back(game::tile{tile});
             }
 
+            std::vector<game::packed_chunk> chunks;
+            game::pack_region(*region, tiles, chunks);
+            return chunks;
+        }
+
+        auto join_chunks(std::vector<std::vector<game::packed_chunk>> tiled_chunks) -> std::vector<game::packed_chunk> {
+            std::size_t chunk_count = 0;
+            for(auto const& chunks : tiled_chunks) {
+                chunk_count += chunks.size();
+            }
+
+            std::vector<game::packed_chunk> result;
+            result.reserve(chunk_count);
+            for(auto& chunks : tiled_chunks) {
+                std::move(chunks.begin(), chunks.end(), std::back_inserter(result));
+            }
             return result;
         }
+    }
 
+    namespace {
         auto parse_tile_layer_data(nlohmann::json const& tile_layer) -> tl::expected<game::layer::tile_data, error> {
-            auto chunks_result = parse_range(tile_layer, "chunks", parse_tile_chunk);
+            auto const encoding = detail::parse_tile_encoding(tile_layer);
+            if(!encoding) {
+                return tl::make_unexpected(encoding.error());
+            }
+
+            auto chunks_result = parse_range(tile_layer, "chunks", [encoding = *encoding] (nlohmann::json const& chunk) {
+                return detail::parse_tile_chunk(chunk, encoding);
+            });
             if (!chunks_result) {
                 return tl::make_unexpected(chunks_result.error());
             }
 
-            return game::layer::tile_data{ *std::move(chunks_result) };
+            auto chunks = detail::join_chunks(*std::move(chunks_result));
+            game::erase_empty_chunks(chunks);
+            return game::layer::tile_data{ std::move(chunks) };
         }
 
     	// parses a #RRGGBB or #AARRGGBB color string into a RGBA32 structure
@@ -197,12 +411,12 @@ namespace serial {
         }
 
     	// Default values derived from: https://doc.mapeditor.org/en/stable/reference/json-map-format/#text
-        auto parse_object_text_data(nlohmann::json const& text_field) -> tl::expected<game::text_data, error> {
-            game::text_data data;
+        auto parse_object_text_data(nlohmann::json const& text_field, std::pmr::memory_resource* memory, game::string_pool& strings) -> tl::expected<game::text_data, error> {
+            game::text_data data(memory);
             data.text = parse_string_default(text_field, "text", "");
 
             {
-                std::string const color_hex = parse_string_default(text_field, "color", "#000000");
+                std::string_view const color_hex = parse_string_default(text_field, "color", "#000000");
                 auto const color_result = parse_color(color_hex);
                 if (!color_result) {
                     return tl::make_unexpected(color_result.error());
@@ -210,11 +424,11 @@ namespace serial {
                 data.color = *color_result;
             }
         	
-            data.font = parse_string_default(text_field, "fontfamily", "sans-serif");
+            data.font = strings.intern(parse_string_default(text_field, "fontfamily", "sans-serif"));
             data.point_size = parse_integer_default(text_field, "pixelsize", 16);
 
             {
-                std::string const valign_string = parse_string_default(text_field, "valign", "top");
+                std::string_view const valign_string = parse_string_default(text_field, "valign", "top");
                 if (valign_string == "center") {
                     data.valign = game::text_data::vertical_alignment::center;
                 } else if (valign_string == "bottom") {
@@ -225,7 +439,7 @@ namespace serial {
             }
 
             {
-                std::string const halign_string = parse_string_default(text_field, "halign", "left");
+                std::string_view const halign_string = parse_string_default(text_field, "halign", "left");
                 if (halign_string == "center") {
                     data.halign = game::text_data::horizontal_alignment::center;
                 } else if (halign_string == "right") {
@@ -247,7 +461,10 @@ namespace serial {
             return data;
         }
     	
-    	auto parse_object(nlohmann::json const& json) -> tl::expected<game::object, error> {
+    }
+
+    namespace detail {
+    	auto parse_object(nlohmann::json const& json, std::pmr::memory_resource* memory, game::string_pool& strings) -> tl::expected<game::object, error> {
             game::object object;
 
             auto const id_result = parse_integer(json, "id");
@@ -256,8 +473,8 @@ namespace serial {
             }
             object.id = static_cast<game::object::identifier>(*id_result);
         
-            object.name = parse_string_default(json, "name", "");
-            object.type = parse_string_default(json, "type", "");
+            object.name = strings.intern(parse_string_default(json, "name", ""));
+            object.type = strings.intern(parse_string_default(json, "type", ""));
 
             object.dimensions.x = static_cast<int>(parse_float_default(json, "width", 0.0));
             object.dimensions.y = static_cast<int>(parse_float_default(json, "height", 0.0));
@@ -268,7 +485,7 @@ namespace serial {
         	if(auto const point_field = json.find("point"); point_field != json.end() && *point_field == true) {
                 object.kind_data = game::point_data();
             } else if (auto const text_field = json.find("text"); text_field != json.end() && text_field->is_structured()) {
-                auto text_result = parse_object_text_data(*text_field);
+                auto text_result = parse_object_text_data(*text_field, memory, strings);
                 if (!text_result) {
                     return tl::make_unexpected(text_result.error());
                 }
@@ -279,17 +496,28 @@ namespace serial {
             }
             return object;
     	}
+    }
 
-        auto parse_object_layer_data(nlohmann::json const& object_layer) -> tl::expected<game::layer::object_data, error> {
-            auto objects_result = parse_range(object_layer, "objects", parse_object);
-            if (!objects_result) {
-                return tl::make_unexpected(objects_result.error());
+    namespace {
+        auto parse_object_layer_data(nlohmann::json const& object_layer, std::pmr::memory_resource* memory, game::string_pool& strings) -> tl::expected<game::layer::object_data, error> {
+            auto const objects = object_layer.find("objects");
+            if(objects == object_layer.end() || !objects->is_array()) {
+                return invalid_argument("Expected 'objects' array field");
             }
 
-            return game::layer::object_data{ *std::move(objects_result) };
+            game::layer::object_data data(memory);
+            auto const parsed = parse_range_into(*objects, data, [memory, &strings] (nlohmann::json const& object) {
+                return detail::parse_object(object, memory, strings);
+            });
+            if (!parsed) {
+                return tl::make_unexpected(parsed.error());
+            }
+            return data;
         }
-    	
-        auto parse_layer(nlohmann::json const& layer) -> tl::expected<game::layer, error> {
+    }
+
+    namespace detail {
+        auto parse_layer_header(nlohmann::json const& layer) -> tl::expected<game::layer, error> {
             if(!layer.is_object()) {
                 return invalid_argument("Layer not a valid Layer object");
             }
@@ -304,32 +532,44 @@ namespace serial {
                 return invalid_argument("Layer had invalid id");
             }
 
+            if(*type != tile_layer_type && *type != object_layer_type) {
+                return invalid_argument(fmt::format("Layer type '{}' invalid or not supported.", *type));
+            }
+
             game::layer ret;
-            ret.id = *id;           
+            ret.id = *id;
+            return ret;
+        }
+
+        auto parse_layer(nlohmann::json const& layer, std::pmr::memory_resource* memory, game::string_pool& strings) -> tl::expected<game::layer, error> {
+            auto header = parse_layer_header(layer);
+            if(!header) {
+                return header;
+            }
+
+            game::layer ret = *std::move(header);
 
         	// Handle type-specific data
-            if (*type == "tilelayer") {
+            if (*layer.find("type") == tile_layer_type) {
                 auto tile_data = parse_tile_layer_data(layer);
             	if(!tile_data) {
                     return tl::make_unexpected(tile_data.error());
             	}
 
-                ret.data = *tile_data;
-            } else if (*type == "objectgroup") {
-                auto object_data = parse_object_layer_data(layer);
+                ret.data = *std::move(tile_data);
+            } else {
+                auto object_data = parse_object_layer_data(layer, memory, strings);
                 if (!object_data) {
                     return tl::make_unexpected(object_data.error());
                 }
 
-                ret.data = *object_data;
-            } else {
-                return invalid_argument(fmt::format("Layer type '{}' invalid or not supported.", *type));
+                ret.data = *std::move(object_data);
             }
 
             return ret;
         }
 
-        auto sanitize_map(nlohmann::json const& json) -> tl::expected<nlohmann::json, error> {
+        auto sanitize_map(nlohmann::json const& json) -> tl::expected<math::vector2i, error> {
             auto const version = json.find("tiledversion");
             if(version == json.end()) {
                 return invalid_argument("Not a Tiled map");
@@ -352,14 +592,9 @@ namespace serial {
                 return invalid_argument("Not an infinite map");
             }
 
-            if(auto const tilewidth = json.find("tilewidth"), tileheight = json.find("tileheight");
-                 tilewidth == json.end() || *tilewidth != game::tile::dimensions.x 
-               || tileheight == json.end() || *tileheight != game::tile::dimensions.y) {
-                return invalid_argument(
-                    fmt::format("Invalid 'tilewidth' or 'tileheight': expected ({}, {})", 
-                                game::tile::dimensions.x, 
-                                game::tile::dimensions.y)
-                );
+            auto const tile_dimensions = parse_tile_dimensions(json, "Map");
+            if(!tile_dimensions) {
+                return tile_dimensions;
             }
 
             if(auto const renderorder = json.find("renderorder");
@@ -367,7 +602,7 @@ namespace serial {
                 return invalid_argument("Expected 'right-down' in the 'renderorder' field");
             }
 
-            return json;
+            return tile_dimensions;
         }
 
         auto parse_tileset(nlohmann::json const& tileset) -> tl::expected<game::tileset, error> {
@@ -385,51 +620,178 @@ namespace serial {
         }
 
         auto parse_map(nlohmann::json const& json) -> tl::expected<game::map, error> {
-            return sanitize_map(json).and_then([] (nlohmann::json const& map) -> tl::expected<game::map, error> {
-                auto layers_result = parse_range(map, "layers", parse_layer);
-                if(!layers_result) {
-                    return tl::make_unexpected(layers_result.error());
+            auto const tile_dimensions = sanitize_map(json);
+            if(!tile_dimensions) {
+                return tl::make_unexpected(tile_dimensions.error());
+            }
+
+            game::map map;
+            map.tile_dimensions = *tile_dimensions;
+            auto layers_result = parse_range(json, "layers", [memory = map.arena.get(), &strings = map.strings] (nlohmann::json const& layer) {
+                return parse_layer(layer, memory, strings);
+            });
+            if(!layers_result) {
+                return tl::make_unexpected(layers_result.error());
+            }
+
+            auto tilesets_result = parse_range(json, "tilesets", parse_tileset);
+            if(!tilesets_result) {
+                return tl::make_unexpected(tilesets_result.error());
+            }
+
+            map.layers = *std::move(layers_result);
+            map.tilesets = *std::move(tilesets_result);
+            game::share_identical_chunks(map);
+            return map;
+        }
+    }
+
+    namespace {
+        auto expected_array_field(std::string_view field_name) -> error {
+            return {std::make_error_code(std::errc::invalid_argument), fmt::format("Expected '{}' array field", field_name)};
+        }
+
+        // Layer whose chunks or objects are being converted on the pool threads
+        struct pending_layer {
+            game::layer layer;
+            std::unique_ptr<parallel_range<std::vector<game::packed_chunk>>> chunks;
+            std::unique_ptr<parallel_range<game::object>> objects;
+        };
+
+        // Same steps as detail::parse_map, with the layer data converted in parallel. Layer headers are checked in order on the
+        // calling thread, so that the parallel work never goes past the first invalid layer
+        auto parse_map_parallel(nlohmann::json const& json, sys::thread_pool& pool) -> tl::expected<game::map, error> {
+            auto const tile_dimensions = detail::sanitize_map(json);
+            if(!tile_dimensions) {
+                return tl::make_unexpected(tile_dimensions.error());
+            }
+
+            game::map map;
+            map.tile_dimensions = *tile_dimensions;
+            std::pmr::memory_resource* const memory = map.arena.get();
+
+            auto const layers_field = json.find("layers");
+            if(layers_field == json.end() || !layers_field->is_array()) {
+                return tl::make_unexpected(expected_array_field("layers"));
+            }
+
+            std::vector<pending_layer> pending;
+            pending.reserve(layers_field->size());
+            std::optional<error> header_error;
+            for(auto const& layer : *layers_field) {
+                auto header = detail::parse_layer_header(layer);
+                if(!header) {
+                    header_error = header.error();
+                    break;
                 }
 
-                auto tilesets_result = parse_range(map, "tilesets", parse_tileset);
-                if(!tilesets_result) {
-                    return tl::make_unexpected(tilesets_result.error());
+                pending_layer next{*std::move(header), nullptr, nullptr};
+                if(*layer.find("type") == detail::tile_layer_type) {
+                    auto const encoding = detail::parse_tile_encoding(layer);
+                    if(!encoding) {
+                        header_error = encoding.error();
+                        break;
+                    }
+
+                    auto const chunks = layer.find("chunks");
+                    if(chunks == layer.end() || !chunks->is_array()) {
+                        header_error = expected_array_field("chunks");
+                        break;
+                    }
+
+                    next.chunks = std::make_unique<parallel_range<std::vector<game::packed_chunk>>>(*chunks, [encoding = *encoding] (nlohmann::json const& chunk) {
+                        return detail::parse_tile_chunk(chunk, encoding);
+                    }, pool);
+                } else {
+                    auto const objects = layer.find("objects");
+                    if(objects == layer.end() || !objects->is_array()) {
+                        header_error = expected_array_field("objects");
+                        break;
+                    }
+
+                    next.objects = std::make_unique<parallel_range<game::object>>(*objects, [memory, &strings = map.strings] (nlohmann::json const& object) {
+                        return detail::parse_object(object, memory, strings);
+                    }, pool);
                 }
+                pending.push_back(std::move(next));
+            }
+
+            // Errors in the data of a layer come before the header errors of the layers after it
+            map.layers.reserve(pending.size());
+            std::optional<error> data_error;
+            for(pending_layer& p : pending) {
+                if(p.chunks) {
+                    auto chunks = p.chunks->get();
+                    if(!chunks) {
+                        if(!data_error) {
+                            data_error = chunks.error();
+                        }
+                    } else {
+                        auto layer_chunks = detail::join_chunks(*std::move(chunks));
+                        game::erase_empty_chunks(layer_chunks);
+                        p.layer.data = game::layer::tile_data{std::move(layer_chunks)};
+                    }
+                } else {
+                    game::layer::object_data objects(memory);
+                    if(auto const converted = p.objects->get_into(objects); !converted) {
+                        if(!data_error) {
+                            data_error = converted.error();
+                        }
+                    } else {
+                        p.layer.data.emplace<game::layer::object_data>(std::move(objects));
+                    }
+                }
+                map.layers.push_back(std::move(p.layer));
+            }
 
-               return game::map{*std::move(layers_result), *std::move(tilesets_result)};
-            });
+            if(data_error) {
+                return tl::make_unexpected(*data_error);
+            } else if(header_error) {
+                return tl::make_unexpected(*header_error);
+            }
+
+            auto tilesets_result = parse_range(json, "tilesets", detail::parse_tileset);
+            if(!tilesets_result) {
+                return tl::make_unexpected(tilesets_result.error());
+            }
+
+            map.tilesets = *std::move(tilesets_result);
+            game::share_identical_chunks(map);
+            return map;
         }
     }
 
-    auto load_tiled_json(std::istream& map_data) -> tl::expected<game::map, error> {
+    auto load_tiled_json_document(std::istream& map_data) -> tl::expected<game::map, error> {
         auto const json = nlohmann::json::parse(map_data, nullptr, false);
         if(json.is_discarded()) {
             return invalid_argument("Input stream was not a valid JSON");
         }
 
-        return parse_map(json).map_error([] (error e) -> error {
+        return detail::parse_map(json).map_error([] (error e) -> error {
             return {e.code, "Map parse error: " + e.description};
         });
     }
 
-    namespace {
+    auto load_tiled_json_parallel(std::istream& map_data, sys::thread_pool& pool) -> tl::expected<game::map, error> {
+        auto const json = nlohmann::json::parse(map_data, nullptr, false);
+        if(json.is_discarded()) {
+            return invalid_argument("Input stream was not a valid JSON");
+        }
 
+        return parse_map_parallel(json, pool).map_error([] (error e) -> error {
+            return {e.code, "Map parse error: " + e.description};
+        });
     }
 
-    auto get_tiled_tileset_image(std::istream& tileset_data) -> tl::expected<std::string, error> {
+    auto get_tiled_tileset_info(std::istream& tileset_data) -> tl::expected<tiled_tileset_info, error> {
         auto const json = nlohmann::json::parse(tileset_data, nullptr, false);
         if(json.is_discarded()) {
             return invalid_argument("Input stream was not a valid JSON");
         }
 
-        auto const width = json.find("tilewidth");
-        if(width == json.end() || *width != game::tile::dimensions.x) {
-            return invalid_argument(fmt::format("Tileset had invalid tile width: expected {}", game::tile::dimensions.x));
-        }
-
-        auto const height = json.find("tileheight");
-        if(height == json.end() || *height != game::tile::dimensions.y) {
-            return invalid_argument(fmt::format("Tileset had invalid tile height: expected {}", game::tile::dimensions.y));
+        auto const tile_dimensions = parse_tile_dimensions(json, "Tileset");
+        if(!tile_dimensions) {
+            return tl::make_unexpected(tile_dimensions.error());
         }
 
         auto const image = json.find("image");
@@ -437,6 +799,19 @@ namespace serial {
             return invalid_argument("Invalid 'image' field");
         }
 
-        return image->get<std::string>();
+        auto const tile_count = parse_integer(json, "tilecount");
+        if(!tile_count) {
+            return tl::make_unexpected(tile_count.error());
+        }
+        auto const columns = parse_integer(json, "columns");
+        if(!columns) {
+            return tl::make_unexpected(columns.error());
+        }
+
+        return tiled_tileset_info{image->get<std::string>(), *tile_dimensions, *tile_count, *columns};
+    }
+
+    auto get_tiled_tileset_image(std::istream& tileset_data) -> tl::expected<std::string, error> {
+        return get_tiled_tileset_info(tileset_data).map([] (tiled_tileset_info&& info) { return std::move(info.image); });
     }
 }
\ No newline at end of file
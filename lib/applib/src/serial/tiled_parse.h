@@ -0,0 +1,49 @@
+#pragma once
+
+#include "game/chunk_store.h"
+#include "game/map.h"
+
+#include "serial/error.h"
+#include "serial/tile_data.h"
+
+#include <nlohmann/json.hpp>
+#include <tl/expected.hpp>
+
+#include <memory_resource>
+#include <vector>
+
+// Tiled JSON parsing steps shared by the document and the streaming loaders
+namespace serial::detail {
+    template<typename StringT>
+    auto invalid_argument(StringT&& str) {
+        return tl::make_unexpected(error{std::make_error_code(std::errc::invalid_argument), std::forward<StringT>(str)});
+    }
+
+    // Validates the top-level fields of a Tiled map, and returns the dimensions of its tiles. Only scalar fields are looked at,
+    // 'layers' and 'tilesets' are not needed
+    auto sanitize_map(nlohmann::json const& json) -> tl::expected<math::vector2i, error>;
+
+    // Validates the 'width', 'height', 'x' and 'y' fields of a chunk, and returns the tiles it covers
+    auto parse_tile_chunk_header(nlohmann::json const& chunk) -> tl::expected<game::tile_rect, error>;
+
+    // Validates the 'type' and 'id' fields of a layer, and returns the layer without any data
+    auto parse_layer_header(nlohmann::json const& layer) -> tl::expected<game::layer, error>;
+
+    // Reads the 'encoding' and 'compression' fields of a tile layer
+    auto parse_tile_encoding(nlohmann::json const& layer) -> tl::expected<tile_encoding, error>;
+
+    // Packs the tiles as soon as they are read, so that a layer is never held unpacked. A Tiled chunk gives the chunks it
+    // overlaps, which may be shared with other Tiled chunks: game::layer::tile_data merges them
+    auto parse_tile_chunk(nlohmann::json const& chunk, tile_encoding encoding) -> tl::expected<std::vector<game::packed_chunk>, error>;
+    // Chunks of every Tiled chunk, in order
+    auto join_chunks(std::vector<std::vector<game::packed_chunk>> tiled_chunks) -> std::vector<game::packed_chunk>;
+    // Objects and their points are allocated from 'memory', the arena of the map being loaded, and their names, types and fonts
+    // interned in 'strings', the string pool of that map
+    auto parse_layer(nlohmann::json const& layer, std::pmr::memory_resource* memory, game::string_pool& strings) -> tl::expected<game::layer, error>;
+    auto parse_object(nlohmann::json const& json, std::pmr::memory_resource* memory, game::string_pool& strings) -> tl::expected<game::object, error>;
+    auto parse_tileset(nlohmann::json const& tileset) -> tl::expected<game::tileset, error>;
+    auto parse_map(nlohmann::json const& json) -> tl::expected<game::map, error>;
+
+    constexpr char const tile_layer_type[] = "tilelayer";
+    constexpr char const object_layer_type[] = "objectgroup";
+}
\ No newline at end of file
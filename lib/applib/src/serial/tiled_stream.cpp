@@ -0,0 +1,654 @@
+#include "serial/tiled.h"
+#include "serial/tiled_parse.h"
+
+#include <fmt/format.h>
+#include <nlohmann/json.hpp>
+
+#include <cstdint>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace serial {
+    namespace {
+        using detail::invalid_argument;
+
+        auto expected_array_field(std::string_view field_name) -> error {
+            return {std::make_error_code(std::errc::invalid_argument), fmt::format("Expected '{}' array field", field_name)};
+        }
+
+        auto invalid_chunk_data() -> error {
+            return {std::make_error_code(std::errc::invalid_argument), "Chunk had invalid 'data' field"};
+        }
+
+        auto get_tile_count(game::tile_rect region) noexcept -> std::size_t {
+            return static_cast<std::size_t>(region.size.x) * static_cast<std::size_t>(region.size.y);
+        }
+
+        // Builds a JSON value out of SAX events. Only used for the small parts of a map (scalar fields, objects, tilesets),
+        // which are then validated by the same parsing steps as the document loader
+        class json_fragment {
+        public:
+            // Starts a new fragment. A discarded fragment is only tracked until its end, without storing anything
+            void reset(bool discard) {
+                value = nullptr;
+                stack.clear();
+                discarding = discard;
+                depth = 0;
+                complete = false;
+            }
+
+            void add(nlohmann::json element) {
+                if(discarding) {
+                    complete = depth == 0;
+                } else if(stack.empty()) {
+                    value = std::move(element);
+                    complete = true;
+                } else {
+                    insert(std::move(element));
+                }
+            }
+
+            void open(nlohmann::json container) {
+                ++depth;
+                if(discarding) {
+                    return;
+                }
+
+                if(stack.empty()) {
+                    value = std::move(container);
+                    stack.push_back(&value);
+                } else {
+                    stack.push_back(&insert(std::move(container)));
+                }
+            }
+
+            void close() {
+                --depth;
+                if(!discarding) {
+                    stack.pop_back();
+                }
+                complete = depth == 0;
+            }
+
+            void set_key(std::string k) {
+                key = std::move(k);
+            }
+
+            [[nodiscard]] auto is_complete() const noexcept -> bool { return complete; }
+            [[nodiscard]] auto take() -> nlohmann::json { return std::move(value); }
+
+        private:
+            nlohmann::json value;
+            // Open containers. Elements of a container are never moved while it is open
+            std::vector<nlohmann::json*> stack;
+            std::string key;
+            int depth = 0;
+            bool discarding = false;
+            bool complete = false;
+
+            auto insert(nlohmann::json element) -> nlohmann::json& {
+                nlohmann::json& parent = *stack.back();
+                if(parent.is_array()) {
+                    parent.push_back(std::move(element));
+                    return parent.back();
+                } else {
+                    return parent[key] = std::move(element);
+                }
+            }
+        };
+
+        // SAX handler writing a map as its events come in. Tile data goes straight into the chunks of the current layer,
+        // and only the scalar fields of the map, layer and chunk being read are kept as JSON
+        class map_handler final : public nlohmann::json::json_sax_t {
+        public:
+            auto take_result() -> std::optional<tl::expected<game::map, error>> {
+                return std::move(result);
+            }
+
+            bool null() override { return on_scalar(nullptr); }
+            bool boolean(bool val) override { return on_scalar(val); }
+            bool number_integer(number_integer_t val) override { return on_scalar(val); }
+            bool number_unsigned(number_unsigned_t val) override {
+                if(!capturing && !frames.empty() && frames.back() == frame::chunk_data) {
+                    // Global ids take 32 bits with their flip flags
+                    if(val > UINT32_MAX) {
+                        add_invalid_tile();
+                    } else {
+                        chunk_tiles.push_back(game::tile{static_cast<game::tile::id>(val)});
+                        ++chunk_tile_count;
+                    }
+                    return true;
+                }
+                return on_scalar(val);
+            }
+            bool number_float(number_float_t val, string_t const&) override { return on_scalar(val); }
+            bool string(string_t& val) override { return on_scalar(std::move(val)); }
+
+            bool start_object(std::size_t) override {
+                if(capturing) {
+                    fragment.open(nlohmann::json::object());
+                    return true;
+                }
+
+                if(frames.empty()) {
+                    frames.push_back(frame::root);
+                    return true;
+                }
+
+                switch(frames.back()) {
+                case frame::layers:
+                    begin_layer();
+                    break;
+                case frame::chunks:
+                    begin_chunk();
+                    break;
+                case frame::objects:
+                case frame::tilesets:
+                    begin_capture(capture_target::element, nlohmann::json::object());
+                    break;
+                case frame::chunk_data:
+                    add_invalid_tile();
+                    begin_capture(capture_target::discard, nlohmann::json::object());
+                    break;
+                default:
+                    begin_capture(capture_target::field, nlohmann::json::object());
+                    break;
+                }
+                return true;
+            }
+
+            bool start_array(std::size_t) override {
+                if(capturing) {
+                    fragment.open(nlohmann::json::array());
+                    return true;
+                }
+
+                if(frames.empty()) {
+                    begin_capture(capture_target::document, nlohmann::json::array());
+                    return true;
+                }
+
+                switch(frames.back()) {
+                case frame::root:
+                    if(current_key == "layers") {
+                        map_layers_seen = true;
+                        frames.push_back(frame::layers);
+                    } else if(current_key == "tilesets") {
+                        map_tilesets_seen = true;
+                        frames.push_back(frame::tilesets);
+                    } else {
+                        begin_capture(capture_target::field, nlohmann::json::array());
+                    }
+                    break;
+                case frame::layer:
+                    if(current_key == "chunks") {
+                        layer_chunks_seen = true;
+                        frames.push_back(frame::chunks);
+                    } else if(current_key == "objects") {
+                        layer_objects_seen = true;
+                        frames.push_back(frame::objects);
+                    } else {
+                        begin_capture(capture_target::field, nlohmann::json::array());
+                    }
+                    break;
+                case frame::chunk:
+                    if(current_key == "data") {
+                        chunk_data_seen = true;
+                        frames.push_back(frame::chunk_data);
+                    } else {
+                        begin_capture(capture_target::field, nlohmann::json::array());
+                    }
+                    break;
+                case frame::chunk_data:
+                    add_invalid_tile();
+                    begin_capture(capture_target::discard, nlohmann::json::array());
+                    break;
+                default:
+                    begin_capture(capture_target::element, nlohmann::json::array());
+                    break;
+                }
+                return true;
+            }
+
+            bool key(string_t& val) override {
+                if(capturing) {
+                    fragment.set_key(std::move(val));
+                } else {
+                    current_key = std::move(val);
+                }
+                return true;
+            }
+
+            bool end_object() override {
+                if(capturing) {
+                    fragment.close();
+                    return on_fragment_event();
+                }
+
+                switch(frames.back()) {
+                case frame::root:
+                    end_map();
+                    break;
+                case frame::layer:
+                    end_layer();
+                    break;
+                case frame::chunk:
+                    end_chunk();
+                    break;
+                default:
+                    break;
+                }
+                frames.pop_back();
+                return true;
+            }
+
+            bool end_array() override {
+                if(capturing) {
+                    fragment.close();
+                    return on_fragment_event();
+                }
+
+                frames.pop_back();
+                return true;
+            }
+
+            bool parse_error(std::size_t, std::string const&, nlohmann::detail::exception const&) override {
+                return false;
+            }
+
+        private:
+            enum class frame { root, layers, layer, chunks, chunk, chunk_data, objects, tilesets };
+            enum class capture_target { field, element, document, discard };
+
+            std::vector<frame> frames;
+            std::string current_key;
+
+            bool capturing = false;
+            capture_target target = capture_target::discard;
+            json_fragment fragment;
+
+            // Map being read
+            nlohmann::json map_fields = nlohmann::json::object();
+            game::map map;
+            bool map_layers_seen = false;
+            bool map_tilesets_seen = false;
+            std::optional<error> layers_error;
+            std::optional<error> tilesets_error;
+
+            // Layer being read. Its type is only known at its end, so both kinds of data are kept until then
+            nlohmann::json layer_fields;
+            std::vector<game::packed_chunk> layer_chunks;
+            game::layer::object_data layer_objects{map.arena.get()};
+            bool layer_chunks_seen = false;
+            bool layer_objects_seen = false;
+            std::size_t layer_chunk_count = 0;
+            // First chunk error, with the index of the chunk, so that it can be compared with the data errors found at the end of the layer
+            std::optional<std::pair<std::size_t, error>> chunks_error;
+            std::optional<error> objects_error;
+            // The layer encoding can come after its chunks: string data is kept as is and decoded at the end of the layer
+            struct encoded_chunk {
+                std::size_t index;
+                game::tile_rect region;
+                std::string data;
+            };
+            std::vector<encoded_chunk> encoded_chunks;
+            std::optional<std::size_t> first_array_chunk;
+            // Identical chunks share their tiles as soon as they are read, over every layer
+            game::chunk_store chunk_store;
+
+            // Chunk being read, and then the tiles of each encoded chunk once the layer ends. Its size is only known once its
+            // fields are read, which may come after its data
+            nlohmann::json chunk_fields;
+            std::vector<game::tile> chunk_tiles;
+            // Elements of the 'data' array of the current chunk, including the invalid tiles
+            std::size_t chunk_tile_count = 0;
+            bool chunk_data_seen = false;
+            std::optional<error> tile_error;
+
+            std::optional<tl::expected<game::map, error>> result;
+
+            bool on_scalar(nlohmann::json val) {
+                if(capturing) {
+                    fragment.add(std::move(val));
+                    return on_fragment_event();
+                }
+
+                if(frames.empty()) {
+                    result = detail::parse_map(val);
+                    return true;
+                }
+
+                switch(frames.back()) {
+                case frame::chunk_data:
+                    add_invalid_tile();
+                    break;
+                case frame::root:
+                case frame::layer:
+                case frame::chunk:
+                    current_fields()[current_key] = std::move(val);
+                    break;
+                default:
+                    on_element(val);
+                    break;
+                }
+                return true;
+            }
+
+            void begin_capture(capture_target capture, nlohmann::json container) {
+                capturing = true;
+                target = capture;
+                fragment.reset(capture == capture_target::discard);
+                fragment.open(std::move(container));
+            }
+
+            bool on_fragment_event() {
+                if(!fragment.is_complete()) {
+                    return true;
+                }
+
+                capturing = false;
+                switch(target) {
+                case capture_target::field:
+                    current_fields()[current_key] = fragment.take();
+                    break;
+                case capture_target::element:
+                    on_element(fragment.take());
+                    break;
+                case capture_target::document:
+                    result = detail::parse_map(fragment.take());
+                    break;
+                case capture_target::discard:
+                    break;
+                }
+                return true;
+            }
+
+            auto current_fields() -> nlohmann::json& {
+                switch(frames.back()) {
+                case frame::layer:
+                    return layer_fields;
+                case frame::chunk:
+                    return chunk_fields;
+                default:
+                    return map_fields;
+                }
+            }
+
+            // Elements which are not streamed go through the document parsing steps
+            void on_element(nlohmann::json const& element) {
+                switch(frames.back()) {
+                case frame::layers:
+                    if(!layers_error) {
+                        auto layer = detail::parse_layer(element, map.arena.get(), map.strings);
+                        if(!layer) {
+                            layers_error = layer.error();
+                        } else {
+                            map.layers.push_back(*std::move(layer));
+                        }
+                    }
+                    break;
+                case frame::chunks:
+                    // Chunk objects are streamed: any other element is invalid whatever the layer encoding
+                    if(!chunks_error) {
+                        auto chunk = detail::parse_tile_chunk(element, detail::tile_encoding{});
+                        if(!chunk) {
+                            chunks_error.emplace(layer_chunk_count, chunk.error());
+                        }
+                    }
+                    ++layer_chunk_count;
+                    break;
+                case frame::objects:
+                    if(!objects_error) {
+                        auto object = detail::parse_object(element, map.arena.get(), map.strings);
+                        if(!object) {
+                            objects_error = object.error();
+                        } else {
+                            layer_objects.push_back(*std::move(object));
+                        }
+                    }
+                    break;
+                case frame::tilesets:
+                    if(!tilesets_error) {
+                        auto tileset = detail::parse_tileset(element);
+                        if(!tileset) {
+                            tilesets_error = tileset.error();
+                        } else {
+                            map.tilesets.push_back(*std::move(tileset));
+                        }
+                    }
+                    break;
+                default:
+                    break;
+                }
+            }
+
+            // Counted like valid tiles, since the size of the data is checked first
+            void add_invalid_tile() {
+                ++chunk_tile_count;
+                if(!tile_error) {
+                    tile_error = error{std::make_error_code(std::errc::invalid_argument), "A tile was not a positive integer"};
+                }
+            }
+
+            void begin_layer() {
+                frames.push_back(frame::layer);
+                layer_fields = nlohmann::json::object();
+                layer_chunks.clear();
+                layer_objects = game::layer::object_data(map.arena.get());
+                layer_chunks_seen = false;
+                layer_objects_seen = false;
+                layer_chunk_count = 0;
+                chunks_error.reset();
+                objects_error.reset();
+                encoded_chunks.clear();
+                first_array_chunk.reset();
+            }
+
+            void end_layer() {
+                if(layers_error) {
+                    return;
+                }
+
+                auto layer = detail::parse_layer_header(layer_fields);
+                if(!layer) {
+                    layers_error = layer.error();
+                    return;
+                }
+
+                if(layer_fields["type"] == detail::tile_layer_type) {
+                    auto const encoding = detail::parse_tile_encoding(layer_fields);
+                    if(!encoding) {
+                        layers_error = encoding.error();
+                        return;
+                    } else if(!layer_chunks_seen) {
+                        layers_error = expected_array_field("chunks");
+                        return;
+                    } else if(auto const data_error = decode_layer_chunks(*encoding)) {
+                        layers_error = *data_error;
+                        return;
+                    }
+                    game::erase_empty_chunks(layer_chunks);
+                    layer->data = game::layer::tile_data(std::exchange(layer_chunks, {}));
+                } else {
+                    if(!layer_objects_seen) {
+                        layers_error = expected_array_field("objects");
+                        return;
+                    } else if(objects_error) {
+                        layers_error = objects_error;
+                        return;
+                    }
+                    layer->data.emplace<game::layer::object_data>(std::move(layer_objects));
+                }
+
+                map.layers.push_back(*std::move(layer));
+            }
+
+            // Decodes the string data of the layer chunks, and returns the error of the first invalid chunk if any
+            auto decode_layer_chunks(detail::tile_encoding encoding) -> std::optional<error> {
+                auto first_error = std::move(chunks_error);
+                auto const fail_at = [&first_error] (std::size_t index, error e) {
+                    if(!first_error || index <= first_error->first) {
+                        first_error.emplace(index, std::move(e));
+                    }
+                };
+
+                if(encoding.base64) {
+                    if(first_array_chunk) {
+                        fail_at(*first_array_chunk, invalid_chunk_data());
+                    }
+
+                    for(encoded_chunk const& chunk : encoded_chunks) {
+                        if(first_error && first_error->first < chunk.index) {
+                            break;
+                        }
+
+                        chunk_tiles.resize(get_tile_count(chunk.region));
+                        auto const decoded = detail::decode_tile_data(chunk.data, encoding.compression, chunk_tiles.size(), chunk_tiles.data());
+                        if(!decoded) {
+                            fail_at(chunk.index, decoded.error());
+                            break;
+                        }
+                        add_chunk_tiles(chunk.region);
+                    }
+                } else if(!encoded_chunks.empty()) {
+                    fail_at(encoded_chunks.front().index, invalid_chunk_data());
+                }
+
+                if(first_error) {
+                    return std::move(first_error->second);
+                }
+                return std::nullopt;
+            }
+
+            void begin_chunk() {
+                frames.push_back(frame::chunk);
+                chunk_fields = nlohmann::json::object();
+                chunk_tiles.clear();
+                chunk_tile_count = 0;
+                chunk_data_seen = false;
+                tile_error.reset();
+            }
+
+            void end_chunk() {
+                std::size_t const index = layer_chunk_count++;
+                if(layers_error || chunks_error) {
+                    return;
+                }
+
+                auto const region = detail::parse_tile_chunk_header(chunk_fields);
+                if(!region) {
+                    chunks_error.emplace(index, region.error());
+                    return;
+                }
+
+                if(chunk_data_seen) {
+                    if(!first_array_chunk) {
+                        first_array_chunk = index;
+                    }
+                    if(chunk_tile_count != get_tile_count(*region)) {
+                        chunks_error.emplace(index, error{std::make_error_code(std::errc::invalid_argument),
+                            fmt::format("Chunk 'data' did not have {} tiles", get_tile_count(*region))});
+                        return;
+                    }
+                    if(tile_error) {
+                        chunks_error.emplace(index, *tile_error);
+                        return;
+                    }
+                    add_chunk_tiles(*region);
+                } else if(auto const data = chunk_fields.find("data"); data != chunk_fields.end() && data->is_string()) {
+                    // Packed once decoded, at the end of the layer. A layer has either encoded chunks or array chunks, so that
+                    // the chunks keep their order
+                    encoded_chunks.push_back({index, *region, std::move(data->get_ref<std::string&>())});
+                } else {
+                    chunks_error.emplace(index, invalid_chunk_data());
+                }
+            }
+
+            // Packs the tiles of a Tiled chunk, in 'chunk_tiles', into the chunks it overlaps, sharing their tiles
+            void add_chunk_tiles(game::tile_rect region) {
+                std::size_t const first = layer_chunks.size();
+                game::pack_region(region, chunk_tiles.data(), layer_chunks);
+                for(std::size_t i = first; i < layer_chunks.size(); ++i) {
+                    layer_chunks[i].tiles = chunk_store.intern(std::move(layer_chunks[i].tiles));
+                }
+            }
+
+            void end_map() {
+                auto const tile_dimensions = detail::sanitize_map(map_fields);
+                if(!tile_dimensions) {
+                    result = tl::make_unexpected(tile_dimensions.error());
+                } else if(!map_layers_seen) {
+                    result = tl::make_unexpected(expected_array_field("layers"));
+                } else if(layers_error) {
+                    result = tl::make_unexpected(*layers_error);
+                } else if(!map_tilesets_seen) {
+                    result = tl::make_unexpected(expected_array_field("tilesets"));
+                } else if(tilesets_error) {
+                    result = tl::make_unexpected(*tilesets_error);
+                } else {
+                    map.tile_dimensions = *tile_dimensions;
+                    result = std::move(map);
+                }
+            }
+        };
+    }
+
+    namespace {
+        // Only keeps the 'type' field of the root object
+        class document_type_handler final : public nlohmann::json::json_sax_t {
+        public:
+            std::string type;
+
+            bool null() override { return true; }
+            bool boolean(bool) override { return true; }
+            bool number_integer(number_integer_t) override { return true; }
+            bool number_unsigned(number_unsigned_t) override { return true; }
+            bool number_float(number_float_t, string_t const&) override { return true; }
+            bool string(string_t& val) override {
+                if(depth == 1 && is_type_key) {
+                    type = std::move(val);
+                }
+                return true;
+            }
+            bool start_object(std::size_t) override { ++depth; return true; }
+            bool end_object() override { --depth; return true; }
+            bool start_array(std::size_t) override { ++depth; return true; }
+            bool end_array() override { --depth; return true; }
+            bool key(string_t& val) override {
+                is_type_key = val == "type";
+                return true;
+            }
+            bool parse_error(std::size_t, std::string const&, nlohmann::detail::exception const&) override {
+                return false;
+            }
+
+        private:
+            int depth = 0;
+            bool is_type_key = false;
+        };
+    }
+
+    auto is_tiled_map(std::istream& data) -> bool {
+        document_type_handler handler;
+        return nlohmann::json::sax_parse(data, &handler) && handler.type == "map";
+    }
+
+    auto load_tiled_json(std::istream& map_data) -> tl::expected<game::map, error> {
+        map_handler handler;
+        if(!nlohmann::json::sax_parse(map_data, &handler)) {
+            return invalid_argument("Input stream was not a valid JSON");
+        }
+
+        auto result = handler.take_result();
+        if(!result) {
+            return invalid_argument("Input stream was not a valid JSON");
+        }
+
+        return std::move(*result).map_error([] (error e) -> error {
+            return {e.code, "Map parse error: " + e.description};
+        });
+    }
+}
\ No newline at end of file
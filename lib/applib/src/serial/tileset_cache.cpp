@@ -0,0 +1,62 @@
+#include "serial/tileset_cache.h"
+
+#include <fmt/format.h>
+
+#include <istream>
+#include <ostream>
+#include <sstream>
+
+namespace serial {
+    namespace {
+        template<typename StringT>
+        auto invalid_argument(StringT&& str) {
+            return tl::make_unexpected(error{std::make_error_code(std::errc::invalid_argument), std::forward<StringT>(str)});
+        }
+
+        // Changed whenever the line format or the meaning of a field changes
+        constexpr std::string_view format_header = "TelharTactical tileset cache 1";
+    }
+
+    // After the header, one tileset per line: size, write time, tile width, tile height, tile count and columns separated by spaces,
+    // then the source and the image separated by tabs, since paths may hold spaces
+    auto tileset_cache::load(std::istream& cache_data) -> tl::expected<tileset_cache, error> {
+        tileset_cache cache;
+        std::string line;
+        if(!std::getline(cache_data, line) || line != format_header) {
+            return cache;
+        }
+
+        int line_count = 1;
+        while(std::getline(cache_data, line)) {
+            ++line_count;
+            std::istringstream fields(line);
+            entry e;
+            std::string source;
+            fields >> e.stamp.size >> e.stamp.write_time >> e.info.tile_dimensions.x >> e.info.tile_dimensions.y >> e.info.tile_count >> e.info.columns;
+            if(!fields || fields.get() != '\t' || !std::getline(fields, source, '\t') || !std::getline(fields, e.info.image) || source.empty()) {
+                return invalid_argument(fmt::format("Error on line {}: invalid tileset entry", line_count));
+            }
+            cache.entries.insert_or_assign(std::move(source), std::move(e));
+        }
+        return cache;
+    }
+
+    void tileset_cache::save(std::ostream& cache_data) {
+        cache_data << format_header << '\n';
+        for(auto const& [source, e] : entries) {
+            cache_data << e.stamp.size << ' ' << e.stamp.write_time << ' ' << e.info.tile_dimensions.x << ' ' << e.info.tile_dimensions.y << ' '
+                << e.info.tile_count << ' ' << e.info.columns << '\t' << source << '\t' << e.info.image << '\n';
+        }
+        modified = false;
+    }
+
+    auto tileset_cache::find(std::string_view source, file_stamp stamp) const -> tiled_tileset_info const* {
+        auto const it = entries.find(source);
+        return it != entries.end() && it->second.stamp == stamp ? &it->second.info : nullptr;
+    }
+
+    void tileset_cache::insert(std::string source, file_stamp stamp, tiled_tileset_info info) {
+        entries.insert_or_assign(std::move(source), entry{stamp, std::move(info)});
+        modified = true;
+    }
+}
\ No newline at end of file
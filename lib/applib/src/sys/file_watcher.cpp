@@ -0,0 +1,142 @@
+#include "sys/file_watcher.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <system_error>
+
+#if defined(__linux__)
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <climits>
+#endif
+
+namespace sys {
+    namespace {
+        auto normalize(std::filesystem::path const& path) -> std::filesystem::path {
+            std::error_code ec;
+            auto const absolute = std::filesystem::absolute(path, ec);
+            return (ec ? path : absolute).lexically_normal();
+        }
+
+        void add_once(std::vector<std::filesystem::path>& paths, std::filesystem::path const& path) {
+            if(std::find(paths.begin(), paths.end(), path) == paths.end()) {
+                paths.push_back(path);
+            }
+        }
+
+#if !defined(__linux__)
+        auto get_last_write_time(std::filesystem::path const& path) -> std::filesystem::file_time_type {
+            std::error_code ec;
+            auto const time = std::filesystem::last_write_time(path, ec);
+            return ec ? std::filesystem::file_time_type::min() : time;
+        }
+#endif
+    }
+
+    file_watcher::file_watcher() {
+#if defined(__linux__)
+        inotify_descriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#endif
+    }
+
+    file_watcher::~file_watcher() {
+        unwatch();
+#if defined(__linux__)
+        if(inotify_descriptor != -1) {
+            ::close(inotify_descriptor);
+        }
+#endif
+    }
+
+    void file_watcher::unwatch() noexcept {
+#if defined(__linux__)
+        for(auto const& [watch_descriptor, directory] : watched_directories) {
+            inotify_rm_watch(inotify_descriptor, watch_descriptor);
+        }
+        watched_directories.clear();
+#else
+        last_write_times.clear();
+#endif
+        watched_files.clear();
+    }
+
+    auto file_watcher::watch(std::vector<std::filesystem::path> const& files) -> tl::expected<void, serial::error> {
+        unwatch();
+        for(std::filesystem::path const& file : files) {
+            add_once(watched_files, normalize(file));
+        }
+
+#if defined(__linux__)
+        if(inotify_descriptor == -1) {
+            std::error_code const code(errno, std::system_category());
+            return tl::make_unexpected(serial::error{code, fmt::format("Could not watch files: {}", code.message())});
+        }
+
+        std::vector<std::filesystem::path> directories;
+        for(std::filesystem::path const& file : watched_files) {
+            add_once(directories, file.parent_path());
+        }
+
+        for(std::filesystem::path const& directory : directories) {
+            int const watch_descriptor = inotify_add_watch(inotify_descriptor, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+            if(watch_descriptor == -1) {
+                std::error_code const code(errno, std::system_category());
+                return tl::make_unexpected(serial::error{code, fmt::format("Could not watch '{}': {}", directory.string(), code.message())});
+            }
+            watched_directories.emplace(watch_descriptor, directory);
+        }
+#else
+        for(std::filesystem::path const& file : watched_files) {
+            last_write_times.emplace(file, get_last_write_time(file));
+        }
+#endif
+        return {};
+    }
+
+    auto file_watcher::poll() -> std::vector<std::filesystem::path> {
+        std::vector<std::filesystem::path> modified;
+
+#if defined(__linux__)
+        if(inotify_descriptor == -1) {
+            return modified;
+        }
+
+        alignas(inotify_event) char buffer[16 * (sizeof(inotify_event) + NAME_MAX + 1)];
+        for(;;) {
+            ssize_t const size = ::read(inotify_descriptor, buffer, sizeof(buffer));
+            if(size <= 0) {
+                // EAGAIN once every event is read
+                break;
+            }
+
+            for(char const* it = buffer; it < buffer + size; ) {
+                auto const& event = *reinterpret_cast<inotify_event const*>(it);
+                it += sizeof(inotify_event) + event.len;
+
+                auto const directory = watched_directories.find(event.wd);
+                if(directory == watched_directories.end() || event.len == 0) {
+                    continue;
+                }
+
+                auto const file = directory->second / event.name;
+                if(std::find(watched_files.begin(), watched_files.end(), file) != watched_files.end()) {
+                    add_once(modified, file);
+                }
+            }
+        }
+#else
+        for(auto& [file, last_write_time] : last_write_times) {
+            auto const write_time = get_last_write_time(file);
+            if(write_time != last_write_time) {
+                last_write_time = write_time;
+                modified.push_back(file);
+            }
+        }
+#endif
+
+        return modified;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,154 @@
+#include "sys/mapped_file.h"
+
+#include <fmt/format.h>
+
+#include <cstdint>
+#include <utility>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace sys {
+    namespace {
+        auto open_error(std::filesystem::path const& path, std::error_code code) -> tl::unexpected<serial::error> {
+            return tl::make_unexpected(serial::error{code, fmt::format("Could not map '{}': {}", path.string(), code.message())});
+        }
+
+        auto last_error() -> std::error_code {
+#if defined(_WIN32)
+            return {static_cast<int>(GetLastError()), std::system_category()};
+#else
+            return {errno, std::system_category()};
+#endif
+        }
+    }
+
+    mapped_file::mapped_file(mapped_file&& other) noexcept
+        : bytes(std::exchange(other.bytes, nullptr))
+        , byte_count(std::exchange(other.byte_count, 0)) {
+
+    }
+
+    mapped_file& mapped_file::operator=(mapped_file&& other) noexcept {
+        if(this != &other) {
+            close();
+            bytes = std::exchange(other.bytes, nullptr);
+            byte_count = std::exchange(other.byte_count, 0);
+        }
+        return *this;
+    }
+
+    mapped_file::~mapped_file() {
+        close();
+    }
+
+    void mapped_file::close() noexcept {
+        if(bytes == nullptr) {
+            return;
+        }
+#if defined(_WIN32)
+        UnmapViewOfFile(bytes);
+#else
+        munmap(const_cast<std::byte*>(bytes), byte_count);
+#endif
+        bytes = nullptr;
+        byte_count = 0;
+    }
+
+    void mapped_file::discard(std::byte const* first, std::size_t size) const noexcept {
+        if(first < bytes || first + size > bytes + byte_count || size == 0) {
+            return;
+        }
+
+        // Whole pages only: the pages shared with neighbouring data are read again if needed, as the mapping is read-only
+#if defined(_WIN32)
+        // Unlocking pages which are not locked removes them from the working set
+        VirtualUnlock(const_cast<std::byte*>(first), size);
+#else
+        auto const page_size = static_cast<std::uintptr_t>(sysconf(_SC_PAGESIZE));
+        auto const begin = reinterpret_cast<std::uintptr_t>(first) / page_size * page_size;
+        auto const end = reinterpret_cast<std::uintptr_t>(first + size);
+        madvise(reinterpret_cast<void*>(begin), end - begin, MADV_DONTNEED);
+#endif
+    }
+
+    auto mapped_file::open(std::filesystem::path const& path) -> tl::expected<mapped_file, serial::error> {
+        mapped_file result;
+
+#if defined(_WIN32)
+        HANDLE const file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if(file == INVALID_HANDLE_VALUE) {
+            return open_error(path, last_error());
+        }
+
+        LARGE_INTEGER file_size;
+        if(!GetFileSizeEx(file, &file_size)) {
+            auto const code = last_error();
+            CloseHandle(file);
+            return open_error(path, code);
+        }
+
+        // Empty files cannot be mapped, and have no data anyway
+        if(file_size.QuadPart == 0) {
+            CloseHandle(file);
+            return result;
+        }
+
+        // The view keeps the mapping alive on its own
+        HANDLE const mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        auto const mapping_code = last_error();
+        CloseHandle(file);
+        if(mapping == nullptr) {
+            return open_error(path, mapping_code);
+        }
+
+        void const* const view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        auto const view_code = last_error();
+        CloseHandle(mapping);
+        if(view == nullptr) {
+            return open_error(path, view_code);
+        }
+
+        result.bytes = static_cast<std::byte const*>(view);
+        result.byte_count = static_cast<std::size_t>(file_size.QuadPart);
+#else
+        int const file = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if(file == -1) {
+            return open_error(path, last_error());
+        }
+
+        struct stat file_stat;
+        if(fstat(file, &file_stat) != 0) {
+            auto const code = last_error();
+            ::close(file);
+            return open_error(path, code);
+        }
+
+        if(file_stat.st_size == 0) {
+            ::close(file);
+            return result;
+        }
+
+        // The mapping stays valid after the file is closed
+        void* const view = mmap(nullptr, static_cast<std::size_t>(file_stat.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+        auto const code = last_error();
+        ::close(file);
+        if(view == MAP_FAILED) {
+            return open_error(path, code);
+        }
+
+        result.bytes = static_cast<std::byte const*>(view);
+        result.byte_count = static_cast<std::size_t>(file_stat.st_size);
+#endif
+
+        return result;
+    }
+}
\ No newline at end of file
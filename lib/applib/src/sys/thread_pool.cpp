@@ -0,0 +1,52 @@
+#include "sys/thread_pool.h"
+
+#include <algorithm>
+
+namespace sys {
+    thread_pool::thread_pool(unsigned thread_count) {
+        if(thread_count == 0) {
+            thread_count = std::max(std::thread::hardware_concurrency(), 1u);
+        }
+
+        threads.reserve(thread_count);
+        for(unsigned i = 0; i < thread_count; ++i) {
+            threads.emplace_back([this] { work(); });
+        }
+    }
+
+    thread_pool::~thread_pool() {
+        {
+            std::lock_guard<std::mutex> lock(tasks_mutex);
+            stopping = true;
+        }
+        tasks_available.notify_all();
+
+        for(std::thread& thread : threads) {
+            thread.join();
+        }
+    }
+
+    void thread_pool::push(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(tasks_mutex);
+            tasks.push_back(std::move(task));
+        }
+        tasks_available.notify_one();
+    }
+
+    void thread_pool::work() {
+        for(;;) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(tasks_mutex);
+                tasks_available.wait(lock, [this] { return stopping || !tasks.empty(); });
+                if(tasks.empty()) {
+                    return;
+                }
+                task = std::move(tasks.front());
+                tasks.pop_front();
+            }
+            task();
+        }
+    }
+}
\ No newline at end of file
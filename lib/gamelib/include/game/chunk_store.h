@@ -0,0 +1,33 @@
+#pragma once
+
+#include "game/map.h"
+#include "game/packed_chunk.h"
+
+#include <cstddef>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace game {
+    // Identical chunk tiles interned in a store are a single shared packed_tiles. The store does not keep tiles alive:
+    // they are released with the last chunk using them
+    class chunk_store {
+    public:
+        // Tiles of the store equal to 'tiles' if any. Otherwise 'tiles' is added to the store and returned
+        auto intern(std::shared_ptr<packed_tiles const> tiles) -> std::shared_ptr<packed_tiles const>;
+        void intern(std::vector<packed_chunk>& chunks);
+
+        // Distinct tiles still in use by some chunk
+        auto get_size() const noexcept -> std::size_t;
+
+    private:
+        std::unordered_multimap<std::size_t, std::weak_ptr<packed_tiles const>> entries;
+        // Entries of released tiles are removed when the store doubles
+        std::size_t next_collection = 64;
+
+        void collect();
+    };
+
+    // Interns the chunks of every tile layer of a map in a store of its own
+    void share_identical_chunks(map& map_data);
+}
\ No newline at end of file
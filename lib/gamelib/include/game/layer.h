@@ -1,8 +1,12 @@
 #pragma once
 
-#include "game/tile.h"
 #include "game/object.h"
+#include "game/packed_chunk.h"
 
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <unordered_map>
 #include <vector>
 #include <variant>
 
@@ -13,13 +17,101 @@ namespace game {
         
         id_t id;
         
-        struct tile_data {
-            std::vector<tile_chunk> chunks;
+        // Chunks, indexed by their coordinates so that finding the chunk holding a tile takes constant time
+        class tile_data {
+        public:
+            tile_data() noexcept
+                : layout(tile_layout::row_major) {
+            }
+            // Chunks holding no tile are left out by the loaders. Chunks at the same position are merged into the first one, with
+            // the tiles of later ones over the tiles of earlier ones, leaving out tile::id::none: see merge_tiles. The chunks are
+            // expected in 'layout'
+            explicit tile_data(std::vector<packed_chunk> chunks, tile_layout layout = tile_layout::row_major);
+
+            auto get_chunks() const noexcept -> std::vector<packed_chunk> const& { return chunks; }
+            // Of the chunks added by edits, see set_layout
+            auto get_layout() const noexcept -> tile_layout { return layout; }
+            // Leaves the layer without chunks
+            auto release_chunks() noexcept -> std::vector<packed_chunk>;
+            // Calls 'f' with the tiles of each chunk, which it may replace. The chunks stay where they are
+            template<typename F>
+            void update_tiles(F&& f) {
+                for(packed_chunk& chunk : chunks) {
+                    f(chunk.tiles);
+                }
+            }
+            // Replaces the tiles of the chunk at chunk coordinates, adding the chunk if there is none, and marks it dirty
+            void set_chunk_tiles(math::vector2i chunk_coordinates, std::shared_ptr<packed_tiles const> tiles);
+            // Sets a tile, adding its chunk if there is none, and marks the chunk dirty. Returns whether the tile changed
+            auto set_tile(math::vector2i tile_position, tile value) -> bool;
+
+            // Chunk at chunk coordinates, see get_chunk_coordinates, or nullptr if there is none
+            auto find_chunk(math::vector2i chunk_coordinates) const -> packed_chunk const*;
+            // Tile at tile coordinates, or tile::id::none if no chunk holds it
+            auto get_tile(math::vector2i tile_position) const -> tile;
+
+            // Positions of the chunks whose tiles were set since the last call, in the order they were first set. Chunks
+            // only interned with update_tiles are not dirty
+            auto take_dirty_chunks() -> std::vector<math::vector2i>;
+
+        private:
+            std::vector<packed_chunk> chunks;
+            tile_layout layout;
+            // Chunk indices, by chunk coordinates
+            std::unordered_map<std::uint64_t, std::size_t> index;
+            // By chunk index, along with the indices of the dirty chunks so that they are found without walking every chunk
+            std::vector<bool> dirty;
+            std::vector<std::size_t> dirty_chunks;
+
+            auto add_chunk(math::vector2i chunk_coordinates) -> std::size_t;
+            void mark_dirty(std::size_t chunk_index);
         };
 
-    	struct object_data {
-            std::vector<object> objects;
-    	};
+        // Objects as a structure of arrays: the fields read by culling and queries each have an array of their own, and the text,
+        // polygon, polyline and sprite payloads are in side tables, so that walking the objects only touches what is read. The
+        // arrays are allocated from the arena of the map, see map_arena. Filled like a vector by the loaders
+        class object_data {
+        public:
+            object_data() = default;
+            explicit object_data(std::pmr::memory_resource* memory);
+
+            auto size() const noexcept -> std::size_t { return ids.size(); }
+            void reserve(std::size_t count);
+            // Adds an object, moving its payload into the side table of its kind
+            void push_back(object&& value);
+            // Copy of an object with its payload, for the code which needs a whole object
+            auto get_object(std::size_t index) const -> object;
+
+            // By object index
+            auto get_ids() const noexcept -> std::pmr::vector<object::identifier> const& { return ids; }
+            auto get_positions() const noexcept -> std::pmr::vector<math::vector2i> const& { return positions; }
+            auto get_dimensions() const noexcept -> std::pmr::vector<math::vector2i> const& { return dimensions; }
+            auto get_kinds() const noexcept -> std::pmr::vector<object::kind> const& { return kinds; }
+            auto get_types() const noexcept -> std::pmr::vector<string_id> const& { return types; }
+            auto get_names() const noexcept -> std::pmr::vector<string_id> const& { return names; }
+            auto get_rotations() const noexcept -> std::pmr::vector<double> const& { return rotations; }
+
+            // Payload of an object, which must be of the matching kind
+            auto get_polygon(std::size_t index) const noexcept -> polygon_data const& { return polygons[payloads[index]]; }
+            auto get_polyline(std::size_t index) const noexcept -> polyline_data const& { return polylines[payloads[index]]; }
+            auto get_text(std::size_t index) const noexcept -> text_data const& { return texts[payloads[index]]; }
+            auto get_sprite(std::size_t index) const noexcept -> sprite_data const& { return sprites[payloads[index]]; }
+
+        private:
+            std::pmr::vector<object::identifier> ids;
+            std::pmr::vector<math::vector2i> positions;
+            std::pmr::vector<math::vector2i> dimensions;
+            std::pmr::vector<object::kind> kinds;
+            std::pmr::vector<string_id> types;
+            std::pmr::vector<string_id> names;
+            std::pmr::vector<double> rotations;
+            // Index of the payload of each object in the side table of its kind, 0 for the kinds without a payload
+            std::pmr::vector<std::uint32_t> payloads;
+            std::pmr::vector<polygon_data> polygons;
+            std::pmr::vector<polyline_data> polylines;
+            std::pmr::vector<text_data> texts;
+            std::pmr::vector<sprite_data> sprites;
+        };
 
         std::variant<tile_data, object_data> data;
 
@@ -1,8 +1,15 @@
 #pragma once
 
 #include "layer.h"
+#include "map_arena.h"
+#include "string_pool.h"
 
+#include <array>
+#include <cstddef>
 #include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 namespace game {
     struct tileset {
@@ -10,12 +17,78 @@ namespace game {
 		tile::id starting_id;
     };
 
+    // Tiles which an edit of map_edit.h may have changed
+    struct tile_change {
+        std::size_t layer_index;
+        tile_rect region;
+    };
+
     struct map {
+        // Memory of the objects. First, so that it outlives them
+        map_arena arena;
+        // Names, types and fonts of the objects
+        string_pool strings;
         std::vector<layer> layers;
         std::vector<tileset> tilesets;
+        // Pixels of a tile in the source map, which the positions and dimensions of the objects are in. Tiles of any size are
+        // drawn at tile::dimensions
+        math::vector2i tile_dimensions = tile::dimensions;
+        // Edits since the last drain_edits, in the order they were made
+        std::vector<tile_change> edit_journal;
     };
 	
 	// tile id should be greater than 0
 	auto get_tileset(map & map_data, tile::id id) -> tileset&;
 	auto get_tileset(map const& map_data, tile::id id) -> tileset const&;
+
+	// Tile of a layer at tile coordinates, or tile::id::none if the layer has no tile there or is an object layer
+	auto get_tile(map const& map_data, std::size_t layer_index, math::vector2i tile_position) -> tile;
+	auto get_tile_at_pixel(map const& map_data, std::size_t layer_index, math::vector2i pixel) -> tile;
+
+	struct layer_tile {
+		std::size_t layer_index;
+		tile value;
+	};
+
+	// Tiles of every tile layer at tile coordinates, from the bottom layer to the top one, leaving out the layers without a tile there
+	auto get_tiles(map const& map_data, math::vector2i tile_position) -> std::vector<layer_tile>;
+	auto get_tiles_at_pixel(map const& map_data, math::vector2i pixel) -> std::vector<layer_tile>;
+
+	struct object_ref {
+		std::size_t layer_index;
+		std::size_t object_index;
+	};
+
+	// Objects of every object layer whose type is 'type', by layer then by position in the layer. The type is looked up once, then
+	// objects are compared by handle
+	auto find_objects_of_type(map const& map_data, std::string_view type) -> std::vector<object_ref>;
+	// Objects of every object layer whose bounds, ignoring their rotation, overlap the rectangle of pixels at 'position' of 'size'
+	auto find_objects_in(map const& map_data, math::vector2i position, math::vector2i size) -> std::vector<object_ref>;
+
+	struct map_changes {
+		// Layers or tilesets were added, removed or changed: the whole map was replaced
+		bool structure_changed = false;
+		// Chunks were added or removed, so the chunks of some tile layers moved in memory
+		bool chunks_moved = false;
+		// Tile chunks replaced, added or removed, by layer index and position
+		std::vector<std::pair<std::size_t, math::vector2i>> changed_chunks;
+	};
+
+	// Replaces the chunks of 'map_data' which differ from those of 'updated', leaving the others in place. Object layers are replaced
+	auto update_map(map& map_data, map&& updated) -> map_changes;
+
+	struct layer_memory {
+		std::size_t layer_index;
+		std::size_t chunk_count = 0;
+		// Chunks sharing the tiles of a chunk counted before them, in this layer or a previous one
+		std::size_t shared_chunks = 0;
+		// Bytes of the chunks as they are stored, and as they would be as tile_chunk
+		std::size_t packed_bytes = 0;
+		std::size_t unpacked_bytes = 0;
+		// Chunks of each packed_tiles::encoding
+		std::array<std::size_t, 4> encoding_counts{};
+	};
+
+	// Memory taken by the chunks of each tile layer
+	auto get_memory_report(map const& map_data) -> std::vector<layer_memory>;
 }
\ No newline at end of file
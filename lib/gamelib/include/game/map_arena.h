@@ -0,0 +1,31 @@
+#pragma once
+
+#include <memory>
+#include <memory_resource>
+
+namespace game {
+    // Memory of the objects of a map, with their strings and points: see layer::object_data. It comes from a monotonic
+    // buffer, and is released at once with the arena rather than object by object. Allocations may come from several
+    // threads, as the parallel loader converts objects on the pool threads
+    class map_arena {
+    public:
+        map_arena() noexcept;
+        // A copy has memory of its own, since copied containers do not use the memory resource of their source
+        map_arena(map_arena const&) noexcept;
+        map_arena(map_arena&& other) noexcept;
+        ~map_arena();
+
+        // Containers keep their memory resource when assigned to, so the arena assigned to keeps its memory
+        auto operator=(map_arena const&) noexcept -> map_arena& { return *this; }
+        // Swaps the memory: containers moved out of the map of 'other' find theirs in this arena, while those they replace
+        // find theirs in 'other' until it is destroyed
+        auto operator=(map_arena&& other) noexcept -> map_arena&;
+
+        // Created on first use
+        auto get() -> std::pmr::memory_resource*;
+
+    private:
+        class resource;
+        std::unique_ptr<resource> memory;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "game/map.h"
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace game {
+    // Edits of the tile layers of a map at runtime. Chunks are added where tiles are set, and kept when they end up empty.
+    // Each edit which changed a tile is added to the map's journal, and the chunks it changed are marked dirty.
+    // The layers must be tile layers
+
+    // Returns whether the tile changed
+    auto set_tile(map& map_data, std::size_t layer_index, math::vector2i tile_position, tile value) -> bool;
+    // Chunks covered by the region share a single packed_tiles
+    void fill_rect(map& map_data, std::size_t layer_index, tile_rect region, tile value);
+    // Copies the tiles of a region to 'destination', the top left corner of the copy. The regions may overlap
+    void copy_region(map& map_data, std::size_t source_layer_index, tile_rect source, std::size_t destination_layer_index, math::vector2i destination);
+
+    struct map_edits {
+        // Chunks whose tiles were set, by layer index and position, each once
+        std::vector<std::pair<std::size_t, math::vector2i>> changed_chunks;
+        // Journal of the map. Tiles set through a mutable_region_view only show in 'changed_chunks'
+        std::vector<tile_change> changes;
+    };
+
+    // Edits since the last call, leaving the journal empty and the chunks clean. Meant to be called once per update, with
+    // the edits then handed to each system keeping data derived from the tiles
+    auto drain_edits(map& map_data) -> map_edits;
+}
\ No newline at end of file
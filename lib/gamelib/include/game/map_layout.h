@@ -0,0 +1,20 @@
+#pragma once
+
+#include "game/map.h"
+
+#include <vector>
+
+namespace game {
+    // Sorts chunks along a Hilbert curve over their chunk coordinates, so that chunks close on the map are close in memory
+    void sort_chunks_along_hilbert_curve(std::vector<packed_chunk>& chunks);
+
+    struct map_layout {
+        tile_layout tiles = tile_layout::row_major;
+        // Otherwise the chunks are kept in the order they were loaded
+        bool hilbert_chunk_order = false;
+    };
+
+    // Lays out the chunks of every tile layer of a map: chunks are sorted first, then their tiles are repacked in order,
+    // so that the tiles of neighbor chunks are also allocated together. Shared tiles stay shared. Chunks are left clean
+    void set_layout(map& map_data, map_layout layout);
+}
\ No newline at end of file
@@ -2,7 +2,9 @@
 
 #include "math/vector2.h"
 #include "game/tile.h"
+#include "game/string_pool.h"
 
+#include <memory_resource>
 #include <string>
 #include <variant>
 #include <vector>
@@ -24,10 +26,16 @@ namespace game {
 	struct ellipse_data { };
 	struct point_data { };
 	struct polygon_data	{
-		std::vector<math::vector2i> points;
+		polygon_data() = default;
+		explicit polygon_data(std::pmr::memory_resource* memory) : points(memory) { }
+
+		std::pmr::vector<math::vector2i> points;
 	};
 	struct polyline_data {
-		std::vector<math::vector2i> points;
+		polyline_data() = default;
+		explicit polyline_data(std::pmr::memory_resource* memory) : points(memory) { }
+
+		std::pmr::vector<math::vector2i> points;
 	};
 	struct text_data {
 		enum class vertical_alignment {
@@ -43,9 +51,13 @@ namespace game {
 			justified,
 		};
 		
-		std::string text;
+		text_data() = default;
+		explicit text_data(std::pmr::memory_resource* memory) : text(memory) { }
+
+		std::pmr::string text;
 		rgba32_color color;
-		std::string font;
+		// In the string pool of the map
+		string_id font;
 		int point_size;
 		vertical_alignment valign;
 		horizontal_alignment halign;
@@ -64,10 +76,10 @@ namespace game {
 		enum class identifier {};
 		enum class kind { rectangle, point, ellipse, polygon, polyline, text, sprite };
 
-		// Identity
+		// Identity. The name and type are in the string pool of the map, so that objects of a type are found comparing handles
 		identifier id;
-		std::string name;
-		std::string type;
+		string_id name;
+		string_id type;
 		
 		// Physic
 		double rotation;
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "game/tile.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace game {
+    // Tiles of a chunk, encoded after the number of distinct tiles it holds. Most chunks hold a handful of tiles, so that
+    // they take a fraction of the memory of a tile_chunk. Equal tiles in the same layout always give the same encoding.
+    // The tiles are encoded in their layout, which only shows in the encoding: tile indices are always row by row. Uniform tiles
+    // keep their layout too, so that the chunks of a layer stay in its layout when their tiles are set
+    class packed_tiles {
+    public:
+        enum class encoding : std::uint8_t {
+            // A single tile, over the whole chunk
+            uniform,
+            // Up to 16 tiles, with a 4 bits palette index per tile
+            palette,
+            // Up to 16 tiles, with runs of palette indices: a byte of index and two bytes of the index of the tile after the run,
+            // so that finding the run of a tile is a binary search over the runs
+            palette_runs,
+            // Every tile as is
+            raw,
+        };
+
+        static constexpr std::size_t max_palette_size = 16;
+
+        // Every tile is tile::id::none
+        packed_tiles();
+        explicit packed_tiles(tile_layout layout);
+        // Packs the tile_chunk::tile_count tiles of 'tiles', row by row, in 'layout'
+        explicit packed_tiles(tile const* tiles, tile_layout layout = tile_layout::row_major);
+
+        auto get_encoding() const noexcept -> encoding { return type; }
+        auto get_layout() const noexcept -> tile_layout { return layout; }
+        // Whether every tile is tile::id::none
+        auto is_empty() const noexcept -> bool;
+
+        auto get_tile(std::size_t index) const noexcept -> tile;
+        // Writes the tile_chunk::tile_count tiles to 'tiles', row by row
+        void decode(tile* tiles) const noexcept;
+
+        // Bytes allocated for the tiles, besides the packed_tiles itself
+        auto get_allocated_bytes() const noexcept -> std::size_t;
+        // Of the tiles, so that equal tiles have the same hash
+        auto get_hash() const noexcept -> std::size_t { return hash; }
+
+        auto operator==(packed_tiles const& other) const noexcept -> bool;
+        auto operator!=(packed_tiles const& other) const noexcept -> bool { return !(*this == other); }
+
+    private:
+        encoding type;
+        tile_layout layout = tile_layout::row_major;
+        std::size_t hash;
+        // Distinct tiles in order of appearance, or every tile for the raw encoding
+        std::vector<tile> palette;
+        // Palette indices, two per byte with the first tile in the low bits, or runs
+        std::vector<std::uint8_t> indices;
+
+        void encode(tile const* tiles);
+        void decode_in_layout(tile* tiles) const noexcept;
+    };
+
+    struct packed_chunk {
+        math::vector2i position;
+        // Never null. Immutable, so that identical chunks can share their tiles: see chunk_store
+        std::shared_ptr<packed_tiles const> tiles;
+    };
+
+    // Bytes taken by a chunk and its tiles, as if they were not shared
+    auto get_memory_usage(packed_chunk const& chunk) noexcept -> std::size_t;
+
+    // The tiles of the packed chunk are not shared yet
+    auto pack_chunk(tile_chunk const& chunk) -> packed_chunk;
+    auto unpack_chunk(packed_chunk const& chunk) -> tile_chunk;
+
+    // Copy on write: the chunk gets tiles of its own in the same layout, leaving those it shared as they are
+    void set_tile(packed_chunk& chunk, std::size_t index, tile value);
+    // Copy on write, like set_tile: sets the tiles of the chunk to those of 'other' which are not tile::id::none
+    void merge_tiles(packed_chunk& chunk, packed_tiles const& other);
+
+    // Packs the tiles of a rectangle, row by row, into the chunks it overlaps, appended to 'chunks' row by row. Tiles of those
+    // chunks out of the rectangle are tile::id::none. A rectangle covering exactly one chunk is packed without a copy
+    void pack_region(tile_rect region, tile const* tiles, std::vector<packed_chunk>& chunks);
+
+    // Removes the chunks which hold no tile, keeping the others in order
+    void erase_empty_chunks(std::vector<packed_chunk>& chunks);
+}
\ No newline at end of file
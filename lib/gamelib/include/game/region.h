@@ -0,0 +1,105 @@
+#pragma once
+
+#include "game/layer.h"
+
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+namespace game {
+    // Contiguous tiles of a row of a region, all in the same chunk
+    template<typename Tile>
+    struct basic_tile_span {
+        // Tile coordinates of the first tile
+        math::vector2i position;
+        Tile* first;
+        Tile* last;
+
+        auto begin() const noexcept -> Tile* { return first; }
+        auto end() const noexcept -> Tile* { return last; }
+        auto size() const noexcept -> std::size_t { return static_cast<std::size_t>(last - first); }
+        auto operator[](std::size_t index) const noexcept -> Tile& { return first[index]; }
+    };
+
+    using tile_span = basic_tile_span<tile const>;
+    using mutable_tile_span = basic_tile_span<tile>;
+
+    // Rows of the tiles of a layer in a region, cut at chunk boundaries. The chunks overlapping the region are walked row
+    // by row in chunk coordinates, then each chunk row by row, so that a chunk is looked up and decoded once. Absent and
+    // empty chunks are skipped, so that their tiles, all tile::id::none, are not seen.
+    // A view is walked once: its spans point into the chunk being walked, and are only valid until the next one.
+    // The mutable view writes the tiles of a chunk back when leaving it, giving the chunk tiles of its own if they
+    // changed; it does not add chunks
+    template<bool Mutable>
+    class basic_region_view {
+    public:
+        using tile_data_type = std::conditional_t<Mutable, layer::tile_data, layer::tile_data const>;
+        using span_type = basic_tile_span<std::conditional_t<Mutable, tile, tile const>>;
+
+        basic_region_view(tile_data_type& tiles, tile_rect region);
+        basic_region_view(basic_region_view const&) = delete;
+        auto operator=(basic_region_view const&) -> basic_region_view& = delete;
+        ~basic_region_view();
+
+        class iterator {
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = span_type;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = span_type;
+
+            auto operator*() const noexcept -> span_type { return view->get_span(); }
+            auto operator++() -> iterator& {
+                view->next_row();
+                return *this;
+            }
+            void operator++(int) { ++*this; }
+
+            auto operator==(iterator const& other) const noexcept -> bool { return is_end() == other.is_end(); }
+            auto operator!=(iterator const& other) const noexcept -> bool { return !(*this == other); }
+
+        private:
+            friend class basic_region_view;
+            explicit iterator(basic_region_view* view) noexcept : view(view) { }
+
+            basic_region_view* view;
+
+            auto is_end() const noexcept -> bool { return view == nullptr || view->chunk == nullptr; }
+        };
+
+        auto begin() noexcept -> iterator { return iterator(this); }
+        auto end() noexcept -> iterator { return iterator(nullptr); }
+
+    private:
+        tile_data_type* tiles;
+        // Last tile and chunk excluded
+        math::vector2i first_tile, last_tile;
+        math::vector2i first_chunk, last_chunk;
+
+        // Chunk being walked, or nullptr past the last one
+        math::vector2i chunk_coordinates;
+        packed_chunk const* chunk = nullptr;
+        // Row being walked, and the part of it in the region, in tile coordinates
+        int row = 0;
+        int last_row = 0;
+        int row_first_x = 0;
+        int row_last_x = 0;
+        // Decoded tiles of the chunk. Consecutive chunks sharing their tiles are decoded once
+        std::array<tile, tile_chunk::tile_count> chunk_tiles;
+        packed_tiles const* decoded = nullptr;
+
+        auto get_span() noexcept -> span_type;
+        void next_row();
+        // Finds the first chunk holding tiles from 'chunk_coordinates' on
+        void find_chunk();
+        void write_back();
+    };
+
+    extern template class basic_region_view<false>;
+    extern template class basic_region_view<true>;
+
+    using region_view = basic_region_view<false>;
+    using mutable_region_view = basic_region_view<true>;
+}
\ No newline at end of file
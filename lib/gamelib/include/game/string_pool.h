@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace game {
+    // Handle of a string of a string_pool. Two handles of the same pool are equal exactly when their strings are
+    enum class string_id : std::uint32_t { empty = 0 };
+
+    // Strings of a map, such as object names and types, stored once however often they are used. Handles stay valid as more
+    // strings are interned. Strings may be interned from several threads at once, as the parallel loader does, but not looked
+    // up while they are
+    class string_pool {
+    public:
+        string_pool();
+        string_pool(string_pool const& other);
+        string_pool(string_pool&& other) noexcept;
+        auto operator=(string_pool const& other) -> string_pool&;
+        auto operator=(string_pool&& other) noexcept -> string_pool&;
+
+        // Handle of 'value', added to the pool if it was not in it
+        auto intern(std::string_view value) -> string_id;
+        // Handle of 'value', if it was interned
+        auto find(std::string_view value) const -> std::optional<string_id>;
+        // 'id' must come from this pool
+        auto get(string_id id) const noexcept -> std::string_view { return strings[static_cast<std::size_t>(id)]; }
+
+        // Distinct strings, counting the empty one
+        auto get_size() const noexcept -> std::size_t { return strings.size(); }
+
+    private:
+        // A deque, so that the keys of 'ids' keep pointing to their string as more are added
+        std::deque<std::string> strings;
+        std::unordered_map<std::string_view, string_id> ids;
+        std::mutex mutex;
+
+        // Leaves only the empty string, as in a new pool
+        void reset();
+    };
+}
\ No newline at end of file
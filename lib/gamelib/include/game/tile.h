@@ -1,20 +1,72 @@
 #pragma once
 
-#include <vector>
+#include <array>
+#include <cstddef>
+#include <cstdint>
 
 #include "math/vector2.h"
 
+// Tile and chunk dimensions are build options, so that loops over the tiles of a chunk keep a constant trip count: tiles
+// are KT_TILE_SIZE pixels square, and chunks KT_CHUNK_SIZE tiles square
+#ifndef KT_TILE_SIZE
+#define KT_TILE_SIZE 32
+#endif
+#ifndef KT_CHUNK_SIZE
+#define KT_CHUNK_SIZE 16
+#endif
+
 namespace game {
     struct tile {
-        static constexpr math::vector2i dimensions{32, 32}; // pixels
-        enum class id { none = 0 };
+        static constexpr math::vector2i dimensions{KT_TILE_SIZE, KT_TILE_SIZE}; // pixels
+        static_assert(KT_TILE_SIZE > 0, "Tiles need a positive size");
+        enum class id : std::uint32_t { none = 0 };
+
+        // Tiled's flags, in the high bits of a global tile id. The diagonal flip swaps the x and y axes, and is applied before the others
+        static constexpr std::uint32_t flip_horizontal = 0x80000000u;
+        static constexpr std::uint32_t flip_vertical = 0x40000000u;
+        static constexpr std::uint32_t flip_diagonal = 0x20000000u;
+        static constexpr std::uint32_t flip_flags = flip_horizontal | flip_vertical | flip_diagonal;
+
+        // Global tile id as Tiled stores it: the flip flags, then the id
         id data;
+
+        auto get_id() const noexcept -> id { return static_cast<id>(static_cast<std::uint32_t>(data) & ~flip_flags); }
+        auto get_flips() const noexcept -> std::uint32_t { return static_cast<std::uint32_t>(data) & flip_flags; }
+    };
+
+    // Order of the tiles of a chunk in memory
+    enum class tile_layout : std::uint8_t {
+        // Row by row
+        row_major,
+        // Along a Z-order curve, so that the tiles of each aligned square block of the chunk with a power of two side are next to each other
+        z_order,
     };
 
     struct tile_chunk {
-        static constexpr math::vector2i dimensions{16, 16}; // tiles
+        static constexpr math::vector2i dimensions{KT_CHUNK_SIZE, KT_CHUNK_SIZE}; // tiles
+        static constexpr std::size_t tile_count = dimensions.x * dimensions.y;
+        static_assert(dimensions.x == dimensions.y && (dimensions.x & (dimensions.x - 1)) == 0, "The Z-order layout needs square chunks with a power of two side");
+        // Chunks are decoded on the stack, and tile indices within a chunk take 16 bits
+        static_assert(dimensions.x >= 2 && dimensions.x <= 128, "Chunks need a side from 2 to 128 tiles");
 
         math::vector2i position;
-        std::vector<tile> tiles;
+        // Row by row. Layers hold their chunks packed, see packed_chunk: a tile_chunk is the buffer they are decoded to and edited in
+        std::array<tile, tile_count> tiles;
     };
+
+    // Rectangle of tiles, in tile coordinates
+    struct tile_rect {
+        math::vector2i position;
+        math::vector2i size;
+    };
+
+    // Coordinates of the chunk holding a tile, in chunks. Chunks are aligned on their dimensions
+    constexpr auto get_chunk_coordinates(math::vector2i tile_position) noexcept -> math::vector2i {
+        return math::element_floor_div(tile_position, tile_chunk::dimensions);
+    }
+
+    // Coordinates of the tile under a pixel, in tiles
+    constexpr auto get_tile_position(math::vector2i pixel) noexcept -> math::vector2i {
+        return math::element_floor_div(pixel, tile::dimensions);
+    }
 }
\ No newline at end of file
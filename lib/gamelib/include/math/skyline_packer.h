@@ -0,0 +1,32 @@
+#pragma once
+
+#include "math/vector2.h"
+
+#include <optional>
+#include <vector>
+
+namespace math {
+    // Packs rectangles in a fixed area. The bottom edge of the packed rectangles, the skyline, is kept as horizontal segments,
+    // and each rectangle is placed on it where its own bottom edge ends up the highest
+    class skyline_packer {
+    public:
+        explicit skyline_packer(vector2i dimensions);
+
+        // Top left corner of the rectangle, or nothing if it does not fit anymore
+        auto insert(vector2i size) -> std::optional<vector2i>;
+
+        auto get_dimensions() const noexcept -> vector2i { return dimensions; }
+
+    private:
+        struct segment {
+            int x, y, width;
+        };
+
+        vector2i dimensions;
+        // Sorted by x, covering the whole width
+        std::vector<segment> skyline;
+
+        // Top of a rectangle of 'size' placed at the start of segment 'index', if it fits there
+        auto fit(std::size_t index, vector2i size) const -> std::optional<int>;
+    };
+}
\ No newline at end of file
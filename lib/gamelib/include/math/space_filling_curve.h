@@ -0,0 +1,47 @@
+#pragma once
+
+#include "math/vector2.h"
+
+#include <cstdint>
+
+namespace math {
+    // Interleaves the bits of the coordinates, x in the even bits, so that points close on both axes are close on the curve.
+    // The coordinates must not be negative
+    constexpr auto get_z_order_index(vector2i position) noexcept -> std::uint64_t {
+        auto const spread = [] (std::uint64_t value) {
+            value = (value | value << 16) & 0x0000FFFF0000FFFFull;
+            value = (value | value << 8) & 0x00FF00FF00FF00FFull;
+            value = (value | value << 4) & 0x0F0F0F0F0F0F0F0Full;
+            value = (value | value << 2) & 0x3333333333333333ull;
+            value = (value | value << 1) & 0x5555555555555555ull;
+            return value;
+        };
+        return spread(static_cast<std::uint32_t>(position.x)) | spread(static_cast<std::uint32_t>(position.y)) << 1;
+    }
+
+    // Distance along a Hilbert curve covering every int coordinate. Unlike the Z-order curve, consecutive points of the
+    // curve are always neighbors
+    constexpr auto get_hilbert_index(vector2i position) noexcept -> std::uint64_t {
+        constexpr std::uint64_t side = std::uint64_t{1} << 32;
+        // Flipping the sign bit keeps the order of the coordinates, from the most negative one on
+        std::uint64_t x = static_cast<std::uint32_t>(position.x) ^ 0x80000000u;
+        std::uint64_t y = static_cast<std::uint32_t>(position.y) ^ 0x80000000u;
+        std::uint64_t index = 0;
+        for(std::uint64_t s = side / 2; s > 0; s /= 2) {
+            std::uint64_t const rx = (x & s) != 0 ? 1 : 0;
+            std::uint64_t const ry = (y & s) != 0 ? 1 : 0;
+            index += s * s * ((3 * rx) ^ ry);
+            // Rotates the quadrant, so that the curve within it starts where the previous quadrant ended
+            if(ry == 0) {
+                if(rx == 1) {
+                    x = side - 1 - x;
+                    y = side - 1 - y;
+                }
+                std::uint64_t const swapped = x;
+                x = y;
+                y = swapped;
+            }
+        }
+        return index;
+    }
+}
\ No newline at end of file
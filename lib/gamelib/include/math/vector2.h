@@ -79,4 +79,13 @@ namespace math {
     inline auto element_multiply(vector2<T> lhs, vector2<U> rhs) -> vector2<decltype(std::declval<T>() * std::declval<U>())> {
         return {lhs.x * rhs.x, lhs.y * rhs.y};
     }
+
+    // Rounded towards negative infinity, so that negative coordinates fall in the cell before the origin
+    constexpr auto floor_div(int value, int divisor) noexcept -> int {
+        return value / divisor - (value % divisor < 0 ? 1 : 0);
+    }
+
+    constexpr auto element_floor_div(vector2i lhs, vector2i rhs) noexcept -> vector2i {
+        return {floor_div(lhs.x, rhs.x), floor_div(lhs.y, rhs.y)};
+    }
 }
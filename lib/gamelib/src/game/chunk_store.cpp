@@ -0,0 +1,56 @@
+#include "game/chunk_store.h"
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <variant>
+
+namespace game {
+    auto chunk_store::intern(std::shared_ptr<packed_tiles const> tiles) -> std::shared_ptr<packed_tiles const> {
+        auto [first, last] = entries.equal_range(tiles->get_hash());
+        while(first != last) {
+            std::shared_ptr<packed_tiles const> stored = first->second.lock();
+            if(!stored) {
+                first = entries.erase(first);
+            } else if(*stored == *tiles) {
+                return stored;
+            } else {
+                ++first;
+            }
+        }
+
+        if(entries.size() >= next_collection) {
+            collect();
+            next_collection = std::max<std::size_t>(64, entries.size() * 2);
+        }
+        entries.emplace(tiles->get_hash(), tiles);
+        return tiles;
+    }
+
+    void chunk_store::intern(std::vector<packed_chunk>& chunks) {
+        for(packed_chunk& chunk : chunks) {
+            chunk.tiles = intern(std::move(chunk.tiles));
+        }
+    }
+
+    auto chunk_store::get_size() const noexcept -> std::size_t {
+        return static_cast<std::size_t>(std::count_if(entries.begin(), entries.end(), [] (auto const& entry) { return !entry.second.expired(); }));
+    }
+
+    void chunk_store::collect() {
+        for(auto it = entries.begin(); it != entries.end();) {
+            it = it->second.expired() ? entries.erase(it) : std::next(it);
+        }
+    }
+
+    void share_identical_chunks(map& map_data) {
+        chunk_store store;
+        for(layer& l : map_data.layers) {
+            if(auto const tiles = std::get_if<layer::tile_data>(&l.data)) {
+                tiles->update_tiles([&store] (std::shared_ptr<packed_tiles const>& chunk_tiles) {
+                    chunk_tiles = store.intern(std::move(chunk_tiles));
+                });
+            }
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,192 @@
+#include "game/layer.h"
+
+#include <utility>
+#include <variant>
+
+namespace game {
+    namespace {
+        auto get_index_key(math::vector2i chunk_coordinates) noexcept -> std::uint64_t {
+            return std::uint64_t{static_cast<std::uint32_t>(chunk_coordinates.x)} << 32 | static_cast<std::uint32_t>(chunk_coordinates.y);
+        }
+    }
+
+    layer::tile_data::tile_data(std::vector<packed_chunk> chunks, tile_layout layout)
+        : chunks(std::move(chunks))
+        , layout(layout) {
+        index.reserve(this->chunks.size());
+        std::size_t kept = 0;
+        for(std::size_t i = 0; i < this->chunks.size(); ++i) {
+            auto const [it, added] = index.emplace(get_index_key(get_chunk_coordinates(this->chunks[i].position)), kept);
+            if(added) {
+                if(kept != i) {
+                    this->chunks[kept] = std::move(this->chunks[i]);
+                }
+                ++kept;
+            } else {
+                merge_tiles(this->chunks[it->second], *this->chunks[i].tiles);
+            }
+        }
+        this->chunks.resize(kept);
+        dirty.assign(kept, false);
+    }
+
+    auto layer::tile_data::release_chunks() noexcept -> std::vector<packed_chunk> {
+        index.clear();
+        dirty.clear();
+        dirty_chunks.clear();
+        return std::exchange(chunks, {});
+    }
+
+    void layer::tile_data::set_chunk_tiles(math::vector2i chunk_coordinates, std::shared_ptr<packed_tiles const> tiles) {
+        std::size_t const chunk_index = add_chunk(chunk_coordinates);
+        chunks[chunk_index].tiles = std::move(tiles);
+        mark_dirty(chunk_index);
+    }
+
+    auto layer::tile_data::set_tile(math::vector2i tile_position, tile value) -> bool {
+        math::vector2i const chunk_coordinates = get_chunk_coordinates(tile_position);
+        if(value.data == tile::id::none && find_chunk(chunk_coordinates) == nullptr) {
+            return false;
+        }
+
+        std::size_t const chunk_index = add_chunk(chunk_coordinates);
+        math::vector2i const in_chunk = tile_position - element_multiply(chunk_coordinates, tile_chunk::dimensions);
+        std::size_t const tile_index = static_cast<std::size_t>(in_chunk.y * tile_chunk::dimensions.x + in_chunk.x);
+        if(chunks[chunk_index].tiles->get_tile(tile_index).data == value.data) {
+            return false;
+        }
+        game::set_tile(chunks[chunk_index], tile_index, value);
+        mark_dirty(chunk_index);
+        return true;
+    }
+
+    auto layer::tile_data::find_chunk(math::vector2i chunk_coordinates) const -> packed_chunk const* {
+        auto const it = index.find(get_index_key(chunk_coordinates));
+        return it != index.end() ? &chunks[it->second] : nullptr;
+    }
+
+    auto layer::tile_data::get_tile(math::vector2i tile_position) const -> tile {
+        math::vector2i const chunk_coordinates = get_chunk_coordinates(tile_position);
+        packed_chunk const* const chunk = find_chunk(chunk_coordinates);
+        if(chunk == nullptr) {
+            return tile{tile::id::none};
+        }
+
+        math::vector2i const in_chunk = tile_position - element_multiply(chunk_coordinates, tile_chunk::dimensions);
+        return chunk->tiles->get_tile(static_cast<std::size_t>(in_chunk.y * tile_chunk::dimensions.x + in_chunk.x));
+    }
+
+    auto layer::tile_data::take_dirty_chunks() -> std::vector<math::vector2i> {
+        std::vector<math::vector2i> positions;
+        positions.reserve(dirty_chunks.size());
+        for(std::size_t const chunk_index : dirty_chunks) {
+            positions.push_back(chunks[chunk_index].position);
+            dirty[chunk_index] = false;
+        }
+        dirty_chunks.clear();
+        return positions;
+    }
+
+    auto layer::tile_data::add_chunk(math::vector2i chunk_coordinates) -> std::size_t {
+        auto const [it, added] = index.emplace(get_index_key(chunk_coordinates), chunks.size());
+        if(added) {
+            chunks.push_back({element_multiply(chunk_coordinates, tile_chunk::dimensions), std::make_shared<packed_tiles const>(layout)});
+            dirty.push_back(false);
+        }
+        return it->second;
+    }
+
+    void layer::tile_data::mark_dirty(std::size_t chunk_index) {
+        if(!dirty[chunk_index]) {
+            dirty[chunk_index] = true;
+            dirty_chunks.push_back(chunk_index);
+        }
+    }
+
+    layer::object_data::object_data(std::pmr::memory_resource* memory)
+        : ids(memory)
+        , positions(memory)
+        , dimensions(memory)
+        , kinds(memory)
+        , types(memory)
+        , names(memory)
+        , rotations(memory)
+        , payloads(memory)
+        , polygons(memory)
+        , polylines(memory)
+        , texts(memory)
+        , sprites(memory) {
+    }
+
+    void layer::object_data::reserve(std::size_t count) {
+        ids.reserve(count);
+        positions.reserve(count);
+        dimensions.reserve(count);
+        kinds.reserve(count);
+        types.reserve(count);
+        names.reserve(count);
+        rotations.reserve(count);
+        payloads.reserve(count);
+    }
+
+    void layer::object_data::push_back(object&& value) {
+        ids.push_back(value.id);
+        positions.push_back(value.position);
+        dimensions.push_back(value.dimensions);
+        kinds.push_back(value.get_kind());
+        types.push_back(value.type);
+        names.push_back(value.name);
+        rotations.push_back(value.rotation);
+
+        // Moved rather than copied, so that the payloads keep the memory they were allocated from
+        auto const add_payload = [this] (auto& table, auto&& payload) {
+            payloads.push_back(static_cast<std::uint32_t>(table.size()));
+            table.push_back(std::forward<decltype(payload)>(payload));
+        };
+        if(auto const polygon = std::get_if<polygon_data>(&value.kind_data)) {
+            add_payload(polygons, std::move(*polygon));
+        } else if(auto const polyline = std::get_if<polyline_data>(&value.kind_data)) {
+            add_payload(polylines, std::move(*polyline));
+        } else if(auto const text = std::get_if<text_data>(&value.kind_data)) {
+            add_payload(texts, std::move(*text));
+        } else if(auto const sprite = std::get_if<sprite_data>(&value.kind_data)) {
+            add_payload(sprites, *sprite);
+        } else {
+            payloads.push_back(0);
+        }
+    }
+
+    auto layer::object_data::get_object(std::size_t index) const -> object {
+        object result;
+        result.id = ids[index];
+        result.name = names[index];
+        result.type = types[index];
+        result.rotation = rotations[index];
+        result.dimensions = dimensions[index];
+        result.position = positions[index];
+        switch(kinds[index]) {
+        case object::kind::rectangle:
+            result.kind_data = rectangle_data{};
+            break;
+        case object::kind::point:
+            result.kind_data = point_data{};
+            break;
+        case object::kind::ellipse:
+            result.kind_data = ellipse_data{};
+            break;
+        case object::kind::polygon:
+            result.kind_data = get_polygon(index);
+            break;
+        case object::kind::polyline:
+            result.kind_data = get_polyline(index);
+            break;
+        case object::kind::text:
+            result.kind_data = get_text(index);
+            break;
+        case object::kind::sprite:
+            result.kind_data = get_sprite(index);
+            break;
+        }
+        return result;
+    }
+}
\ No newline at end of file
@@ -1,6 +1,10 @@
 #include "game/map.h"
 
 #include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
 
 #include <stdexcept>
@@ -14,4 +18,179 @@ namespace game {
 		if(it_tileset == map_data.tilesets.rend()) { throw std::runtime_error("Invalid tile id in game::get_tileset"); }
 		return *it_tileset;
 	}
+
+	auto get_tile(map const& map_data, std::size_t layer_index, math::vector2i tile_position) -> tile {
+		auto const tiles = std::get_if<layer::tile_data>(&map_data.layers[layer_index].data);
+		return tiles != nullptr ? tiles->get_tile(tile_position) : tile{tile::id::none};
+	}
+
+	auto get_tile_at_pixel(map const& map_data, std::size_t layer_index, math::vector2i pixel) -> tile {
+		return get_tile(map_data, layer_index, get_tile_position(pixel));
+	}
+
+	auto get_tiles(map const& map_data, math::vector2i tile_position) -> std::vector<layer_tile> {
+		std::vector<layer_tile> result;
+		for(std::size_t layer_index = 0; layer_index < map_data.layers.size(); ++layer_index) {
+			tile const value = get_tile(map_data, layer_index, tile_position);
+			if(value.data != tile::id::none) {
+				result.push_back({layer_index, value});
+			}
+		}
+		return result;
+	}
+
+	auto get_tiles_at_pixel(map const& map_data, math::vector2i pixel) -> std::vector<layer_tile> {
+		return get_tiles(map_data, get_tile_position(pixel));
+	}
+
+	auto find_objects_of_type(map const& map_data, std::string_view type) -> std::vector<object_ref> {
+		std::vector<object_ref> result;
+		std::optional<string_id> const type_id = map_data.strings.find(type);
+		if(!type_id) {
+			return result;
+		}
+
+		for(std::size_t layer_index = 0; layer_index < map_data.layers.size(); ++layer_index) {
+			if(auto const objects = std::get_if<layer::object_data>(&map_data.layers[layer_index].data)) {
+				auto const& types = objects->get_types();
+				for(std::size_t i = 0; i < types.size(); ++i) {
+					if(types[i] == *type_id) {
+						result.push_back({layer_index, i});
+					}
+				}
+			}
+		}
+		return result;
+	}
+
+	auto find_objects_in(map const& map_data, math::vector2i position, math::vector2i size) -> std::vector<object_ref> {
+		std::vector<object_ref> result;
+		math::vector2i const end = position + size;
+		for(std::size_t layer_index = 0; layer_index < map_data.layers.size(); ++layer_index) {
+			if(auto const objects = std::get_if<layer::object_data>(&map_data.layers[layer_index].data)) {
+				auto const& positions = objects->get_positions();
+				auto const& dimensions = objects->get_dimensions();
+				for(std::size_t i = 0; i < positions.size(); ++i) {
+					// Points have no size, so the far edges of the objects are inside their bounds
+					math::vector2i const object_end = positions[i] + dimensions[i];
+					if(positions[i].x < end.x && positions[i].y < end.y && object_end.x >= position.x && object_end.y >= position.y) {
+						result.push_back({layer_index, i});
+					}
+				}
+			}
+		}
+		return result;
+	}
+
+	namespace {
+		auto has_same_structure(map const& lhs, map const& rhs) -> bool {
+			auto const same_layer = [] (layer const& l, layer const& r) {
+				return l.id == r.id && l.get_type() == r.get_type();
+			};
+			auto const same_tileset = [] (tileset const& l, tileset const& r) {
+				return l.source == r.source && l.starting_id == r.starting_id;
+			};
+			return std::equal(lhs.layers.begin(), lhs.layers.end(), rhs.layers.begin(), rhs.layers.end(), same_layer)
+				&& std::equal(lhs.tilesets.begin(), lhs.tilesets.end(), rhs.tilesets.begin(), rhs.tilesets.end(), same_tileset);
+		}
+
+		auto get_position_key(math::vector2i position) noexcept -> std::uint64_t {
+			return std::uint64_t{static_cast<std::uint32_t>(position.x)} << 32 | static_cast<std::uint32_t>(position.y);
+		}
+
+		void update_chunks(std::size_t layer_index, layer::tile_data& tiles, layer::tile_data&& updated_tiles, map_changes& changes) {
+			std::vector<packed_chunk> chunks = tiles.release_chunks();
+			std::vector<packed_chunk> updated = updated_tiles.release_chunks();
+			std::unordered_map<std::uint64_t, packed_chunk*> updated_chunks;
+			updated_chunks.reserve(updated.size());
+			for(packed_chunk& chunk : updated) {
+				updated_chunks.emplace(get_position_key(chunk.position), &chunk);
+			}
+
+			// Removed chunks keep their order, so that the update does not depend on how the chunks were loaded
+			auto const removed = std::stable_partition(chunks.begin(), chunks.end(), [&updated_chunks] (packed_chunk const& chunk) {
+				return updated_chunks.find(get_position_key(chunk.position)) != updated_chunks.end();
+			});
+			for(auto it = removed; it != chunks.end(); ++it) {
+				changes.changed_chunks.emplace_back(layer_index, it->position);
+			}
+			if(removed != chunks.end()) {
+				chunks.erase(removed, chunks.end());
+				changes.chunks_moved = true;
+			}
+
+			for(packed_chunk& chunk : chunks) {
+				auto const it = updated_chunks.find(get_position_key(chunk.position));
+				if(*chunk.tiles != *it->second->tiles) {
+					chunk.tiles = std::move(it->second->tiles);
+					changes.changed_chunks.emplace_back(layer_index, chunk.position);
+				}
+				updated_chunks.erase(it);
+			}
+
+			// Added chunks, in the order of 'updated'
+			for(packed_chunk& chunk : updated) {
+				if(updated_chunks.find(get_position_key(chunk.position)) != updated_chunks.end()) {
+					changes.changed_chunks.emplace_back(layer_index, chunk.position);
+					chunks.push_back(std::move(chunk));
+					changes.chunks_moved = true;
+				}
+			}
+			// The updated map was laid out as it was loaded
+			tiles = layer::tile_data(std::move(chunks), updated_tiles.get_layout());
+		}
+	}
+
+	auto update_map(map& map_data, map&& updated) -> map_changes {
+		map_changes changes;
+		if(!has_same_structure(map_data, updated)) {
+			map_data = std::move(updated);
+			changes.structure_changed = true;
+			return changes;
+		}
+
+		for(std::size_t layer_index = 0; layer_index < map_data.layers.size(); ++layer_index) {
+			layer& current = map_data.layers[layer_index];
+			layer& next = updated.layers[layer_index];
+			if(auto const tiles = std::get_if<layer::tile_data>(&current.data)) {
+				update_chunks(layer_index, *tiles, std::move(std::get<layer::tile_data>(next.data)), changes);
+			} else {
+				// Moved whole rather than assigned, so that the objects keep using the arena of 'updated'
+				current.data.emplace<layer::object_data>(std::move(std::get<layer::object_data>(next.data)));
+			}
+		}
+		// Every object layer was replaced: the objects of 'map_data' now all use the arena and strings of 'updated'
+		map_data.arena = std::move(updated.arena);
+		map_data.strings = std::move(updated.strings);
+		// The objects were replaced: their coordinates are in the tiles of 'updated'
+		map_data.tile_dimensions = updated.tile_dimensions;
+		return changes;
+	}
+
+	auto get_memory_report(map const& map_data) -> std::vector<layer_memory> {
+		std::vector<layer_memory> report;
+		// Shared tiles count once, with the first chunk using them
+		std::unordered_set<packed_tiles const*> counted_tiles;
+		for(std::size_t layer_index = 0; layer_index < map_data.layers.size(); ++layer_index) {
+			auto const tiles = std::get_if<layer::tile_data>(&map_data.layers[layer_index].data);
+			if(tiles == nullptr) {
+				continue;
+			}
+
+			layer_memory memory{layer_index};
+			memory.chunk_count = tiles->get_chunks().size();
+			memory.unpacked_bytes = tiles->get_chunks().size() * sizeof(tile_chunk);
+			for(packed_chunk const& chunk : tiles->get_chunks()) {
+				if(counted_tiles.insert(chunk.tiles.get()).second) {
+					memory.packed_bytes += get_memory_usage(chunk);
+				} else {
+					memory.packed_bytes += sizeof(packed_chunk);
+					++memory.shared_chunks;
+				}
+				++memory.encoding_counts[static_cast<std::size_t>(chunk.tiles->get_encoding())];
+			}
+			report.push_back(memory);
+		}
+		return report;
+	}
 }
\ No newline at end of file
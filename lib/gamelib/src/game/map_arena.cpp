@@ -0,0 +1,39 @@
+#include "game/map_arena.h"
+
+#include <mutex>
+#include <utility>
+
+namespace game {
+    class map_arena::resource final : public std::pmr::memory_resource {
+    private:
+        std::mutex mutex;
+        std::pmr::monotonic_buffer_resource buffer{4096};
+
+        auto do_allocate(std::size_t bytes, std::size_t alignment) -> void* override {
+            std::lock_guard const lock(mutex);
+            return buffer.allocate(bytes, alignment);
+        }
+        // Released with the arena
+        void do_deallocate(void*, std::size_t, std::size_t) override {}
+        auto do_is_equal(std::pmr::memory_resource const& other) const noexcept -> bool override {
+            return this == &other;
+        }
+    };
+
+    map_arena::map_arena() noexcept = default;
+    map_arena::map_arena(map_arena const&) noexcept {}
+    map_arena::map_arena(map_arena&& other) noexcept = default;
+    map_arena::~map_arena() = default;
+
+    auto map_arena::operator=(map_arena&& other) noexcept -> map_arena& {
+        std::swap(memory, other.memory);
+        return *this;
+    }
+
+    auto map_arena::get() -> std::pmr::memory_resource* {
+        if(!memory) {
+            memory = std::make_unique<resource>();
+        }
+        return memory.get();
+    }
+}
\ No newline at end of file
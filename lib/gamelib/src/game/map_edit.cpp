@@ -0,0 +1,122 @@
+#include "game/map_edit.h"
+
+#include "game/region.h"
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <variant>
+
+namespace game {
+    namespace {
+        // Calls 'write' with the tiles of each chunk overlapping 'region', decoded, and the part of the region in the chunk,
+        // then sets the chunks whose tiles changed. Chunks the region covers whole get 'covered_tiles' instead, if not null.
+        // Returns whether any chunk changed
+        template<typename F>
+        auto edit_chunks(layer::tile_data& tiles, tile_rect region, std::shared_ptr<packed_tiles const> const& covered_tiles, F&& write) -> bool {
+            if(region.size.x <= 0 || region.size.y <= 0) {
+                return false;
+            }
+
+            math::vector2i const first_tile = region.position;
+            math::vector2i const last_tile = region.position + region.size;
+            math::vector2i const first_chunk = get_chunk_coordinates(first_tile);
+            math::vector2i const last_chunk = get_chunk_coordinates(last_tile - math::vector2i{1, 1}) + math::vector2i{1, 1};
+            std::array<tile, tile_chunk::tile_count> chunk_tiles;
+            bool changed = false;
+            for(math::vector2i chunk_coordinates = first_chunk; chunk_coordinates.y < last_chunk.y; ++chunk_coordinates.y) {
+                for(chunk_coordinates.x = first_chunk.x; chunk_coordinates.x < last_chunk.x; ++chunk_coordinates.x) {
+                    math::vector2i const origin = element_multiply(chunk_coordinates, tile_chunk::dimensions);
+                    math::vector2i const first{std::max(first_tile.x, origin.x), std::max(first_tile.y, origin.y)};
+                    math::vector2i const last{std::min(last_tile.x, origin.x + tile_chunk::dimensions.x), std::min(last_tile.y, origin.y + tile_chunk::dimensions.y)};
+                    packed_chunk const* const chunk = tiles.find_chunk(chunk_coordinates);
+
+                    std::shared_ptr<packed_tiles const> written;
+                    if(covered_tiles && last - first == tile_chunk::dimensions) {
+                        written = covered_tiles;
+                    } else {
+                        if(chunk != nullptr) {
+                            chunk->tiles->decode(chunk_tiles.data());
+                        } else {
+                            chunk_tiles.fill(tile{tile::id::none});
+                        }
+                        write(chunk_tiles.data(), origin, tile_rect{first, last - first});
+                        written = std::make_shared<packed_tiles const>(chunk_tiles.data(), chunk != nullptr ? chunk->tiles->get_layout() : tiles.get_layout());
+                    }
+
+                    if(chunk != nullptr ? *written != *chunk->tiles : !written->is_empty()) {
+                        tiles.set_chunk_tiles(chunk_coordinates, std::move(written));
+                        changed = true;
+                    }
+                }
+            }
+            return changed;
+        }
+
+        auto get_row(tile* chunk_tiles, math::vector2i origin, math::vector2i position) noexcept -> tile* {
+            return chunk_tiles + (position.y - origin.y) * tile_chunk::dimensions.x + (position.x - origin.x);
+        }
+    }
+
+    auto set_tile(map& map_data, std::size_t layer_index, math::vector2i tile_position, tile value) -> bool {
+        if(!std::get<layer::tile_data>(map_data.layers[layer_index].data).set_tile(tile_position, value)) {
+            return false;
+        }
+        map_data.edit_journal.push_back({layer_index, {tile_position, {1, 1}}});
+        return true;
+    }
+
+    void fill_rect(map& map_data, std::size_t layer_index, tile_rect region, tile value) {
+        auto& tiles = std::get<layer::tile_data>(map_data.layers[layer_index].data);
+        tile_chunk filled{};
+        filled.tiles.fill(value);
+        auto const covered_tiles = std::make_shared<packed_tiles const>(filled.tiles.data(), tiles.get_layout());
+
+        bool const changed = edit_chunks(tiles, region, covered_tiles, [value] (tile* chunk_tiles, math::vector2i origin, tile_rect part) {
+            for(int y = part.position.y; y < part.position.y + part.size.y; ++y) {
+                std::fill_n(get_row(chunk_tiles, origin, {part.position.x, y}), part.size.x, value);
+            }
+        });
+        if(changed) {
+            map_data.edit_journal.push_back({layer_index, region});
+        }
+    }
+
+    void copy_region(map& map_data, std::size_t source_layer_index, tile_rect source, std::size_t destination_layer_index, math::vector2i destination) {
+        if(source.size.x <= 0 || source.size.y <= 0) {
+            return;
+        }
+
+        // The source is read whole first, so that it can overlap the destination
+        std::vector<tile> copied(static_cast<std::size_t>(source.size.x) * static_cast<std::size_t>(source.size.y), tile{tile::id::none});
+        for(tile_span const span : region_view(std::get<layer::tile_data>(map_data.layers[source_layer_index].data), source)) {
+            math::vector2i const offset = span.position - source.position;
+            std::copy(span.begin(), span.end(), copied.begin() + offset.y * source.size.x + offset.x);
+        }
+
+        auto& tiles = std::get<layer::tile_data>(map_data.layers[destination_layer_index].data);
+        tile_rect const region{destination, source.size};
+        bool const changed = edit_chunks(tiles, region, nullptr, [&copied, &region] (tile* chunk_tiles, math::vector2i origin, tile_rect part) {
+            for(int y = part.position.y; y < part.position.y + part.size.y; ++y) {
+                math::vector2i const offset = math::vector2i{part.position.x, y} - region.position;
+                std::copy_n(copied.data() + offset.y * region.size.x + offset.x, part.size.x, get_row(chunk_tiles, origin, {part.position.x, y}));
+            }
+        });
+        if(changed) {
+            map_data.edit_journal.push_back({destination_layer_index, region});
+        }
+    }
+
+    auto drain_edits(map& map_data) -> map_edits {
+        map_edits edits;
+        for(std::size_t layer_index = 0; layer_index < map_data.layers.size(); ++layer_index) {
+            if(auto const tiles = std::get_if<layer::tile_data>(&map_data.layers[layer_index].data)) {
+                for(math::vector2i const position : tiles->take_dirty_chunks()) {
+                    edits.changed_chunks.emplace_back(layer_index, position);
+                }
+            }
+        }
+        edits.changes = std::exchange(map_data.edit_journal, {});
+        return edits;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,51 @@
+#include "game/map_layout.h"
+
+#include "math/space_filling_curve.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+
+namespace game {
+    void sort_chunks_along_hilbert_curve(std::vector<packed_chunk>& chunks) {
+        // Computed once per chunk rather than at each comparison
+        std::vector<std::pair<std::uint64_t, packed_chunk>> keyed;
+        keyed.reserve(chunks.size());
+        for(packed_chunk& chunk : chunks) {
+            keyed.emplace_back(math::get_hilbert_index(get_chunk_coordinates(chunk.position)), std::move(chunk));
+        }
+        std::stable_sort(keyed.begin(), keyed.end(), [] (auto const& lhs, auto const& rhs) { return lhs.first < rhs.first; });
+        for(std::size_t i = 0; i < chunks.size(); ++i) {
+            chunks[i] = std::move(keyed[i].second);
+        }
+    }
+
+    void set_layout(map& map_data, map_layout layout) {
+        // Tiles already repacked, by the tiles they replace. Those are kept alive until the end, so that their address is not reused
+        std::unordered_map<packed_tiles const*, std::pair<std::shared_ptr<packed_tiles const>, std::shared_ptr<packed_tiles const>>> repacked;
+        tile_chunk unpacked{};
+        for(layer& l : map_data.layers) {
+            auto const tiles = std::get_if<layer::tile_data>(&l.data);
+            if(tiles == nullptr) {
+                continue;
+            }
+
+            std::vector<packed_chunk> chunks = tiles->release_chunks();
+            if(layout.hilbert_chunk_order) {
+                sort_chunks_along_hilbert_curve(chunks);
+            }
+            for(packed_chunk& chunk : chunks) {
+                auto const [it, added] = repacked.try_emplace(chunk.tiles.get());
+                if(added) {
+                    chunk.tiles->decode(unpacked.tiles.data());
+                    it->second = {chunk.tiles, std::make_shared<packed_tiles const>(unpacked.tiles.data(), layout.tiles)};
+                }
+                chunk.tiles = it->second.second;
+            }
+            *tiles = layer::tile_data(std::move(chunks), layout.tiles);
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,273 @@
+#include "game/packed_chunk.h"
+
+#include "math/space_filling_curve.h"
+
+#include <algorithm>
+#include <array>
+
+namespace game {
+    namespace {
+        constexpr std::size_t max_run_bytes = tile_chunk::tile_count / 2;
+        // A byte of palette index, then the index of the tile after the run on two bytes, low byte first
+        constexpr std::size_t run_bytes = 3;
+        static_assert(tile_chunk::tile_count <= 0xFFFF, "Run ends are stored on two bytes");
+
+        auto get_run_end(std::uint8_t const* run) noexcept -> std::size_t {
+            return std::size_t{run[1]} | std::size_t{run[2]} << 8;
+        }
+
+        // Z-order index of each tile, by row major index
+        constexpr auto make_z_order_indices() noexcept -> std::array<std::uint16_t, tile_chunk::tile_count> {
+            std::array<std::uint16_t, tile_chunk::tile_count> indices{};
+            for(std::size_t i = 0; i < tile_chunk::tile_count; ++i) {
+                math::vector2i const offset{static_cast<int>(i) % tile_chunk::dimensions.x, static_cast<int>(i) / tile_chunk::dimensions.x};
+                indices[i] = static_cast<std::uint16_t>(math::get_z_order_index(offset));
+            }
+            return indices;
+        }
+
+        constexpr auto z_order_indices = make_z_order_indices();
+
+        // FNV-1a, over the encoding and layout and then each tile
+        auto hash_tiles(packed_tiles::encoding type, tile_layout layout, std::vector<tile> const& palette, std::vector<std::uint8_t> const& indices) noexcept -> std::size_t {
+            std::uint64_t hash = 0xCBF29CE484222325ull;
+            auto const add = [&hash] (std::uint32_t value) {
+                hash = (hash ^ value) * 0x100000001B3ull;
+            };
+            add(static_cast<std::uint32_t>(type));
+            add(static_cast<std::uint32_t>(layout));
+            for(tile const t : palette) {
+                add(static_cast<std::uint32_t>(t.data));
+            }
+            for(std::uint8_t const index : indices) {
+                add(index);
+            }
+            return static_cast<std::size_t>(hash);
+        }
+    }
+
+    packed_tiles::packed_tiles()
+        : packed_tiles(tile_layout::row_major) {
+    }
+
+    packed_tiles::packed_tiles(tile_layout layout)
+        : type(encoding::uniform)
+        , layout(layout)
+        , palette{tile{tile::id::none}} {
+        hash = hash_tiles(type, layout, palette, indices);
+    }
+
+    packed_tiles::packed_tiles(tile const* tiles, tile_layout layout)
+        : layout(layout) {
+        if(layout == tile_layout::z_order) {
+            tile ordered[tile_chunk::tile_count];
+            for(std::size_t i = 0; i < tile_chunk::tile_count; ++i) {
+                ordered[z_order_indices[i]] = tiles[i];
+            }
+            encode(ordered);
+        } else {
+            encode(tiles);
+        }
+        hash = hash_tiles(type, layout, palette, indices);
+    }
+
+    void packed_tiles::encode(tile const* tiles) {
+        std::uint8_t palette_indices[tile_chunk::tile_count];
+        std::size_t run_count = 0;
+        for(std::size_t i = 0; i < tile_chunk::tile_count; ++i) {
+            if(i != 0 && tiles[i].data == tiles[i - 1].data) {
+                palette_indices[i] = palette_indices[i - 1];
+                continue;
+            }
+
+            ++run_count;
+            auto const it = std::find_if(palette.begin(), palette.end(), [t = tiles[i]] (tile p) { return p.data == t.data; });
+            if(it == palette.end() && palette.size() == max_palette_size) {
+                type = encoding::raw;
+                palette.assign(tiles, tiles + tile_chunk::tile_count);
+                return;
+            }
+            palette_indices[i] = static_cast<std::uint8_t>(it - palette.begin());
+            if(it == palette.end()) {
+                palette.push_back(tiles[i]);
+            }
+        }
+        palette.shrink_to_fit();
+
+        if(palette.size() == 1) {
+            type = encoding::uniform;
+        } else if(run_count * run_bytes < max_run_bytes) {
+            type = encoding::palette_runs;
+            indices.reserve(run_count * run_bytes);
+            for(std::size_t first = 0; first < tile_chunk::tile_count;) {
+                std::size_t last = first + 1;
+                while(last < tile_chunk::tile_count && palette_indices[last] == palette_indices[first]) {
+                    ++last;
+                }
+                indices.push_back(palette_indices[first]);
+                indices.push_back(static_cast<std::uint8_t>(last & 0xFF));
+                indices.push_back(static_cast<std::uint8_t>(last >> 8));
+                first = last;
+            }
+        } else {
+            type = encoding::palette;
+            indices.resize(tile_chunk::tile_count / 2);
+            for(std::size_t i = 0; i < indices.size(); ++i) {
+                indices[i] = static_cast<std::uint8_t>(palette_indices[2 * i] | palette_indices[2 * i + 1] << 4);
+            }
+        }
+    }
+
+    auto packed_tiles::is_empty() const noexcept -> bool {
+        return type == encoding::uniform && palette[0].data == tile::id::none;
+    }
+
+    auto packed_tiles::get_tile(std::size_t index) const noexcept -> tile {
+        if(layout == tile_layout::z_order) {
+            index = z_order_indices[index];
+        }
+
+        switch(type) {
+        case encoding::uniform:
+            return palette[0];
+        case encoding::palette:
+            return palette[indices[index / 2] >> (index % 2 * 4) & 0xF];
+        case encoding::palette_runs: {
+            // Binary search for the first run ending after the tile
+            std::size_t first = 0;
+            std::size_t count = indices.size() / run_bytes;
+            while(count > 0) {
+                std::size_t const half = count / 2;
+                if(get_run_end(&indices[(first + half) * run_bytes]) <= index) {
+                    first += half + 1;
+                    count -= half + 1;
+                } else {
+                    count = half;
+                }
+            }
+            return palette[indices[first * run_bytes]];
+        }
+        default:
+            return palette[index];
+        }
+    }
+
+    void packed_tiles::decode(tile* tiles) const noexcept {
+        // Uniform tiles are the same in every layout
+        if(layout == tile_layout::z_order && type != encoding::uniform) {
+            tile ordered[tile_chunk::tile_count];
+            decode_in_layout(ordered);
+            for(std::size_t i = 0; i < tile_chunk::tile_count; ++i) {
+                tiles[i] = ordered[z_order_indices[i]];
+            }
+        } else {
+            decode_in_layout(tiles);
+        }
+    }
+
+    void packed_tiles::decode_in_layout(tile* tiles) const noexcept {
+        switch(type) {
+        case encoding::uniform:
+            std::fill_n(tiles, tile_chunk::tile_count, palette[0]);
+            break;
+        case encoding::palette:
+            for(std::uint8_t const pair : indices) {
+                *tiles++ = palette[pair & 0xF];
+                *tiles++ = palette[pair >> 4];
+            }
+            break;
+        case encoding::palette_runs: {
+            std::size_t begin = 0;
+            for(std::size_t run = 0; run < indices.size(); run += run_bytes) {
+                std::size_t const end = get_run_end(&indices[run]);
+                std::fill(tiles + begin, tiles + end, palette[indices[run]]);
+                begin = end;
+            }
+            break;
+        }
+        default:
+            std::copy(palette.begin(), palette.end(), tiles);
+            break;
+        }
+    }
+
+    auto packed_tiles::get_allocated_bytes() const noexcept -> std::size_t {
+        return palette.capacity() * sizeof(tile) + indices.capacity();
+    }
+
+    auto packed_tiles::operator==(packed_tiles const& other) const noexcept -> bool {
+        return hash == other.hash && type == other.type && layout == other.layout && indices == other.indices
+            && std::equal(palette.begin(), palette.end(), other.palette.begin(), other.palette.end(), [] (tile l, tile r) { return l.data == r.data; });
+    }
+
+    auto get_memory_usage(packed_chunk const& chunk) noexcept -> std::size_t {
+        return sizeof(packed_chunk) + sizeof(packed_tiles) + chunk.tiles->get_allocated_bytes();
+    }
+
+    auto pack_chunk(tile_chunk const& chunk) -> packed_chunk {
+        return {chunk.position, std::make_shared<packed_tiles const>(chunk.tiles.data())};
+    }
+
+    auto unpack_chunk(packed_chunk const& chunk) -> tile_chunk {
+        tile_chunk result{chunk.position, {}};
+        chunk.tiles->decode(result.tiles.data());
+        return result;
+    }
+
+    void set_tile(packed_chunk& chunk, std::size_t index, tile value) {
+        if(chunk.tiles->get_tile(index).data == value.data) {
+            return;
+        }
+
+        tile_chunk unpacked = unpack_chunk(chunk);
+        unpacked.tiles[index] = value;
+        chunk.tiles = std::make_shared<packed_tiles const>(unpacked.tiles.data(), chunk.tiles->get_layout());
+    }
+
+    void merge_tiles(packed_chunk& chunk, packed_tiles const& other) {
+        tile_chunk merged = unpack_chunk(chunk);
+        std::array<tile, tile_chunk::tile_count> overlay;
+        other.decode(overlay.data());
+        bool changed = false;
+        for(std::size_t i = 0; i < tile_chunk::tile_count; ++i) {
+            if(overlay[i].data != tile::id::none && overlay[i].data != merged.tiles[i].data) {
+                merged.tiles[i] = overlay[i];
+                changed = true;
+            }
+        }
+        if(changed) {
+            chunk.tiles = std::make_shared<packed_tiles const>(merged.tiles.data(), chunk.tiles->get_layout());
+        }
+    }
+
+    void pack_region(tile_rect region, tile const* tiles, std::vector<packed_chunk>& chunks) {
+        math::vector2i const region_end = region.position + region.size;
+        math::vector2i const first = get_chunk_coordinates(region.position);
+        math::vector2i const last = get_chunk_coordinates(region_end - math::vector2i{1, 1});
+        if(region.size == tile_chunk::dimensions && element_multiply(first, tile_chunk::dimensions) == region.position) {
+            chunks.push_back({region.position, std::make_shared<packed_tiles const>(tiles)});
+            return;
+        }
+
+        tile_chunk chunk;
+        for(int y = first.y; y <= last.y; ++y) {
+            for(int x = first.x; x <= last.x; ++x) {
+                chunk.position = element_multiply(math::vector2i{x, y}, tile_chunk::dimensions);
+                chunk.tiles.fill(tile{tile::id::none});
+
+                // Overlap of the chunk and the region, copied row by row
+                math::vector2i const from{std::max(chunk.position.x, region.position.x), std::max(chunk.position.y, region.position.y)};
+                math::vector2i const to{std::min(chunk.position.x + tile_chunk::dimensions.x, region_end.x), std::min(chunk.position.y + tile_chunk::dimensions.y, region_end.y)};
+                for(int row = from.y; row < to.y; ++row) {
+                    std::copy_n(tiles + (row - region.position.y) * region.size.x + (from.x - region.position.x), to.x - from.x,
+                        chunk.tiles.data() + (row - chunk.position.y) * tile_chunk::dimensions.x + (from.x - chunk.position.x));
+                }
+                chunks.push_back(pack_chunk(chunk));
+            }
+        }
+    }
+
+    void erase_empty_chunks(std::vector<packed_chunk>& chunks) {
+        chunks.erase(std::remove_if(chunks.begin(), chunks.end(), [] (packed_chunk const& chunk) { return chunk.tiles->is_empty(); }), chunks.end());
+    }
+}
\ No newline at end of file
@@ -0,0 +1,93 @@
+#include "game/region.h"
+
+#include <algorithm>
+#include <memory>
+
+namespace game {
+    template<bool Mutable>
+    basic_region_view<Mutable>::basic_region_view(tile_data_type& tiles, tile_rect region)
+        : tiles(&tiles)
+        , first_tile(region.position)
+        , last_tile(region.position + region.size) {
+        if(region.size.x <= 0 || region.size.y <= 0) {
+            return;
+        }
+
+        first_chunk = get_chunk_coordinates(first_tile);
+        last_chunk = get_chunk_coordinates(last_tile - math::vector2i{1, 1}) + math::vector2i{1, 1};
+        chunk_coordinates = first_chunk;
+        find_chunk();
+    }
+
+    template<bool Mutable>
+    basic_region_view<Mutable>::~basic_region_view() {
+        // The walk was left before its end
+        write_back();
+    }
+
+    template<bool Mutable>
+    auto basic_region_view<Mutable>::get_span() noexcept -> span_type {
+        math::vector2i const origin = element_multiply(chunk_coordinates, tile_chunk::dimensions);
+        auto const first = chunk_tiles.data() + (row - origin.y) * tile_chunk::dimensions.x + (row_first_x - origin.x);
+        return {{row_first_x, row}, first, first + (row_last_x - row_first_x)};
+    }
+
+    template<bool Mutable>
+    void basic_region_view<Mutable>::next_row() {
+        if(++row < last_row) {
+            return;
+        }
+
+        write_back();
+        if(++chunk_coordinates.x == last_chunk.x) {
+            chunk_coordinates.x = first_chunk.x;
+            ++chunk_coordinates.y;
+        }
+        find_chunk();
+    }
+
+    template<bool Mutable>
+    void basic_region_view<Mutable>::find_chunk() {
+        for(; chunk_coordinates.y < last_chunk.y; ++chunk_coordinates.y, chunk_coordinates.x = first_chunk.x) {
+            for(; chunk_coordinates.x < last_chunk.x; ++chunk_coordinates.x) {
+                packed_chunk const* const found = tiles->find_chunk(chunk_coordinates);
+                if(found == nullptr || found->tiles->is_empty()) {
+                    continue;
+                }
+
+                chunk = found;
+                math::vector2i const origin = element_multiply(chunk_coordinates, tile_chunk::dimensions);
+                row = std::max(first_tile.y, origin.y);
+                last_row = std::min(last_tile.y, origin.y + tile_chunk::dimensions.y);
+                row_first_x = std::max(first_tile.x, origin.x);
+                row_last_x = std::min(last_tile.x, origin.x + tile_chunk::dimensions.x);
+                if(decoded != chunk->tiles.get()) {
+                    chunk->tiles->decode(chunk_tiles.data());
+                    decoded = chunk->tiles.get();
+                }
+                return;
+            }
+        }
+        chunk = nullptr;
+    }
+
+    template<bool Mutable>
+    void basic_region_view<Mutable>::write_back() {
+        if constexpr(Mutable) {
+            if(chunk == nullptr) {
+                return;
+            }
+
+            auto written = std::make_shared<packed_tiles const>(chunk_tiles.data(), chunk->tiles->get_layout());
+            if(*written != *chunk->tiles) {
+                tiles->set_chunk_tiles(chunk_coordinates, std::move(written));
+                // The tiles left to other chunks sharing them are not those decoded anymore
+                decoded = nullptr;
+            }
+            chunk = nullptr;
+        }
+    }
+
+    template class basic_region_view<false>;
+    template class basic_region_view<true>;
+}
\ No newline at end of file
@@ -0,0 +1,66 @@
+#include "game/string_pool.h"
+
+#include <utility>
+
+namespace game {
+    string_pool::string_pool() {
+        reset();
+    }
+
+    // The keys are views of the strings of their pool, so they are rebuilt rather than copied
+    string_pool::string_pool(string_pool const& other)
+        : strings(other.strings) {
+        ids.reserve(strings.size());
+        for(std::size_t i = 0; i < strings.size(); ++i) {
+            ids.emplace(strings[i], static_cast<string_id>(i));
+        }
+    }
+
+    // Moving a deque keeps its elements in place, so the keys still view them. The moved-from pool is left as a new one
+    string_pool::string_pool(string_pool&& other) noexcept
+        : strings(std::move(other.strings))
+        , ids(std::move(other.ids)) {
+        other.reset();
+    }
+
+    auto string_pool::operator=(string_pool const& other) -> string_pool& {
+        if(this != &other) {
+            *this = string_pool(other);
+        }
+        return *this;
+    }
+
+    auto string_pool::operator=(string_pool&& other) noexcept -> string_pool& {
+        if(this != &other) {
+            strings = std::move(other.strings);
+            ids = std::move(other.ids);
+            other.reset();
+        }
+        return *this;
+    }
+
+    auto string_pool::intern(std::string_view value) -> string_id {
+        std::lock_guard const lock(mutex);
+        if(auto const it = ids.find(value); it != ids.end()) {
+            return it->second;
+        }
+        auto const id = static_cast<string_id>(strings.size());
+        strings.emplace_back(value);
+        ids.emplace(strings.back(), id);
+        return id;
+    }
+
+    auto string_pool::find(std::string_view value) const -> std::optional<string_id> {
+        if(auto const it = ids.find(value); it != ids.end()) {
+            return it->second;
+        }
+        return std::nullopt;
+    }
+
+    void string_pool::reset() {
+        ids.clear();
+        strings.clear();
+        strings.emplace_back();
+        ids.emplace(strings.back(), string_id::empty);
+    }
+}
\ No newline at end of file
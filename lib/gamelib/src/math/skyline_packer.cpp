@@ -0,0 +1,81 @@
+#include "math/skyline_packer.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace math {
+    skyline_packer::skyline_packer(vector2i dimensions)
+        : dimensions(dimensions)
+        , skyline{{0, 0, dimensions.x}} {
+
+    }
+
+    auto skyline_packer::fit(std::size_t index, vector2i size) const -> std::optional<int> {
+        if(skyline[index].x + size.x > dimensions.x) {
+            return std::nullopt;
+        }
+
+        int y = 0;
+        for(int width_left = size.x; width_left > 0; ++index) {
+            y = std::max(y, skyline[index].y);
+            if(y + size.y > dimensions.y) {
+                return std::nullopt;
+            }
+            width_left -= skyline[index].width;
+        }
+        return y;
+    }
+
+    auto skyline_packer::insert(vector2i size) -> std::optional<vector2i> {
+        if(size.x <= 0 || size.y <= 0) {
+            return std::nullopt;
+        }
+
+        std::size_t best_index = skyline.size();
+        int best_bottom = std::numeric_limits<int>::max();
+        int best_width = std::numeric_limits<int>::max();
+        int best_y = 0;
+        for(std::size_t i = 0; i < skyline.size(); ++i) {
+            auto const y = fit(i, size);
+            // Ties go to the narrowest segment, which leaves the wide ones for wide rectangles
+            if(y && (*y + size.y < best_bottom || (*y + size.y == best_bottom && skyline[i].width < best_width))) {
+                best_index = i;
+                best_bottom = *y + size.y;
+                best_width = skyline[i].width;
+                best_y = *y;
+            }
+        }
+
+        if(best_index == skyline.size()) {
+            return std::nullopt;
+        }
+
+        vector2i const position{skyline[best_index].x, best_y};
+        skyline.insert(skyline.begin() + best_index, segment{position.x, best_bottom, size.x});
+
+        // Segments now under the rectangle are shortened or removed
+        int const right = position.x + size.x;
+        for(std::size_t i = best_index + 1; i < skyline.size() && skyline[i].x < right; ) {
+            int const overlap = right - skyline[i].x;
+            if(overlap >= skyline[i].width) {
+                skyline.erase(skyline.begin() + i);
+            } else {
+                skyline[i].x += overlap;
+                skyline[i].width -= overlap;
+                break;
+            }
+        }
+
+        // Neighbours at the same height become a single segment
+        for(std::size_t i = 0; i + 1 < skyline.size(); ) {
+            if(skyline[i].y == skyline[i + 1].y) {
+                skyline[i].width += skyline[i + 1].width;
+                skyline.erase(skyline.begin() + i + 1);
+            } else {
+                ++i;
+            }
+        }
+
+        return position;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,98 @@
+#include "chunk_cache.h"
+
+#include "sdl/macro.h"
+
+#include <SDL_render.h>
+
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+	constexpr math::vector2i texture_dimensions{
+		game::tile_chunk::dimensions.x * game::tile::dimensions.x,
+		game::tile_chunk::dimensions.y * game::tile::dimensions.y
+	};
+	constexpr std::size_t texture_bytes = static_cast<std::size_t>(texture_dimensions.x) * texture_dimensions.y * 4;
+
+	// Tiles drawn over a transparent target leave premultiplied colors, which must not be multiplied by their alpha again
+	auto get_premultiplied_blend_mode() -> SDL_BlendMode {
+		return SDL_ComposeCustomBlendMode(SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD,
+		                                  SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD);
+	}
+}
+
+chunk_cache::chunk_cache(SDL_Renderer& renderer, std::size_t memory_budget)
+	: renderer(&renderer)
+	, memory_budget(memory_budget)
+	, enabled(memory_budget >= texture_bytes && SDL_RenderTargetSupported(&renderer)) {
+
+}
+
+auto chunk_cache::find(chunk_key key) -> SDL_Texture* {
+	auto const it = entries.find(key);
+	if(it == entries.end()) {
+		return nullptr;
+	}
+
+	++cache_stats.hits;
+	it->second.last_drawn_frame = frame;
+	lru.splice(lru.begin(), lru, it->second.lru_position);
+	return it->second.texture.get_texture();
+}
+
+auto chunk_cache::begin_render(std::shared_ptr<game::packed_tiles const> const& tiles) -> SDL_Texture* {
+	if(!enabled || !make_room()) {
+		return nullptr;
+	}
+
+	SDL_Texture* const texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, texture_dimensions.x, texture_dimensions.y);
+	if(texture == nullptr) {
+		// Out of video memory: the chunks are drawn tile by tile until the cache is cleared
+		enabled = false;
+		return nullptr;
+	}
+
+	if(SDL_SetTextureBlendMode(texture, get_premultiplied_blend_mode()) < 0) {
+		KT_SDL_ENSURE(SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND));
+	}
+
+	++cache_stats.misses;
+	lru.push_front(tiles.get());
+	entries.emplace(tiles.get(), entry{tiles, sdl::texture(texture), lru.begin(), frame});
+	cache_stats.cached_chunks = entries.size();
+	cache_stats.cached_bytes += texture_bytes;
+
+	KT_SDL_ENSURE(SDL_SetRenderTarget(renderer, texture));
+	KT_SDL_ENSURE(SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0));
+	KT_SDL_ENSURE(SDL_RenderClear(renderer));
+	return texture;
+}
+
+void chunk_cache::end_render() {
+	KT_SDL_ENSURE(SDL_SetRenderTarget(renderer, nullptr));
+	// Back to the color the screen is cleared with
+	KT_SDL_ENSURE(SDL_SetRenderDrawColor(renderer, 0, 0, 0, SDL_ALPHA_OPAQUE));
+}
+
+auto chunk_cache::make_room() -> bool {
+	while(cache_stats.cached_bytes + texture_bytes > memory_budget) {
+		if(lru.empty() || entries.find(lru.back())->second.last_drawn_frame == frame) {
+			// Every cached chunk is on screen
+			return false;
+		}
+
+		entries.erase(lru.back());
+		lru.pop_back();
+		cache_stats.cached_bytes -= texture_bytes;
+		++cache_stats.evictions;
+	}
+	cache_stats.cached_chunks = entries.size();
+	return true;
+}
+
+void chunk_cache::clear() {
+	entries.clear();
+	lru.clear();
+	cache_stats = {};
+	enabled = memory_budget >= texture_bytes && SDL_RenderTargetSupported(renderer);
+}
\ No newline at end of file
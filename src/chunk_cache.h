@@ -0,0 +1,82 @@
+#pragma once
+
+#include "game/packed_chunk.h"
+#include "sdl/texture.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <unordered_map>
+
+struct SDL_Renderer;
+
+// Tile chunks rendered once to target textures, so that drawing a whole chunk takes a single copy.
+// Entries are keyed by the shared tiles of the chunks, so that identical chunks share a texture, and a chunk whose tiles change
+// gets a new one. They must be cleared when the tileset textures change
+class chunk_cache {
+public:
+	struct stats {
+		std::size_t cached_chunks = 0;
+		std::size_t cached_bytes = 0;
+		// Since the last clear
+		std::size_t hits = 0;
+		std::size_t misses = 0;
+		std::size_t evictions = 0;
+	};
+
+	// Textures over 'memory_budget' bytes are evicted least recently drawn first. A budget of 0, or a renderer without
+	// target textures, disables the cache
+	chunk_cache(SDL_Renderer& renderer, std::size_t memory_budget);
+
+	auto is_enabled() const noexcept -> bool { return enabled; }
+
+	// Chunks drawn during a frame are not evicted before the next one
+	void begin_frame() noexcept { ++frame; }
+
+	// Texture holding the tiles of a chunk. On a miss, 'render_tiles' is called to draw them with the texture as render target,
+	// the chunk's top left corner at the origin. Returns nullptr if the chunk cannot be cached: the caller then draws it directly
+	template<typename F>
+	auto get_texture(std::shared_ptr<game::packed_tiles const> const& tiles, F&& render_tiles) -> SDL_Texture* {
+		if(SDL_Texture* const texture = find(tiles.get())) {
+			return texture;
+		}
+
+		SDL_Texture* const texture = begin_render(tiles);
+		if(texture != nullptr) {
+			render_tiles();
+			end_render();
+		}
+		return texture;
+	}
+
+	// For every change of map or tileset texture, and when the renderer loses its target textures
+	void clear();
+
+	auto get_stats() const noexcept -> stats { return cache_stats; }
+
+private:
+	// Tiles are kept alive by their entry, so that their address is not reused for other tiles while it is a key
+	using chunk_key = game::packed_tiles const*;
+
+	struct entry {
+		std::shared_ptr<game::packed_tiles const> tiles;
+		sdl::texture texture;
+		std::list<chunk_key>::iterator lru_position;
+		std::uint64_t last_drawn_frame;
+	};
+
+	SDL_Renderer* renderer;
+	std::size_t memory_budget;
+	bool enabled;
+	std::uint64_t frame = 0;
+	std::unordered_map<chunk_key, entry> entries;
+	// Most recently drawn first
+	std::list<chunk_key> lru;
+	stats cache_stats;
+
+	auto find(chunk_key key) -> SDL_Texture*;
+	auto begin_render(std::shared_ptr<game::packed_tiles const> const& tiles) -> SDL_Texture*;
+	void end_render();
+	auto make_room() -> bool;
+};
\ No newline at end of file
@@ -1,5 +1,9 @@
 #include "game_data.h"
 
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
 #include <filesystem>
 #include <string_view>
 #include <fstream>
@@ -15,21 +19,90 @@
 #include "sdl/resource.h"
 #include "sdl/macro.h"
 #include "serial/tiled.h"
-
-#include "algorithm_extra.h"
+#include "game/map_layout.h"
 
 namespace {
 	constexpr std::string_view resource_section = "resource";
 	constexpr std::string_view path_key = "path";
+	constexpr std::string_view tileset_cache_key = "tileset_cache";
 
 	constexpr std::string_view game_section = "game";
 	constexpr std::string_view default_map_key = "default_map";
+	constexpr std::string_view tile_layout_key = "tile_layout";
+	constexpr std::string_view chunk_order_key = "chunk_order";
+
+	constexpr std::string_view stream_section = "stream";
+	constexpr std::string_view chunk_memory_budget_key = "chunk_memory_budget_kb";
+	constexpr std::string_view prefetch_chunks_key = "prefetch_chunks";
+
+	constexpr std::string_view render_section = "render";
+	constexpr std::string_view chunk_cache_key = "chunk_cache_kb";
 
 	auto get_resource_path(config_args const& cfg) -> std::filesystem::path {
 		auto const path = cfg.get_value(resource_section, path_key).value_or("res");
 		return {path.begin(), path.end()};
 	}
 
+	auto get_tileset_cache_path(config_args const& cfg) -> std::filesystem::path {
+		auto const path = cfg.get_value(resource_section, tileset_cache_key).value_or("tileset_cache.txt");
+		return {path.begin(), path.end()};
+	}
+
+	// A missing or outdated cache only means that the tilesets are parsed again
+	auto load_tileset_cache(config_args const& cfg) -> serial::tileset_cache {
+		auto const path = get_tileset_cache_path(cfg);
+		std::ifstream cache_data(path);
+		if(!cache_data) {
+			return {};
+		}
+
+		auto result = serial::tileset_cache::load(cache_data);
+		if(!result) {
+			fmt::print("Ignoring the tileset cache '{}': {}\n", path, result.error().description);
+			return {};
+		}
+		return *std::move(result);
+	}
+
+	auto get_file_stamp(std::filesystem::path const& path) -> std::optional<serial::file_stamp> {
+		std::error_code ec;
+		auto const size = std::filesystem::file_size(path, ec);
+		if(ec) {
+			return std::nullopt;
+		}
+		auto const write_time = std::filesystem::last_write_time(path, ec);
+		if(ec) {
+			return std::nullopt;
+		}
+		return serial::file_stamp{size, static_cast<std::int64_t>(write_time.time_since_epoch().count())};
+	}
+
+	auto get_count_value(config_args const& cfg, std::string_view section, std::string_view key, int default_value) -> int {
+		auto const value = cfg.get_value(section, key);
+		if(!value) {
+			return default_value;
+		}
+
+		int result;
+		auto const [end, ec] = std::from_chars(value->data(), value->data() + value->size(), result);
+		if(ec != std::errc{} || end != value->data() + value->size() || result < 0) {
+			throw std::runtime_error(fmt::format("Config '{}' of section '{}' was not a non-negative integer: '{}'", key, section, *value));
+		}
+		return result;
+	}
+
+	auto get_chunk_streamer_options(config_args const& cfg, sys::mapped_file const& source_file) -> serial::chunk_streamer_options {
+		serial::chunk_streamer_options options;
+		options.memory_budget = static_cast<std::size_t>(get_count_value(cfg, stream_section, chunk_memory_budget_key, 32 * 1024)) * 1024;
+		options.prefetch_distance = get_count_value(cfg, stream_section, prefetch_chunks_key, 2);
+		options.source_file = &source_file;
+		return options;
+	}
+
+	auto get_chunk_cache_budget(config_args const& cfg) -> std::size_t {
+		return static_cast<std::size_t>(get_count_value(cfg, render_section, chunk_cache_key, 64 * 1024)) * 1024;
+	}
+
 	auto create_window(command_args const& cmd) -> sdl::unique_window {
 		auto const window_size = cmd.window_size.value_or(math::vector2i{1280, 720});
 		return sdl::unique_window(SDL_CreateWindow("TelharTactical", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, window_size.x, window_size.y, SDL_WINDOW_RESIZABLE));
@@ -43,8 +116,8 @@ namespace {
 		return e.type == SDL_QUIT || e.type == SDL_KEYUP && e.key.keysym.sym == SDLK_ESCAPE;
 	}
 
-	auto load_map(config_args const& cfg, std::string_view map_name) -> game::map {
-		auto const path = get_resource_path(cfg).append(map_name.begin(), map_name.end());
+	auto load_map(std::filesystem::path const& resource_path, std::string_view map_name) -> game::map {
+		auto const path = std::filesystem::path(resource_path).append(map_name.begin(), map_name.end());
 		std::ifstream map_data(path);
 		if(!map_data) {
 			throw std::runtime_error(fmt::format("Could not open '{}'", path));
@@ -60,51 +133,116 @@ namespace {
 		return *std::move(map_result);
 	}
 
-	auto load_default_map(config_args const& cfg) -> game::map {
+	// Maps compiled by MapCompiler are mapped rather than read, so that their pages are only loaded when used
+	auto load_compiled_map(std::filesystem::path const& resource_path, std::string_view map_name, sys::mapped_file& file) -> serial::binary_map_view {
+		auto const path = std::filesystem::path(resource_path).append(map_name.begin(), map_name.end());
+		auto file_result = sys::mapped_file::open(path);
+		if(!file_result) {
+			throw std::runtime_error(file_result.error().description);
+		}
+
+		auto const map_result = serial::read_binary_map(file_result->data(), file_result->size());
+		if(!map_result) {
+			throw std::runtime_error(fmt::format("Failed to load '{}' compiled map: {}", map_name, map_result.error().description));
+		}
+
+		fmt::print("Loaded compiled map '{}'.\n", map_name);
+
+		file = *std::move(file_result);
+		return *map_result;
+	}
+
+	auto is_compiled_map(std::string_view map_name) -> bool {
+		return std::filesystem::path(map_name.begin(), map_name.end()).extension() == ".ktmap";
+	}
+
+	auto get_default_map(config_args const& cfg) -> std::optional<std::string> {
 		auto const default_map = cfg.get_value(game_section, default_map_key);
-		if(default_map) {
-			return load_map(cfg, *default_map);
-		} else {
-			return {};
+		if(!default_map) {
+			return std::nullopt;
 		}
+		return std::string(*default_map);
 	}
 
-	auto load_texture_bank(config_args const& cfg, gsl::span<game::tileset const> tilesets, SDL_Renderer & renderer, std::map<std::string, sdl::texture> texture_bank = {}) 
-		-> std::map<std::string, sdl::texture> {
-		// Clear textures not requested
-		erase_if(texture_bank, [tilesets] (auto const& texture_data) -> bool {
-			return std::find_if(tilesets.begin(), tilesets.end(), [&texture_data] (game::tileset const& tileset) -> bool {
-				return tileset.source == texture_data.first;
-			}) == tilesets.end();
-		});
+	auto get_map_layout(config_args const& cfg) -> game::map_layout {
+		game::map_layout layout;
+		auto const tiles = cfg.get_value(game_section, tile_layout_key).value_or("row_major");
+		if(tiles == "z_order") {
+			layout.tiles = game::tile_layout::z_order;
+		} else if(tiles != "row_major") {
+			throw std::runtime_error(fmt::format("Config '{}' of section '{}' was not 'row_major' or 'z_order': '{}'", tile_layout_key, game_section, tiles));
+		}
+
+		auto const chunks = cfg.get_value(game_section, chunk_order_key).value_or("loaded");
+		if(chunks == "hilbert") {
+			layout.hilbert_chunk_order = true;
+		} else if(chunks != "loaded") {
+			throw std::runtime_error(fmt::format("Config '{}' of section '{}' was not 'loaded' or 'hilbert': '{}'", chunk_order_key, game_section, chunks));
+		}
+		return layout;
+	}
+
+	// Does not use the game's state, so that it can run on a worker thread
+	auto load_map_data(std::filesystem::path const& resource_path, std::optional<std::string> const& map_name, game::map_layout layout) -> loaded_map {
+		loaded_map result;
+		if(!map_name) {
+			return result;
+		}
 
-		for(auto const& tileset : tilesets) {
-			if(texture_bank.find(tileset.source) != texture_bank.end()) {
-				continue;
+		if(is_compiled_map(*map_name)) {
+			auto const view = load_compiled_map(resource_path, *map_name, result.compiled_map_file);
+			for(std::size_t i = 0; i < view.get_tileset_count(); ++i) {
+				serial::binary_tileset_view const tileset = view.get_tileset(i);
+				result.map.tilesets.push_back({std::string(tileset.source), tileset.starting_id});
+			}
+			result.map.tile_dimensions = view.get_tile_dimensions();
+			result.compiled_map = view;
+		} else {
+			result.map = load_map(resource_path, *map_name);
+			if(layout.tiles != game::tile_layout::row_major || layout.hilbert_chunk_order) {
+				game::set_layout(result.map, layout);
 			}
+		}
+		return result;
+	}
 
-			auto const resource_path = get_resource_path(cfg);
-			auto const tiled_tileset = resource_path / tileset.source;
+	// Runs on a worker thread: decodes the image and converts it to 'pixel_format', leaving only the upload to the render thread.
+	// The tileset is only parsed when it is not known from the metadata cache
+	auto load_tileset_image(std::filesystem::path const& resource_path, std::string const& tileset_source, std::optional<serial::tiled_tileset_info> cached_info, std::uint32_t pixel_format) -> decoded_tileset_image {
+		decoded_tileset_image decoded;
+		if(!cached_info) {
+			auto const tiled_tileset = resource_path / tileset_source;
 			auto tiled_data = std::ifstream(tiled_tileset);
 			if(!tiled_data) {
 				throw std::runtime_error(fmt::format("Failed to load Tiled tileset '{}'", tiled_tileset));
 			}
 
-			auto const result = serial::get_tiled_tileset_image(tiled_data);
+			auto result = serial::get_tiled_tileset_info(tiled_data);
 			if(!result) {
 				throw std::runtime_error(fmt::format("Could not find image data in Tiled tileset '{}': {}", tiled_tileset, result.error().description));
 			}
-			auto const& texture_name = *result;
+			cached_info = *result;
+			decoded.parsed_info = *std::move(result);
+		}
+		auto const& texture_name = cached_info->image;
+		decoded.tile_dimensions = cached_info->tile_dimensions;
 
-			auto const texture_path = resource_path / texture_name;
-			auto const texture = IMG_LoadTexture(&renderer, texture_path.string().c_str());
-			if(texture == nullptr) {
-				throw std::runtime_error(fmt::format("Failed to load tileset '{}'", texture_path));
-			}
-			texture_bank.emplace(tileset.source, texture);
+		auto const texture_path = resource_path / texture_name;
+		sdl::unique_surface image(IMG_Load(texture_path.string().c_str()));
+		if(image == nullptr) {
+			throw std::runtime_error(fmt::format("Failed to load tileset '{}'", texture_path));
+		}
+		decoded.path = texture_path;
+		if(image->format->format == pixel_format) {
+			decoded.pixels = std::move(image);
+			return decoded;
 		}
 
-		return texture_bank;
+		decoded.pixels.reset(SDL_ConvertSurfaceFormat(image.get(), pixel_format, 0));
+		if(decoded.pixels == nullptr) {
+			throw std::runtime_error(fmt::format("Failed to convert tileset '{}': {}", texture_path, SDL_GetError()));
+		}
+		return decoded;
 	}
 }
 
@@ -113,9 +251,248 @@ game_data::game_data(command_args cmd, config_args cfg)
 	, cfg(std::move(cfg))
 	, window(create_window(this->cmd))
 	, renderer(create_renderer(*window))
-	, map(load_default_map(this->cfg))
-	, texture_bank(load_texture_bank(this->cfg, map.tilesets, *renderer)) {
-	
+	, chunk_textures(*renderer, get_chunk_cache_budget(this->cfg))
+	, tileset_atlas(*renderer)
+	, tileset_metadata(load_tileset_cache(this->cfg)) {
+	// Nothing could be drawn in the meantime, so the first map is loaded in place
+	set_map(load_map_data(get_resource_path(this->cfg), get_default_map(this->cfg), get_map_layout(this->cfg)), {});
+}
+
+void game_data::begin_map_load(std::optional<std::string> map_name) {
+	// A load already in progress is dropped when it finishes
+	next_map.emplace();
+	next_map->data = thread_pool.submit([resource_path = get_resource_path(cfg), map_name = std::move(map_name), layout = get_map_layout(cfg)] {
+		return load_map_data(resource_path, map_name, layout);
+	});
+}
+
+void game_data::update_next_map() {
+	if(!next_map) {
+		return;
+	}
+
+	try {
+		if(!next_map->loaded) {
+			if(next_map->data.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+				return;
+			}
+			next_map->loaded = next_map->data.get();
+			// Images of the next map are decoded while the current one is still drawn with its own
+			start_tileset_image_loads(next_map->loaded->map.tilesets, next_map->images);
+		}
+
+		bool const images_ready = std::all_of(next_map->images.begin(), next_map->images.end(), [] (tileset_image_load const& load) {
+			return load.image.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+		});
+		if(!images_ready) {
+			return;
+		}
+
+		std::vector<tileset_image> images;
+		for(tileset_image_load& load : next_map->images) {
+			images.push_back({std::move(load.source), load.image.get()});
+		}
+		loaded_map data = *std::move(next_map->loaded);
+		next_map.reset();
+		set_map(std::move(data), std::move(images));
+	} catch(std::exception const& e) {
+		fmt::print("Failed to load the next map, keeping the current one: {}\n", e.what());
+		next_map.reset();
+	}
+}
+
+void game_data::set_map(loaded_map data, std::vector<tileset_image> images) {
+	if(!compiled_map && !data.compiled_map) {
+		// Only the chunks which changed are replaced, so that the cached textures of the others are kept. Replaced chunks
+		// have new tiles, which are not in the cache yet
+		auto const changes = game::update_map(map, std::move(data.map));
+		if(!changes.structure_changed) {
+			fmt::print("Updated {} chunks of the map.\n", changes.changed_chunks.size());
+			// The tilesets are the same. Only images missing from the atlas were decoded ahead: when there are some, they are
+			// added, and the cached chunks drawn without them are dropped
+			if(images.empty()) {
+				return;
+			}
+		}
+	} else {
+		// Stops reading the previous mapped file
+		chunk_streamer.reset();
+
+		map = std::move(data.map);
+		compiled_map_file = std::move(data.compiled_map_file);
+		compiled_map = data.compiled_map;
+		if(compiled_map) {
+			chunk_streamer.emplace(*compiled_map, thread_pool, get_chunk_streamer_options(cfg, compiled_map_file));
+		}
+	}
+
+	update_tileset_atlas(std::move(images));
+	chunk_textures.clear();
+}
+
+void game_data::update_tileset_atlas(std::vector<tileset_image> images) {
+	// Tilesets already in the atlas are kept, until too much of it is left unused
+	if(!tileset_atlas.retain(map.tilesets)) {
+		tileset_atlas.clear();
+	}
+
+	// The map is already in place: an image which cannot be added leaves its tiles undrawn, rather than the map half replaced
+	for(auto& [source, image] : images) {
+		if(tileset_atlas.find(source) == nullptr) {
+			try {
+				add_tileset_image(source, std::move(image));
+			} catch(std::exception const& e) {
+				fmt::print("Failed to load the image of tileset '{}': {}\n", source, e.what());
+			}
+		}
+	}
+	save_tileset_metadata();
+
+	// Images of a previous map still decoding are dropped when they finish
+	tileset_loads.clear();
+	start_tileset_image_loads(map.tilesets, tileset_loads);
+
+	tile_sources = tile_lookup(map.tilesets, tileset_atlas);
+	update_watched_files();
+}
+
+void game_data::start_tileset_image_loads(std::vector<game::tileset> const& tilesets, std::vector<tileset_image_load>& loads) {
+	for(game::tileset const& tileset : tilesets) {
+		bool const loading = std::any_of(loads.begin(), loads.end(), [&tileset] (tileset_image_load const& load) {
+			return load.source == tileset.source;
+		});
+		if(!loading && tileset_atlas.find(tileset.source) == nullptr) {
+			start_tileset_image_load(tileset.source, loads);
+		}
+	}
+}
+
+void game_data::start_tileset_image_load(std::string const& source, std::vector<tileset_image_load>& loads) {
+	auto const resource_path = get_resource_path(cfg);
+	// Taken before the tileset is read, so that a tileset modified meanwhile is parsed again on the next run
+	auto const stamp = get_file_stamp(resource_path / source);
+	std::optional<serial::tiled_tileset_info> cached_info;
+	if(stamp) {
+		if(serial::tiled_tileset_info const* const info = tileset_metadata.find(source, *stamp)) {
+			cached_info = *info;
+		}
+	}
+
+	loads.push_back({source, thread_pool.submit([resource_path, source, cached_info, stamp, pixel_format = tileset_atlas.get_pixel_format()] {
+		decoded_tileset_image decoded = load_tileset_image(resource_path, source, cached_info, pixel_format);
+		decoded.stamp = stamp;
+		return decoded;
+	})});
+}
+
+auto game_data::add_tileset_image(std::string const& source, decoded_tileset_image image) -> bool {
+	bool const compact = tileset_atlas.add(source, *image.pixels, image.tile_dimensions);
+	tileset_image_paths.insert_or_assign(source, std::move(image.path));
+	if(image.parsed_info && image.stamp) {
+		tileset_metadata.insert(source, *image.stamp, *std::move(image.parsed_info));
+	}
+	return compact;
+}
+
+void game_data::save_tileset_metadata() {
+	if(!tileset_metadata.is_modified()) {
+		return;
+	}
+
+	auto const path = get_tileset_cache_path(cfg);
+	std::ofstream cache_data(path);
+	tileset_metadata.save(cache_data);
+	if(!cache_data) {
+		fmt::print("Could not save the tileset cache to '{}'.\n", path);
+	}
+}
+
+void game_data::upload_tileset_images() {
+	auto const ready = std::partition(tileset_loads.begin(), tileset_loads.end(), [] (tileset_image_load const& load) {
+		return load.image.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+	});
+	if(ready == tileset_loads.end()) {
+		return;
+	}
+
+	bool compact = true;
+	for(auto it = ready; it != tileset_loads.end(); ++it) {
+		try {
+			// Replaces the previous image of a reloaded tileset
+			compact = add_tileset_image(it->source, it->image.get()) && compact;
+		} catch(std::exception const& e) {
+			fmt::print("Failed to load the image of tileset '{}': {}\n", it->source, e.what());
+		}
+	}
+	tileset_loads.erase(ready, tileset_loads.end());
+	save_tileset_metadata();
+
+	if(!compact) {
+		// Reloaded images of other sizes left most of the atlas unused: every tileset is loaded again into a cleared atlas
+		tileset_atlas.clear();
+		start_tileset_image_loads(map.tilesets, tileset_loads);
+	}
+
+	tile_sources = tile_lookup(map.tilesets, tileset_atlas);
+	// Cached chunks were drawn without the new tilesets
+	chunk_textures.clear();
+	update_watched_files();
+}
+
+void game_data::update_watched_files() {
+	auto const resource_path = get_resource_path(cfg);
+	std::vector<std::filesystem::path> files;
+	if(auto const map_name = get_default_map(cfg)) {
+		files.push_back(resource_path / *map_name);
+	}
+	for(game::tileset const& tileset : map.tilesets) {
+		files.push_back(resource_path / tileset.source);
+		if(auto const image_path = tileset_image_paths.find(tileset.source); image_path != tileset_image_paths.end()) {
+			files.push_back(image_path->second);
+		}
+	}
+
+	if(files == watched_files) {
+		return;
+	}
+	watched_files = std::move(files);
+	if(auto const result = file_watcher.watch(watched_files); !result) {
+		fmt::print("Changes to the map files will not be reloaded: {}\n", result.error().description);
+	}
+}
+
+void game_data::reload_modified_files() {
+	auto const modified = file_watcher.poll();
+	if(modified.empty()) {
+		return;
+	}
+
+	auto const resource_path = get_resource_path(cfg);
+	auto const is_modified = [&modified] (std::filesystem::path const& path) {
+		auto const normal_path = std::filesystem::absolute(path).lexically_normal();
+		return std::find(modified.begin(), modified.end(), normal_path) != modified.end();
+	};
+
+	if(auto const map_name = get_default_map(cfg); map_name && is_modified(resource_path / *map_name)) {
+		// Parsed in the background, then only its changed chunks are replaced
+		begin_map_load(map_name);
+	}
+
+	for(game::tileset const& tileset : map.tilesets) {
+		auto const image_path = tileset_image_paths.find(tileset.source);
+		bool const tileset_modified = is_modified(resource_path / tileset.source)
+			|| (image_path != tileset_image_paths.end() && is_modified(image_path->second));
+		if(!tileset_modified) {
+			continue;
+		}
+
+		// The previous image is drawn until the new one is uploaded
+		tileset_loads.erase(std::remove_if(tileset_loads.begin(), tileset_loads.end(), [&tileset] (tileset_image_load const& load) {
+			return load.source == tileset.source;
+		}), tileset_loads.end());
+		start_tileset_image_load(tileset.source, tileset_loads);
+		fmt::print("Reloading tileset '{}'.\n", tileset.source);
+	}
 }
 
 void game_data::run() {
@@ -127,8 +504,12 @@ void game_data::run() {
 			if(is_quit_event(e)) {
 				quit = true;
 			} else if(e.type == SDL_KEYUP && e.key.keysym.sym == SDLK_F2) {
-				map = load_default_map(cfg);
-				texture_bank = load_texture_bank(cfg, map.tilesets, *renderer, std::move(texture_bank));
+				// The current map is drawn until the reload is ready
+				begin_map_load(get_default_map(cfg));
+			} else if(e.type == SDL_RENDER_TARGETS_RESET || e.type == SDL_RENDER_DEVICE_RESET) {
+				chunk_textures.clear();
+			} else if(e.type == SDL_KEYUP && e.key.keysym.sym == SDLK_F3) {
+				print_render_stats();
 			} else if(e.type == SDL_KEYUP && e.key.keysym.sym == SDLK_LEFT) {
 				screen_pixel_offset += math::vector2i{game::tile::dimensions.x, 0};
 			} else if(e.type == SDL_KEYUP && e.key.keysym.sym == SDLK_RIGHT) {
@@ -141,56 +522,154 @@ void game_data::run() {
 		}
 
 		// Update
+		reload_modified_files();
+		update_next_map();
+		upload_tileset_images();
 
 		// Render
 		KT_SDL_ENSURE(SDL_RenderClear(renderer.get()));
 
-
-		for(game::layer const& layer : map.layers) {
-			if(layer.get_type() == game::layer::type::tile) {
-				render_tile_layer(std::get<game::layer::tile_data>(layer.data));
-			}
-		}
+		last_render_stats = render_map();
 
 		SDL_RenderPresent(renderer.get());
 	}
 }
 
-void game_data::render_tile_layer(game::layer::tile_data const& tiles) {
-	for(game::tile_chunk const& chunk : tiles.chunks) {
-		auto const chunk_screen_position = element_multiply(chunk.position, game::tile::dimensions);
-		for(size_t tile_index = 0; tile_index < chunk.tiles.size(); ++tile_index) {
-			game::tile const tile = chunk.tiles[tile_index];
-			if(tile.data == game::tile::id::none) {
-				continue;
+auto game_data::get_screen_tiles() const -> std::pair<math::vector2i, math::vector2i> {
+	math::vector2i screen_size;
+	KT_SDL_ENSURE(SDL_GetRendererOutputSize(renderer.get(), &screen_size.x, &screen_size.y));
+
+	auto const first_pixel = -screen_pixel_offset;
+	auto const last_pixel = first_pixel + screen_size;
+	math::vector2i const first_tile = game::get_tile_position(first_pixel);
+	math::vector2i const last_tile = game::get_tile_position(last_pixel - math::vector2i{1, 1}) + math::vector2i{1, 1};
+	return {first_tile, last_tile};
+}
+
+auto game_data::render_map() -> render_stats {
+	render_stats stats;
+	auto const [first_tile, last_tile] = get_screen_tiles();
+	chunk_textures.begin_frame();
+
+	if(chunk_streamer) {
+		chunk_streamer->update(first_tile, last_tile);
+		// Chunks still loading are drawn on a later frame
+		std::size_t current_layer = 0;
+		chunk_streamer->for_each_in_view([this, &stats, &current_layer] (std::size_t layer_index, game::packed_chunk const& chunk) {
+			if(layer_index != current_layer) {
+				stats.draw_calls += screen_batch.flush(*renderer);
+				current_layer = layer_index;
+			}
+			render_tile_chunk(chunk.position, chunk.tiles, stats);
+			++stats.drawn_chunks;
+		});
+		stats.draw_calls += screen_batch.flush(*renderer);
+
+		std::size_t chunk_count = 0;
+		for(std::size_t layer_index = 0; layer_index < compiled_map->get_layer_count(); ++layer_index) {
+			chunk_count += compiled_map->get_layer(layer_index).get_chunk_count();
+		}
+		stats.culled_chunks = chunk_count - stats.drawn_chunks;
+	}
+
+	// Only the chunk positions overlapping the screen are looked up. Tiled aligns chunks on their dimensions
+	math::vector2i const first_chunk = game::get_chunk_coordinates(first_tile);
+	math::vector2i const last_chunk = game::get_chunk_coordinates(last_tile - math::vector2i{1, 1}) + math::vector2i{1, 1};
+	for(game::layer const& layer : map.layers) {
+		auto const tiles = std::get_if<game::layer::tile_data>(&layer.data);
+		if(tiles == nullptr || tiles->get_chunks().empty()) {
+			continue;
+		}
+
+		std::size_t drawn_chunks = 0;
+		for(int y = first_chunk.y; y < last_chunk.y; ++y) {
+			for(int x = first_chunk.x; x < last_chunk.x; ++x) {
+				if(game::packed_chunk const* const chunk = tiles->find_chunk({x, y})) {
+					render_tile_chunk(chunk->position, chunk->tiles, stats);
+					++drawn_chunks;
+				}
 			}
+		}
+		stats.draw_calls += screen_batch.flush(*renderer);
+		stats.drawn_chunks += drawn_chunks;
+		stats.culled_chunks += tiles->get_chunks().size() - drawn_chunks;
+	}
 
-			game::tileset const& tileset_source = game::get_tileset(map, tile.data);
-			auto const tileset_key = static_cast<int>(tile.data) - static_cast<int>(tileset_source.starting_id);
+	return stats;
+}
 
-			auto const it_tileset = texture_bank.find(tileset_source.source);
-			if(it_tileset == texture_bank.end()) throw std::runtime_error(fmt::format("Non-loaded texture '{}'", tileset_source.source));
-			sdl::texture & tileset = it_tileset->second;
+void game_data::print_render_stats() const {
+	fmt::print("Last frame: {} chunks drawn, {} culled, {} tiles drawn with {} draw calls\n",
+		last_render_stats.drawn_chunks, last_render_stats.culled_chunks, last_render_stats.drawn_tiles, last_render_stats.draw_calls);
+	fmt::print("Tileset atlas: {} textures\n", tileset_atlas.get_texture_count());
+	if(chunk_textures.is_enabled()) {
+		auto const stats = chunk_textures.get_stats();
+		fmt::print("Chunk cache: {} textures ({} KB), {} hits, {} misses, {} evictions\n",
+			stats.cached_chunks, stats.cached_bytes / 1024, stats.hits, stats.misses, stats.evictions);
+	}
+	for(game::layer_memory const& layer : game::get_memory_report(map)) {
+		fmt::print("Layer {}: {} chunks in {} KB, {} sharing their tiles, {:.1f} times smaller than unpacked ({} uniform, {} palette, {} palette runs, {} raw)\n",
+			layer.layer_index, layer.chunk_count, layer.packed_bytes / 1024, layer.shared_chunks,
+			layer.packed_bytes != 0 ? static_cast<double>(layer.unpacked_bytes) / static_cast<double>(layer.packed_bytes) : 1.0,
+			layer.encoding_counts[0], layer.encoding_counts[1], layer.encoding_counts[2], layer.encoding_counts[3]);
+	}
+	if(chunk_streamer) {
+		auto const stats = chunk_streamer->get_stats();
+		fmt::print("Chunk streaming: {} resident ({} KB), {} loading, {} loaded and {} evicted in total\n",
+			stats.resident_chunks, stats.resident_bytes / 1024, stats.pending_loads, stats.loaded_chunks, stats.evicted_chunks);
+	}
+}
 
-			auto const tileset_tile_width = tileset.get_dimensions().x / game::tile::dimensions.x;
-			auto const tileset_coords = element_multiply(math::vector2i{tileset_key % tileset_tile_width, tileset_key / tileset_tile_width}, game::tile::dimensions);
+void game_data::render_tile_chunk(math::vector2i position, std::shared_ptr<game::packed_tiles const> const& tiles, render_stats& stats) {
+	// Compiled maps can still hold empty chunks
+	if(tiles->is_empty()) {
+		return;
+	}
 
-			auto const chunk_coords = math::vector2i{static_cast<int>(tile_index) % game::tile_chunk::dimensions.x, static_cast<int>(tile_index) / game::tile_chunk::dimensions.x};
-			auto const screen_coords = screen_pixel_offset + chunk_screen_position + element_multiply(chunk_coords, game::tile::dimensions);
+	auto const chunk_screen_position = screen_pixel_offset + element_multiply(position, game::tile::dimensions);
+	// Tiles are only unpacked when they are drawn: cached chunks are copied as they are
+	std::array<game::tile, game::tile_chunk::tile_count> unpacked;
+	// Tiles pending in screen_batch stay out of the chunk's texture, as they do not overlap it
+	SDL_Texture* const texture = chunk_textures.get_texture(tiles, [this, &tiles, &unpacked, &stats] {
+		tiles->decode(unpacked.data());
+		render_tiles({0, 0}, unpacked, chunk_batch);
+		stats.draw_calls += chunk_batch.flush(*renderer);
+	});
+	if(texture == nullptr) {
+		tiles->decode(unpacked.data());
+		stats.drawn_tiles += render_tiles(chunk_screen_position, unpacked, screen_batch);
+		return;
+	}
+
+	SDL_Rect const screen_rect{
+		chunk_screen_position.x,
+		chunk_screen_position.y,
+		game::tile_chunk::dimensions.x * game::tile::dimensions.x,
+		game::tile_chunk::dimensions.y * game::tile::dimensions.y
+	};
+	SDL_RenderCopy(renderer.get(), texture, nullptr, &screen_rect);
+	++stats.draw_calls;
+}
 
-			SDL_Rect const texture_rect{
-				tileset_coords.x,
-				tileset_coords.y,
-				game::tile::dimensions.x,
-				game::tile::dimensions.y
-			};
-			SDL_Rect const screen_rect{
-				screen_coords.x,
-				screen_coords.y,
-				game::tile::dimensions.x,
-				game::tile::dimensions.y
-			};
-			SDL_RenderCopy(renderer.get(), tileset.get_texture(), &texture_rect, &screen_rect);
+auto game_data::render_tiles(math::vector2i screen_position, gsl::span<game::tile const> tiles, tile_batch& batch) const -> std::size_t {
+	std::size_t tile_count = 0;
+	for(size_t tile_index = 0; tile_index < static_cast<size_t>(tiles.size()); ++tile_index) {
+		tile_lookup::tile_source const source = tile_sources.get_source(tiles[tile_index].get_id());
+		if(source.texture == nullptr) {
+			continue;
 		}
+
+		auto const chunk_coords = math::vector2i{static_cast<int>(tile_index) % game::tile_chunk::dimensions.x, static_cast<int>(tile_index) / game::tile_chunk::dimensions.x};
+		auto const screen_coords = screen_position + element_multiply(chunk_coords, game::tile::dimensions);
+
+		SDL_Rect const screen_rect{
+			screen_coords.x,
+			screen_coords.y,
+			game::tile::dimensions.x,
+			game::tile::dimensions.y
+		};
+		batch.add(source.texture, source.rect, screen_rect, tiles[tile_index].get_flips());
+		++tile_count;
 	}
+	return tile_count;
 }
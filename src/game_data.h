@@ -1,14 +1,53 @@
 #pragma once
 
+#include "chunk_cache.h"
 #include "command_args.h"
 #include "config_args.h"
+#include "tile_atlas.h"
+#include "tile_batch.h"
+#include "tile_lookup.h"
 
 #include "game/map.h"
 #include "sdl/texture.h"
 #include "sdl/resource.h"
+#include "serial/binary_map.h"
+#include "serial/chunk_streamer.h"
+#include "serial/tileset_cache.h"
+#include "sys/file_watcher.h"
+#include "sys/mapped_file.h"
+#include "sys/thread_pool.h"
 #include "math/vector2.h"
 
+#include <gsl/span>
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <future>
 #include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Tileset image decoded on a worker thread, in the pixel format of the atlas
+struct decoded_tileset_image {
+	std::filesystem::path path;
+	sdl::unique_surface pixels;
+	math::vector2i tile_dimensions;
+	// Set when the tileset was parsed rather than found in the metadata cache, to be cached under 'stamp'
+	std::optional<serial::tiled_tileset_info> parsed_info;
+	std::optional<serial::file_stamp> stamp;
+};
+
+// Map read by game_data, on a worker thread when it is reloaded
+struct loaded_map {
+	game::map map;
+	// Compiled maps are read in place from their mapped file: 'map' then only holds their tilesets
+	sys::mapped_file compiled_map_file;
+	std::optional<serial::binary_map_view> compiled_map;
+};
 
 class game_data {
 public:
@@ -21,9 +60,75 @@ private:
 	config_args cfg;
 	sdl::unique_window window;
 	sdl::unique_renderer renderer;
+	chunk_cache chunk_textures;
+	sys::thread_pool thread_pool;
+	// Compiled maps are read in place from their mapped file: 'map' then only holds their tilesets, and the chunks around
+	// the camera are streamed in
+	sys::mapped_file compiled_map_file;
+	std::optional<serial::binary_map_view> compiled_map;
+	std::optional<serial::chunk_streamer> chunk_streamer;
 	game::map map;
-	std::map<std::string, sdl::texture> texture_bank;
+	// Images of the tilesets of 'map'
+	tile_atlas tileset_atlas;
+	// Saved after each tileset parsed, so that the next runs can skip them
+	serial::tileset_cache tileset_metadata;
+	// Images decoded on 'thread_pool', added to the atlas on the frame they are ready. Their tiles are not drawn until then
+	struct tileset_image_load {
+		std::string source;
+		std::future<decoded_tileset_image> image;
+	};
+	using tileset_image = std::pair<std::string, decoded_tileset_image>;
+	std::vector<tileset_image_load> tileset_loads;
+	// Map loading in the background with the images of its tilesets, swapped in once all of them are ready.
+	// The current map is drawn until then, and kept if the load fails
+	struct map_load {
+		std::future<loaded_map> data;
+		std::optional<loaded_map> loaded;
+		std::vector<tileset_image_load> images;
+	};
+	std::optional<map_load> next_map;
+	// Image file of each tileset in the atlas
+	std::map<std::string, std::filesystem::path, std::less<>> tileset_image_paths;
+	sys::file_watcher file_watcher;
+	std::vector<std::filesystem::path> watched_files;
+	// Rebuilt whenever the map or the atlas changes
+	tile_lookup tile_sources;
+	// Tiles drawn to the screen, flushed after each layer, and tiles drawn to a chunk_cache texture
+	tile_batch screen_batch;
+	tile_batch chunk_batch;
 	math::vector2i screen_pixel_offset{0, 0};
 
-	void render_tile_layer(game::layer::tile_data const& tiles);
+	// Chunks of the last frame, printed with F3
+	struct render_stats {
+		std::size_t drawn_chunks = 0;
+		std::size_t culled_chunks = 0;
+		std::size_t draw_calls = 0;
+		// Tiles drawn outside of cached chunks, which would each take a draw call without batching
+		std::size_t drawn_tiles = 0;
+	};
+	render_stats last_render_stats;
+
+	// Also meant to preload the map of a transition ahead of time
+	void begin_map_load(std::optional<std::string> map_name);
+	void update_next_map();
+	void set_map(loaded_map data, std::vector<tileset_image> images);
+	// Adds 'images' decoded ahead to the atlas and starts loading the other tileset images of 'map' missing from it. An image
+	// which fails to be added is reported and left out, as the map is already replaced
+	void update_tileset_atlas(std::vector<tileset_image> images);
+	void start_tileset_image_loads(std::vector<game::tileset> const& tilesets, std::vector<tileset_image_load>& loads);
+	void start_tileset_image_load(std::string const& source, std::vector<tileset_image_load>& loads);
+	// Returns false when the atlas should be cleared and filled again, see tile_atlas::add
+	auto add_tileset_image(std::string const& source, decoded_tileset_image image) -> bool;
+	void save_tileset_metadata();
+	void upload_tileset_images();
+	// Watches the map and its tileset files, which are reloaded on their own when modified
+	void update_watched_files();
+	void reload_modified_files();
+	// Tiles at least partially on screen, from 'first' to 'last' excluded
+	auto get_screen_tiles() const -> std::pair<math::vector2i, math::vector2i>;
+	auto render_map() -> render_stats;
+	void print_render_stats() const;
+	void render_tile_chunk(math::vector2i position, std::shared_ptr<game::packed_tiles const> const& tiles, render_stats& stats);
+	// Returns the number of tiles added to 'batch'
+	auto render_tiles(math::vector2i screen_position, gsl::span<game::tile const> tiles, tile_batch& batch) const -> std::size_t;
 };
\ No newline at end of file
@@ -0,0 +1,153 @@
+#include "tile_atlas.h"
+
+#include "algorithm_extra.h"
+#include "sdl/macro.h"
+#include "sdl/resource.h"
+
+#include <SDL_render.h>
+#include <SDL_surface.h>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+	constexpr int default_page_size = 4096;
+	// Keeps the tiles at the edge of an image from sampling their neighbour when scaled
+	constexpr int image_padding = 1;
+
+	// First 32 bits format with alpha of the renderer, so that its textures need no conversion when drawn
+	auto get_native_pixel_format(SDL_RendererInfo const& info) -> std::uint32_t {
+		for(Uint32 i = 0; i < info.num_texture_formats; ++i) {
+			std::uint32_t const format = info.texture_formats[i];
+			if(!SDL_ISPIXELFORMAT_FOURCC(format) && SDL_ISPIXELFORMAT_ALPHA(format) && SDL_BYTESPERPIXEL(format) == 4) {
+				return format;
+			}
+		}
+		return SDL_PIXELFORMAT_ARGB8888;
+	}
+}
+
+tile_atlas::tile_atlas(SDL_Renderer& renderer)
+	: renderer(&renderer) {
+	SDL_RendererInfo info;
+	KT_SDL_ENSURE(SDL_GetRendererInfo(&renderer, &info));
+	pixel_format = get_native_pixel_format(info);
+	// 0 when the renderer does not tell
+	max_page_dimensions = {
+		info.max_texture_width > 0 ? info.max_texture_width : default_page_size,
+		info.max_texture_height > 0 ? info.max_texture_height : default_page_size
+	};
+}
+
+auto tile_atlas::find(std::string_view source) const -> image const* {
+	auto const it = images.find(source);
+	return it != images.end() ? &it->second : nullptr;
+}
+
+auto tile_atlas::add(std::string const& source, SDL_Surface& pixels, math::vector2i tile_dimensions) -> bool {
+	math::vector2i const padded_dimensions{pixels.w + image_padding, pixels.h + image_padding};
+	if(pixels.w > max_page_dimensions.x || pixels.h > max_page_dimensions.y) {
+		throw std::runtime_error(fmt::format("Tileset image '{}' of {}x{} pixels is larger than the largest texture", source, pixels.w, pixels.h));
+	}
+
+	sdl::unique_surface converted;
+	SDL_Surface* upload = &pixels;
+	if(pixels.format->format != pixel_format) {
+		converted.reset(SDL_ConvertSurfaceFormat(&pixels, pixel_format, 0));
+		KT_SDL_FAILURE_IF(converted == nullptr);
+		upload = converted.get();
+	}
+
+	// A reloaded image of the same size goes where the previous one was, its padding already cleared
+	auto const previous = images.find(source);
+	if(previous != images.end() && previous->second.rect.w == pixels.w && previous->second.rect.h == pixels.h) {
+		KT_SDL_ENSURE(SDL_UpdateTexture(previous->second.texture, &previous->second.rect, upload->pixels, upload->pitch));
+		previous->second.tile_dimensions = tile_dimensions;
+		return unused_area <= used_area;
+	}
+
+	page* target = nullptr;
+	std::optional<math::vector2i> position;
+	bool padded = true;
+	for(page& p : pages) {
+		position = p.packer.insert(padded_dimensions);
+		if(position) {
+			target = &p;
+			break;
+		}
+	}
+
+	if(target == nullptr) {
+		target = &add_page({
+			std::min(std::max(default_page_size, padded_dimensions.x), max_page_dimensions.x),
+			std::min(std::max(default_page_size, padded_dimensions.y), max_page_dimensions.y)
+		});
+		// Padding may not fit in a texture of the largest size, the image itself does
+		position = target->packer.insert(padded_dimensions);
+		if(!position) {
+			position = target->packer.insert({pixels.w, pixels.h});
+			padded = false;
+		}
+	}
+
+	SDL_Rect const rect{position->x, position->y, pixels.w, pixels.h};
+	KT_SDL_ENSURE(SDL_UpdateTexture(target->texture.get_texture(), &rect, upload->pixels, upload->pitch));
+	if(padded) {
+		clear_padding(*target, rect);
+	}
+
+	if(previous != images.end()) {
+		// The area of an image replaced by one of another size is not reused
+		long long const area = static_cast<long long>(previous->second.rect.w) * previous->second.rect.h;
+		used_area -= area;
+		unused_area += area;
+	}
+	images.insert_or_assign(source, image{target->texture.get_texture(), rect, tile_dimensions});
+	used_area += static_cast<long long>(pixels.w) * pixels.h;
+	return unused_area <= used_area;
+}
+
+auto tile_atlas::retain(std::vector<game::tileset> const& tilesets) -> bool {
+	erase_if(images, [this, &tilesets] (auto const& image_data) -> bool {
+		bool const wanted = std::any_of(tilesets.begin(), tilesets.end(), [&image_data] (game::tileset const& tileset) {
+			return tileset.source == image_data.first;
+		});
+		if(!wanted) {
+			long long const area = static_cast<long long>(image_data.second.rect.w) * image_data.second.rect.h;
+			used_area -= area;
+			unused_area += area;
+		}
+		return !wanted;
+	});
+	return unused_area <= used_area;
+}
+
+void tile_atlas::clear() {
+	images.clear();
+	pages.clear();
+	used_area = 0;
+	unused_area = 0;
+}
+
+void tile_atlas::clear_padding(page& target, SDL_Rect const& rect) {
+	// Textures start with undefined pixels: transparent padding keeps them from bleeding into the image when it is scaled
+	std::vector<std::uint32_t> const transparent(static_cast<std::size_t>(std::max(rect.w, rect.h)) + image_padding, 0);
+	SDL_Rect const right{rect.x + rect.w, rect.y, image_padding, rect.h + image_padding};
+	KT_SDL_ENSURE(SDL_UpdateTexture(target.texture.get_texture(), &right, transparent.data(), sizeof(std::uint32_t)));
+	SDL_Rect const bottom{rect.x, rect.y + rect.h, rect.w, image_padding};
+	KT_SDL_ENSURE(SDL_UpdateTexture(target.texture.get_texture(), &bottom, transparent.data(), static_cast<int>(transparent.size() * sizeof(std::uint32_t))));
+}
+
+auto tile_atlas::add_page(math::vector2i dimensions) -> page& {
+	SDL_Texture* const texture = SDL_CreateTexture(renderer, pixel_format, SDL_TEXTUREACCESS_STATIC, dimensions.x, dimensions.y);
+	KT_SDL_FAILURE_IF(texture == nullptr);
+	KT_SDL_ENSURE(SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND));
+	pages.push_back({sdl::texture(texture), math::skyline_packer(dimensions)});
+	return pages.back();
+}
\ No newline at end of file
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "game/map.h"
+#include "math/skyline_packer.h"
+#include "sdl/texture.h"
+
+#include <SDL_rect.h>
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct SDL_Renderer;
+struct SDL_Surface;
+
+// Tileset images packed into a few large textures, so that tiles of different tilesets can be drawn in the same batch
+class tile_atlas {
+public:
+	struct image {
+		SDL_Texture* texture;
+		// Area of the image in the texture
+		SDL_Rect rect;
+		// Of the tiles in the image, drawn scaled to game::tile::dimensions
+		math::vector2i tile_dimensions;
+	};
+
+	explicit tile_atlas(SDL_Renderer& renderer);
+
+	// Format of the atlas textures, one the renderer uses natively. Images in another format are converted when added
+	auto get_pixel_format() const noexcept -> std::uint32_t { return pixel_format; }
+
+	auto find(std::string_view source) const -> image const*;
+	// Copies 'pixels' to the atlas as the image of tileset 'source', replacing its previous image. Throws if the image does not fit in a texture.
+	// A replaced image of the same size is overwritten in place, otherwise its area is not reused: returns false once more of the atlas is
+	// unused than used, as retain does
+	auto add(std::string const& source, SDL_Surface& pixels, math::vector2i tile_dimensions) -> bool;
+	// Forgets the images of tilesets not in 'tilesets'. Their area is not reused: returns false once more of the atlas is unused
+	// than used, the atlas should then be cleared and filled again
+	auto retain(std::vector<game::tileset> const& tilesets) -> bool;
+	void clear();
+
+	auto get_texture_count() const noexcept -> std::size_t { return pages.size(); }
+
+private:
+	struct page {
+		sdl::texture texture;
+		math::skyline_packer packer;
+	};
+
+	SDL_Renderer* renderer;
+	std::uint32_t pixel_format;
+	math::vector2i max_page_dimensions;
+	std::vector<page> pages;
+	std::map<std::string, image, std::less<>> images;
+	long long used_area = 0;
+	long long unused_area = 0;
+
+	auto add_page(math::vector2i dimensions) -> page&;
+	// Makes the padding right and below 'rect' transparent
+	void clear_padding(page& target, SDL_Rect const& rect);
+};
\ No newline at end of file
@@ -0,0 +1,99 @@
+#include "tile_batch.h"
+
+#include "game/tile.h"
+#include "sdl/macro.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <utility>
+
+void tile_batch::add(SDL_Texture* texture, SDL_Rect const& source, SDL_Rect const& destination, std::uint32_t flips) {
+	// Consecutive tiles mostly come from the same tileset
+	if(last_group >= groups.size() || groups[last_group].texture != texture) {
+		last_group = 0;
+		while(last_group < groups.size() && groups[last_group].texture != texture) {
+			++last_group;
+		}
+		if(last_group == groups.size()) {
+			groups.push_back({texture, {}});
+		}
+	}
+	groups[last_group].quads.push_back({source, destination, flips});
+}
+
+auto tile_batch::flush(SDL_Renderer& renderer) -> std::size_t {
+	std::size_t draw_calls = 0;
+	for(texture_group& group : groups) {
+		if(group.quads.empty()) {
+			continue;
+		}
+
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+		int texture_width, texture_height;
+		KT_SDL_ENSURE(SDL_QueryTexture(group.texture, nullptr, nullptr, &texture_width, &texture_height));
+		float const u_scale = 1.0f / static_cast<float>(texture_width);
+		float const v_scale = 1.0f / static_cast<float>(texture_height);
+		SDL_Color const white{255, 255, 255, 255};
+
+		vertices.clear();
+		for(quad const& q : group.quads) {
+			float const x0 = static_cast<float>(q.destination.x);
+			float const y0 = static_cast<float>(q.destination.y);
+			float const x1 = static_cast<float>(q.destination.x + q.destination.w);
+			float const y1 = static_cast<float>(q.destination.y + q.destination.h);
+			float const u0 = static_cast<float>(q.source.x) * u_scale;
+			float const v0 = static_cast<float>(q.source.y) * v_scale;
+			float const u1 = static_cast<float>(q.source.x + q.source.w) * u_scale;
+			float const v1 = static_cast<float>(q.source.y + q.source.h) * v_scale;
+			// Texture coordinates of the top left, top right, bottom left and bottom right corners
+			SDL_FPoint uv[4] = {{u0, v0}, {u1, v0}, {u0, v1}, {u1, v1}};
+			if(q.flips & game::tile::flip_diagonal) {
+				std::swap(uv[1], uv[2]);
+			}
+			if(q.flips & game::tile::flip_horizontal) {
+				std::swap(uv[0], uv[1]);
+				std::swap(uv[2], uv[3]);
+			}
+			if(q.flips & game::tile::flip_vertical) {
+				std::swap(uv[0], uv[2]);
+				std::swap(uv[1], uv[3]);
+			}
+			vertices.push_back({{x0, y0}, white, uv[0]});
+			vertices.push_back({{x1, y0}, white, uv[1]});
+			vertices.push_back({{x0, y1}, white, uv[2]});
+			vertices.push_back({{x1, y1}, white, uv[3]});
+		}
+
+		std::size_t const index_count = group.quads.size() * 6;
+		for(int first_vertex = static_cast<int>(indices.size() / 6 * 4); indices.size() < index_count; first_vertex += 4) {
+			indices.insert(indices.end(), {first_vertex, first_vertex + 1, first_vertex + 2, first_vertex + 2, first_vertex + 1, first_vertex + 3});
+		}
+
+		KT_SDL_ENSURE(SDL_RenderGeometry(&renderer, group.texture, vertices.data(), static_cast<int>(vertices.size()), indices.data(), static_cast<int>(index_count)));
+		++draw_calls;
+#else
+		for(quad const& q : group.quads) {
+			if(q.flips == 0) {
+				SDL_RenderCopy(&renderer, group.texture, &q.source, &q.destination);
+				continue;
+			}
+
+			bool const horizontal = (q.flips & game::tile::flip_horizontal) != 0;
+			bool const vertical = (q.flips & game::tile::flip_vertical) != 0;
+			// SDL flips, then rotates clockwise: the diagonal flip is a vertical flip and a quarter turn, which the other flips then undo or extend
+			int flip = SDL_FLIP_NONE;
+			double angle = 0.0;
+			if(q.flips & game::tile::flip_diagonal) {
+				angle = 90.0;
+				flip = (vertical ? SDL_FLIP_HORIZONTAL : 0) | (horizontal ? 0 : SDL_FLIP_VERTICAL);
+			} else {
+				flip = (horizontal ? SDL_FLIP_HORIZONTAL : 0) | (vertical ? SDL_FLIP_VERTICAL : 0);
+			}
+			SDL_RenderCopyEx(&renderer, group.texture, &q.source, &q.destination, angle, nullptr, static_cast<SDL_RendererFlip>(flip));
+		}
+		draw_calls += group.quads.size();
+#endif
+		group.quads.clear();
+	}
+	return draw_calls;
+}
\ No newline at end of file
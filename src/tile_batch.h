@@ -0,0 +1,41 @@
+#pragma once
+
+#include <SDL_rect.h>
+#include <SDL_render.h>
+#include <SDL_version.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Tiles to draw, grouped by texture. Each group is drawn with a single SDL_RenderGeometry call when built with SDL 2.0.18
+// or later, and tile by tile with SDL_RenderCopyEx otherwise. Buffers are kept between flushes, so that steady frames do not allocate
+class tile_batch {
+public:
+	// 'flips' are game::tile's flip flags
+	void add(SDL_Texture* texture, SDL_Rect const& source, SDL_Rect const& destination, std::uint32_t flips = 0);
+	// Draws the tiles added since the last flush, grouped by texture: tiles of a batch must not overlap. Returns the number of draw calls
+	auto flush(SDL_Renderer& renderer) -> std::size_t;
+
+private:
+	struct quad {
+		SDL_Rect source;
+		SDL_Rect destination;
+		std::uint32_t flips;
+	};
+
+	struct texture_group {
+		SDL_Texture* texture;
+		std::vector<quad> quads;
+	};
+
+	// Groups stay after a flush, emptied, along with their capacity
+	std::vector<texture_group> groups;
+	std::size_t last_group = 0;
+
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+	std::vector<SDL_Vertex> vertices;
+	// Two triangles per quad, shared by every group
+	std::vector<int> indices;
+#endif
+};
\ No newline at end of file
@@ -0,0 +1,35 @@
+#include "tile_lookup.h"
+
+tile_lookup::tile_lookup(std::vector<game::tileset> const& tilesets, tile_atlas const& atlas) {
+	// Like game::get_tileset, a tile id belongs to the last tileset starting at or before it
+	for(game::tileset const& tileset : tilesets) {
+		tile_atlas::image const* const image = atlas.find(tileset.source);
+		if(image == nullptr) {
+			continue;
+		}
+
+		// Tiles are drawn at game::tile::dimensions whatever their size in the tileset
+		math::vector2i const tile_dimensions = image->tile_dimensions;
+		auto const tileset_tile_width = image->rect.w / tile_dimensions.x;
+		auto const tileset_tile_height = image->rect.h / tile_dimensions.y;
+		auto const first_index = static_cast<std::size_t>(tileset.starting_id);
+		auto const tile_count = static_cast<std::size_t>(tileset_tile_width) * static_cast<std::size_t>(tileset_tile_height);
+		if(sources.size() < first_index + tile_count) {
+			sources.resize(first_index + tile_count, tile_source{nullptr, {}});
+		}
+
+		for(int y = 0; y < tileset_tile_height; ++y) {
+			for(int x = 0; x < tileset_tile_width; ++x) {
+				sources[first_index + y * tileset_tile_width + x] = {
+					image->texture,
+					{image->rect.x + x * tile_dimensions.x, image->rect.y + y * tile_dimensions.y, tile_dimensions.x, tile_dimensions.y}
+				};
+			}
+		}
+	}
+
+	// The 'none' id is never drawn
+	if(!sources.empty()) {
+		sources[0] = tile_source{nullptr, {}};
+	}
+}
\ No newline at end of file
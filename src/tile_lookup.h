@@ -0,0 +1,31 @@
+#pragma once
+
+#include "tile_atlas.h"
+
+#include "game/map.h"
+
+#include <SDL_rect.h>
+
+#include <vector>
+
+// Texture and source rectangle of every tile id of a map's tilesets, so that drawing a tile only takes an indexed load
+class tile_lookup {
+public:
+	struct tile_source {
+		// nullptr for the 'none' id and ids outside of every tileset
+		SDL_Texture* texture;
+		SDL_Rect rect;
+	};
+
+	tile_lookup() = default;
+	// The tiles of tilesets whose image is not in 'atlas' yet are not drawn
+	tile_lookup(std::vector<game::tileset> const& tilesets, tile_atlas const& atlas);
+
+	auto get_source(game::tile::id id) const noexcept -> tile_source {
+		auto const index = static_cast<std::size_t>(id);
+		return index < sources.size() ? sources[index] : tile_source{nullptr, {}};
+	}
+
+private:
+	std::vector<tile_source> sources;
+};
\ No newline at end of file
@@ -0,0 +1,58 @@
+#include <catch.hpp>
+
+#include <game/chunk_store.h>
+#include "game/test_chunks.h"
+
+TEST_CASE("Chunk store shares identical tiles", "[game]") {
+    game::chunk_store store;
+    std::vector<game::packed_chunk> chunks{make_chunk(0, 0, 1), make_chunk(1, 0, 2), make_chunk(2, 0, 1), make_chunk(3, 0, 1)};
+    store.intern(chunks);
+
+    REQUIRE(chunks[0].tiles == chunks[2].tiles);
+    REQUIRE(chunks[0].tiles == chunks[3].tiles);
+    REQUIRE(chunks[0].tiles != chunks[1].tiles);
+    REQUIRE(store.get_size() == 2);
+    REQUIRE(store.intern(make_chunk(5, 5, 2).tiles) == chunks[1].tiles);
+
+    // Tiles are released with their last chunk
+    chunks.erase(chunks.begin() + 1);
+    REQUIRE(store.get_size() == 1);
+    auto const new_tiles = make_chunk(0, 0, 2).tiles;
+    REQUIRE(store.intern(new_tiles) == new_tiles);
+}
+
+TEST_CASE("Setting a tile detaches only its chunk", "[game]") {
+    game::chunk_store store;
+    std::vector<game::packed_chunk> chunks{make_chunk(0, 0, 1), make_chunk(1, 0, 1)};
+    store.intern(chunks);
+    auto const shared = chunks[0].tiles;
+
+    game::set_tile(chunks[1], 3, game::tile{game::tile::id{9}});
+    REQUIRE(chunks[0].tiles == shared);
+    REQUIRE(chunks[1].tiles != shared);
+    REQUIRE(chunks[1].tiles->get_tile(3).data == game::tile::id{9});
+    REQUIRE(chunks[1].tiles->get_tile(2).data == game::tile::id{1});
+    REQUIRE(shared->get_tile(3).data == game::tile::id{1});
+
+    // Setting a tile to its value keeps the chunk shared
+    game::set_tile(chunks[0], 3, game::tile{game::tile::id{1}});
+    REQUIRE(chunks[0].tiles == shared);
+}
+
+TEST_CASE("Map chunks are shared across layers", "[game]") {
+    game::map map;
+    map.layers.push_back({game::layer::id_t{1}, game::layer::tile_data{{make_chunk(0, 0, 1), make_chunk(1, 0, 1)}}});
+    map.layers.push_back({game::layer::id_t{2}, game::layer::tile_data{{make_chunk(0, 0, 1)}}});
+    game::share_identical_chunks(map);
+
+    auto const& first = std::get<game::layer::tile_data>(map.layers[0].data).get_chunks();
+    auto const& second = std::get<game::layer::tile_data>(map.layers[1].data).get_chunks();
+    REQUIRE(first[0].tiles == first[1].tiles);
+    REQUIRE(first[0].tiles == second[0].tiles);
+
+    auto const report = game::get_memory_report(map);
+    REQUIRE(report.size() == 2);
+    REQUIRE(report[0].shared_chunks == 1);
+    REQUIRE(report[1].shared_chunks == 1);
+    REQUIRE(report[1].packed_bytes == sizeof(game::packed_chunk));
+}
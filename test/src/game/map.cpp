@@ -0,0 +1,97 @@
+#include <catch.hpp>
+
+#include <game/map.h>
+#include "game/test_chunks.h"
+
+#include <algorithm>
+
+namespace {
+    auto make_map(std::vector<game::packed_chunk> chunks) -> game::map {
+        game::map map;
+        map.layers.push_back({game::layer::id_t{1}, game::layer::tile_data{std::move(chunks)}});
+        map.layers.push_back({game::layer::id_t{2}, game::layer::object_data{}});
+        map.tilesets.push_back({"tileset.json", game::tile::id{1}});
+        return map;
+    }
+
+    auto has_change(game::map_changes const& changes, int x, int y) -> bool {
+        std::pair<std::size_t, math::vector2i> const change{0, element_multiply(math::vector2i{x, y}, game::tile_chunk::dimensions)};
+        return std::find(changes.changed_chunks.begin(), changes.changed_chunks.end(), change) != changes.changed_chunks.end();
+    }
+}
+
+TEST_CASE("Map update replaces only the changed chunks", "[game]") {
+    game::map map = make_map({make_chunk(0, 0, 1), make_chunk(1, 0, 2), make_chunk(2, 0, 3)});
+    auto const& chunks = std::get<game::layer::tile_data>(map.layers[0].data).get_chunks();
+
+    auto changes = game::update_map(map, make_map({make_chunk(0, 0, 1), make_chunk(1, 0, 5), make_chunk(2, 0, 3)}));
+    REQUIRE(!changes.structure_changed);
+    REQUIRE(!changes.chunks_moved);
+    REQUIRE(changes.changed_chunks.size() == 1);
+    REQUIRE(has_change(changes, 1, 0));
+    REQUIRE(chunks[0].tiles->get_tile(0).data == game::tile::id{1});
+    REQUIRE(chunks[1].tiles->get_tile(0).data == game::tile::id{5});
+
+    // Chunks added and removed
+    changes = game::update_map(map, make_map({make_chunk(0, 0, 1), make_chunk(2, 0, 3), make_chunk(0, 1, 4)}));
+    REQUIRE(!changes.structure_changed);
+    REQUIRE(changes.chunks_moved);
+    REQUIRE(changes.changed_chunks.size() == 2);
+    REQUIRE(has_change(changes, 1, 0));
+    REQUIRE(has_change(changes, 0, 1));
+    REQUIRE(chunks.size() == 3);
+    REQUIRE(chunks[0].tiles->get_tile(0).data == game::tile::id{1});
+    REQUIRE(chunks[2].position == element_multiply(math::vector2i{0, 1}, game::tile_chunk::dimensions));
+
+    REQUIRE(game::update_map(map, make_map({make_chunk(0, 0, 1), make_chunk(2, 0, 3), make_chunk(0, 1, 4)})).changed_chunks.empty());
+}
+
+TEST_CASE("Map update replaces maps of another structure", "[game]") {
+    game::map map = make_map({make_chunk(0, 0, 1)});
+    game::map updated = make_map({make_chunk(0, 0, 1)});
+    updated.tilesets.push_back({"other.json", game::tile::id{100}});
+
+    auto const changes = game::update_map(map, std::move(updated));
+    REQUIRE(changes.structure_changed);
+    REQUIRE(map.tilesets.size() == 2);
+}
+
+TEST_CASE("Layer tiles are found by position", "[game]") {
+    // A chunk left of the origin, with its last tile set apart
+    game::tile_chunk chunk{{-game::tile_chunk::dimensions.x, 0}, {}};
+    chunk.tiles.fill(game::tile{game::tile::id{4}});
+    chunk.tiles.back() = game::tile{game::tile::id{6}};
+    game::layer::tile_data const tiles({game::pack_chunk(chunk), make_chunk(0, 0, 2)});
+
+    REQUIRE(tiles.find_chunk({-1, 0}) == &tiles.get_chunks()[0]);
+    REQUIRE(tiles.find_chunk({0, 0}) == &tiles.get_chunks()[1]);
+    REQUIRE(tiles.find_chunk({0, -1}) == nullptr);
+    REQUIRE(tiles.get_tile({-1, 0}).data == game::tile::id{4});
+    REQUIRE(tiles.get_tile({-1, game::tile_chunk::dimensions.y - 1}).data == game::tile::id{6});
+    REQUIRE(tiles.get_tile({0, game::tile_chunk::dimensions.y - 1}).data == game::tile::id{2});
+    REQUIRE(tiles.get_tile({0, game::tile_chunk::dimensions.y}).data == game::tile::id::none);
+}
+
+TEST_CASE("Map tiles are found across layers", "[game]") {
+    game::map map = make_map({make_chunk(0, 0, 1), make_chunk(1, 0, 1)});
+    map.layers.push_back({game::layer::id_t{3}, game::layer::tile_data({make_chunk(1, 0, 3)})});
+
+    math::vector2i const tile{game::tile_chunk::dimensions.x + 2, 5};
+    REQUIRE(game::get_tile(map, 0, tile).data == game::tile::id{1});
+    REQUIRE(game::get_tile(map, 1, tile).data == game::tile::id::none);
+    REQUIRE(game::get_tile(map, 2, {0, 0}).data == game::tile::id::none);
+
+    auto const tiles = game::get_tiles(map, tile);
+    REQUIRE(tiles.size() == 2);
+    REQUIRE(tiles[0].layer_index == 0);
+    REQUIRE(tiles[0].value.data == game::tile::id{1});
+    REQUIRE(tiles[1].layer_index == 2);
+    REQUIRE(tiles[1].value.data == game::tile::id{3});
+
+    // Pixels left of a tile are in the tile before it
+    math::vector2i const pixel = element_multiply(tile, game::tile::dimensions);
+    REQUIRE(game::get_tiles_at_pixel(map, pixel).size() == 2);
+    REQUIRE(game::get_tiles_at_pixel(map, pixel + math::vector2i{game::tile::dimensions.x - 1, 0}).size() == 2);
+    REQUIRE(game::get_tile_at_pixel(map, 2, pixel - math::vector2i{game::tile::dimensions.x * 3, 0}).data == game::tile::id::none);
+    REQUIRE(game::get_tile_at_pixel(map, 0, {-1, 0}).data == game::tile::id::none);
+}
@@ -0,0 +1,94 @@
+#include <catch.hpp>
+
+#include <game/map_edit.h>
+
+namespace {
+    constexpr int chunk_width = game::tile_chunk::dimensions.x;
+
+    auto make_map() -> game::map {
+        game::tile_chunk chunk{{0, 0}, {}};
+        chunk.tiles.fill(game::tile{game::tile::id{1}});
+        game::map map;
+        map.layers.push_back({game::layer::id_t{1}, game::layer::tile_data({game::pack_chunk(chunk)})});
+        map.layers.push_back({game::layer::id_t{2}, game::layer::tile_data{}});
+        return map;
+    }
+
+    auto tile_at(game::map const& map, std::size_t layer_index, int x, int y) -> int {
+        return static_cast<int>(game::get_tile(map, layer_index, {x, y}).data);
+    }
+}
+
+TEST_CASE("Setting tiles marks their chunks dirty and adds to the journal", "[game]") {
+    game::map map = make_map();
+
+    REQUIRE(game::set_tile(map, 0, {3, 4}, game::tile{game::tile::id{2}}));
+    REQUIRE(!game::set_tile(map, 0, {3, 4}, game::tile{game::tile::id{2}}));
+    REQUIRE(game::set_tile(map, 0, {5, 4}, game::tile{game::tile::id{2}}));
+    // Setting a tile outside of the chunks adds a chunk, unless the tile is none
+    REQUIRE(!game::set_tile(map, 1, {-1, -1}, game::tile{game::tile::id::none}));
+    REQUIRE(game::set_tile(map, 1, {-1, -1}, game::tile{game::tile::id{3}}));
+    REQUIRE(tile_at(map, 0, 3, 4) == 2);
+    REQUIRE(tile_at(map, 1, -1, -1) == 3);
+    REQUIRE(tile_at(map, 1, -2, -1) == 0);
+
+    auto const edits = game::drain_edits(map);
+    REQUIRE(edits.changes.size() == 3);
+    REQUIRE(edits.changes[0].layer_index == 0);
+    REQUIRE(edits.changes[0].region.position == math::vector2i{3, 4});
+    REQUIRE(edits.changed_chunks.size() == 2);
+    REQUIRE(edits.changed_chunks[0] == std::pair<std::size_t, math::vector2i>{0, {0, 0}});
+    REQUIRE(edits.changed_chunks[1] == std::pair<std::size_t, math::vector2i>{1, {-chunk_width, -game::tile_chunk::dimensions.y}});
+
+    auto const drained = game::drain_edits(map);
+    REQUIRE(drained.changes.empty());
+    REQUIRE(drained.changed_chunks.empty());
+}
+
+TEST_CASE("Filled rectangles span chunks", "[game]") {
+    game::map map = make_map();
+    game::tile const wall{game::tile::id{5}};
+    game::fill_rect(map, 0, {{-chunk_width, 2}, {chunk_width * 3, 3}}, wall);
+
+    REQUIRE(tile_at(map, 0, -chunk_width, 2) == 5);
+    REQUIRE(tile_at(map, 0, 0, 4) == 5);
+    REQUIRE(tile_at(map, 0, chunk_width * 2 - 1, 4) == 5);
+    REQUIRE(tile_at(map, 0, 0, 5) == 1);
+    REQUIRE(tile_at(map, 0, chunk_width * 2, 4) == 0);
+    REQUIRE(game::drain_edits(map).changed_chunks.size() == 3);
+
+    // Covered chunks share their tiles, and filling them again changes nothing
+    game::fill_rect(map, 1, {{0, 0}, {chunk_width * 2, game::tile_chunk::dimensions.y}}, wall);
+    auto const& chunks = std::get<game::layer::tile_data>(map.layers[1].data).get_chunks();
+    REQUIRE(chunks.size() == 2);
+    REQUIRE(chunks[0].tiles == chunks[1].tiles);
+    game::drain_edits(map);
+    game::fill_rect(map, 1, {{0, 0}, {chunk_width, 1}}, wall);
+    auto const edits = game::drain_edits(map);
+    REQUIRE(edits.changes.empty());
+    REQUIRE(edits.changed_chunks.empty());
+
+    // Clearing tiles without chunks adds none
+    game::fill_rect(map, 1, {{-100, -100}, {50, 50}}, game::tile{game::tile::id::none});
+    REQUIRE(chunks.size() == 2);
+}
+
+TEST_CASE("Copied regions may overlap", "[game]") {
+    game::map map = make_map();
+    for(int x = 0; x < 4; ++x) {
+        game::set_tile(map, 0, {x, 0}, game::tile{static_cast<game::tile::id>(10 + x)});
+    }
+
+    // Shifted right by two, over the chunk boundary
+    game::copy_region(map, 0, {{0, 0}, {4, 1}}, 0, {2, 0});
+    REQUIRE(tile_at(map, 0, 0, 0) == 10);
+    REQUIRE(tile_at(map, 0, 2, 0) == 10);
+    REQUIRE(tile_at(map, 0, 5, 0) == 13);
+
+    game::copy_region(map, 0, {{chunk_width - 2, 0}, {4, 2}}, 1, {-2, 0});
+    REQUIRE(tile_at(map, 1, -2, 0) == 1);
+    REQUIRE(tile_at(map, 1, -1, 1) == 1);
+    // Tiles outside of the chunks are copied as none
+    REQUIRE(tile_at(map, 1, 0, 0) == 0);
+    REQUIRE(std::get<game::layer::tile_data>(map.layers[1].data).get_chunks().size() == 1);
+}
@@ -0,0 +1,127 @@
+#include <catch.hpp>
+
+#include <game/map_edit.h>
+#include <game/map_layout.h>
+#include <math/space_filling_curve.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+TEST_CASE("Space filling curves keep neighbors together", "[math]") {
+    REQUIRE(math::get_z_order_index({0, 0}) == 0);
+    REQUIRE(math::get_z_order_index({1, 0}) == 1);
+    REQUIRE(math::get_z_order_index({0, 1}) == 2);
+    REQUIRE(math::get_z_order_index({3, 3}) == 15);
+    REQUIRE(math::get_z_order_index({4, 0}) == 16);
+
+    // The Hilbert curve walks aligned squares whole, going from a point to one of its neighbors
+    for(int const first : {-16, 0}) {
+        std::vector<std::pair<std::uint64_t, math::vector2i>> points;
+        for(int y = first; y < first + 16; ++y) {
+            for(int x = first; x < first + 16; ++x) {
+                points.emplace_back(math::get_hilbert_index({x, y}), math::vector2i{x, y});
+            }
+        }
+        std::sort(points.begin(), points.end(), [] (auto const& lhs, auto const& rhs) { return lhs.first < rhs.first; });
+        for(std::size_t i = 1; i < points.size(); ++i) {
+            REQUIRE(points[i].first == points[i - 1].first + 1);
+            math::vector2i const step = points[i].second - points[i - 1].second;
+            REQUIRE(std::abs(step.x) + std::abs(step.y) == 1);
+        }
+    }
+}
+
+TEST_CASE("Tile layouts only show in the encoding", "[game]") {
+    game::tile_chunk chunk{};
+    for(std::size_t i = 0; i < game::tile_chunk::tile_count; ++i) {
+        chunk.tiles[i] = game::tile{static_cast<game::tile::id>(i % 40 + 1)};
+    }
+    game::packed_tiles const row_major(chunk.tiles.data());
+    game::packed_tiles const z_order(chunk.tiles.data(), game::tile_layout::z_order);
+    REQUIRE(z_order.get_layout() == game::tile_layout::z_order);
+    REQUIRE(z_order != row_major);
+
+    game::tile_chunk decoded{};
+    z_order.decode(decoded.tiles.data());
+    for(std::size_t i = 0; i < game::tile_chunk::tile_count; ++i) {
+        REQUIRE(z_order.get_tile(i).data == chunk.tiles[i].data);
+        REQUIRE(decoded.tiles[i].data == chunk.tiles[i].data);
+    }
+
+    // The top left quarter of the chunk in a tile of its own is a single run in Z-order, and a run per row otherwise
+    chunk.tiles.fill(game::tile{game::tile::id{1}});
+    for(int y = 0; y < game::tile_chunk::dimensions.y / 2; ++y) {
+        for(int x = 0; x < game::tile_chunk::dimensions.x / 2; ++x) {
+            chunk.tiles[static_cast<std::size_t>(y * game::tile_chunk::dimensions.x + x)] = game::tile{game::tile::id{2}};
+        }
+    }
+    REQUIRE(game::packed_tiles(chunk.tiles.data(), game::tile_layout::z_order).get_allocated_bytes() < game::packed_tiles(chunk.tiles.data()).get_allocated_bytes());
+
+    // Uniform tiles keep their layout, though it does not show in their encoding
+    chunk.tiles.fill(game::tile{game::tile::id{1}});
+    game::packed_tiles const uniform(chunk.tiles.data(), game::tile_layout::z_order);
+    REQUIRE(uniform.get_layout() == game::tile_layout::z_order);
+    REQUIRE(uniform.get_allocated_bytes() == game::packed_tiles(chunk.tiles.data()).get_allocated_bytes());
+    REQUIRE(game::packed_tiles(game::tile_layout::z_order).get_layout() == game::tile_layout::z_order);
+}
+
+TEST_CASE("Map layouts keep the tiles and their sharing", "[game]") {
+    game::tile_chunk varied{};
+    for(std::size_t i = 0; i < game::tile_chunk::tile_count; ++i) {
+        varied.tiles[i] = game::tile{static_cast<game::tile::id>(i % 3 + 1)};
+    }
+    auto const shared = game::pack_chunk(varied).tiles;
+    std::vector<game::packed_chunk> chunks;
+    for(math::vector2i const position : {math::vector2i{3, 3}, math::vector2i{0, 0}, math::vector2i{-1, 0}, math::vector2i{0, 1}}) {
+        chunks.push_back({element_multiply(position, game::tile_chunk::dimensions), shared});
+    }
+    game::map map;
+    map.layers.push_back({game::layer::id_t{1}, game::layer::tile_data(std::move(chunks))});
+    math::vector2i const probe{game::tile_chunk::dimensions.x * 3 + 5, game::tile_chunk::dimensions.y * 3 + 2};
+    auto const before = game::get_tile(map, 0, probe);
+
+    game::set_layout(map, {game::tile_layout::z_order, true});
+    auto const& sorted = std::get<game::layer::tile_data>(map.layers[0].data).get_chunks();
+    REQUIRE(sorted.size() == 4);
+    for(std::size_t i = 1; i < sorted.size(); ++i) {
+        REQUIRE(math::get_hilbert_index(game::get_chunk_coordinates(sorted[i - 1].position)) < math::get_hilbert_index(game::get_chunk_coordinates(sorted[i].position)));
+        REQUIRE(sorted[i].tiles == sorted[0].tiles);
+    }
+    REQUIRE(sorted[0].tiles->get_layout() == game::tile_layout::z_order);
+    REQUIRE(game::get_tile(map, 0, probe).data == before.data);
+
+    // Edited chunks keep their layout
+    REQUIRE(game::set_tile(map, 0, sorted[0].position, game::tile{game::tile::id{9}}));
+    REQUIRE(sorted[0].tiles != sorted[1].tiles);
+    REQUIRE(sorted[0].tiles->get_layout() == game::tile_layout::z_order);
+}
+
+TEST_CASE("Edits keep the layout of the map", "[game]") {
+    game::tile_chunk uniform{};
+    uniform.tiles.fill(game::tile{game::tile::id{1}});
+    game::map map;
+    map.layers.push_back({game::layer::id_t{1}, game::layer::tile_data({game::pack_chunk(uniform)})});
+    game::set_layout(map, {game::tile_layout::z_order, false});
+    auto const& tiles = std::get<game::layer::tile_data>(map.layers[0].data);
+    REQUIRE(tiles.get_layout() == game::tile_layout::z_order);
+    REQUIRE(tiles.get_chunks()[0].tiles->get_layout() == game::tile_layout::z_order);
+
+    // A tile set in a uniform chunk
+    REQUIRE(game::set_tile(map, 0, {1, 2}, game::tile{game::tile::id{2}}));
+    REQUIRE(tiles.get_chunks()[0].tiles->get_encoding() != game::packed_tiles::encoding::uniform);
+    REQUIRE(tiles.get_chunks()[0].tiles->get_layout() == game::tile_layout::z_order);
+    REQUIRE(game::get_tile(map, 0, {1, 2}).data == game::tile::id{2});
+
+    // A tile set where there was no chunk
+    math::vector2i const outside{game::tile_chunk::dimensions.x + 3, 1};
+    REQUIRE(game::set_tile(map, 0, outside, game::tile{game::tile::id{3}}));
+    REQUIRE(tiles.get_chunks().size() == 2);
+    REQUIRE(tiles.get_chunks()[1].tiles->get_layout() == game::tile_layout::z_order);
+    REQUIRE(game::get_tile(map, 0, outside).data == game::tile::id{3});
+
+    // Chunks a fill covers whole
+    game::fill_rect(map, 0, {{0, game::tile_chunk::dimensions.y}, game::tile_chunk::dimensions}, game::tile{game::tile::id{4}});
+    REQUIRE(tiles.get_chunks().size() == 3);
+    REQUIRE(tiles.get_chunks()[2].tiles->get_layout() == game::tile_layout::z_order);
+}
@@ -0,0 +1,143 @@
+#include <catch.hpp>
+
+#include <game/layer.h>
+#include <game/packed_chunk.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace {
+    void require_round_trip(game::tile_chunk const& chunk, game::packed_tiles::encoding encoding) {
+        game::packed_chunk const packed = game::pack_chunk(chunk);
+        REQUIRE(packed.tiles->get_encoding() == encoding);
+        REQUIRE(packed.position == chunk.position);
+
+        game::tile_chunk const unpacked = game::unpack_chunk(packed);
+        for(std::size_t i = 0; i < game::tile_chunk::tile_count; ++i) {
+            REQUIRE(unpacked.tiles[i].data == chunk.tiles[i].data);
+            REQUIRE(packed.tiles->get_tile(i).data == chunk.tiles[i].data);
+        }
+        REQUIRE(*game::pack_chunk(unpacked).tiles == *packed.tiles);
+        REQUIRE(game::pack_chunk(unpacked).tiles->get_hash() == packed.tiles->get_hash());
+    }
+}
+
+TEST_CASE("Packed chunks pick their encoding from their tiles", "[game]") {
+    game::tile_chunk chunk{{16, -32}, {}};
+
+    SECTION("Empty") {
+        require_round_trip(chunk, game::packed_tiles::encoding::uniform);
+        REQUIRE(game::pack_chunk(chunk).tiles->is_empty());
+        REQUIRE(game::packed_tiles().is_empty());
+    }
+
+    SECTION("Uniform") {
+        chunk.tiles.fill(game::tile{game::tile::id{7}});
+        require_round_trip(chunk, game::packed_tiles::encoding::uniform);
+        REQUIRE(!game::pack_chunk(chunk).tiles->is_empty());
+    }
+
+    SECTION("Runs") {
+        // Four horizontal bands, with a flipped tile
+        for(std::size_t i = 0; i < game::tile_chunk::tile_count; ++i) {
+            chunk.tiles[i] = game::tile{static_cast<game::tile::id>(i / (game::tile_chunk::tile_count / 4) + 1)};
+        }
+        chunk.tiles[game::tile_chunk::tile_count / 2 - 3] = game::tile{static_cast<game::tile::id>(game::tile::flip_horizontal | 2)};
+        require_round_trip(chunk, game::packed_tiles::encoding::palette_runs);
+    }
+
+    SECTION("Palette") {
+        for(std::size_t i = 0; i < game::tile_chunk::tile_count; ++i) {
+            chunk.tiles[i] = game::tile{static_cast<game::tile::id>(i * 7 % 16)};
+        }
+        require_round_trip(chunk, game::packed_tiles::encoding::palette);
+    }
+
+    SECTION("Raw") {
+        for(std::size_t i = 0; i < game::tile_chunk::tile_count; ++i) {
+            chunk.tiles[i] = game::tile{static_cast<game::tile::id>(i % 17)};
+        }
+        require_round_trip(chunk, game::packed_tiles::encoding::raw);
+    }
+}
+
+TEST_CASE("Packed chunks take less memory than unpacked chunks", "[game]") {
+    game::tile_chunk chunk{};
+    for(std::size_t i = 0; i < game::tile_chunk::tile_count; ++i) {
+        chunk.tiles[i] = game::tile{static_cast<game::tile::id>(i % 3 + 1)};
+    }
+    REQUIRE(game::pack_chunk(chunk).tiles->get_allocated_bytes() * 4 < sizeof(game::tile_chunk::tiles));
+    // With the fixed costs of a chunk, which small chunks do not make up for
+    if constexpr(game::tile_chunk::tile_count >= 256) {
+        REQUIRE(game::get_memory_usage(game::pack_chunk(chunk)) * 4 < sizeof(game::tile_chunk));
+    }
+
+    chunk.tiles.fill(game::tile{game::tile::id{1}});
+    REQUIRE(game::pack_chunk(chunk).tiles->get_allocated_bytes() * 10 < sizeof(game::tile_chunk::tiles));
+    if constexpr(game::tile_chunk::tile_count >= 256) {
+        REQUIRE(game::get_memory_usage(game::pack_chunk(chunk)) * 10 < sizeof(game::tile_chunk));
+    }
+}
+
+TEST_CASE("Empty chunks are erased", "[game]") {
+    game::tile_chunk filled{{0, 0}, {}};
+    filled.tiles.fill(game::tile{game::tile::id{1}});
+    std::vector<game::packed_chunk> chunks{game::pack_chunk(game::tile_chunk{{game::tile_chunk::dimensions.x, 0}, {}}), game::pack_chunk(filled), game::pack_chunk(game::tile_chunk{{32, 0}, {}})};
+    game::erase_empty_chunks(chunks);
+    REQUIRE(chunks.size() == 1);
+    REQUIRE(chunks[0].position == math::vector2i{0, 0});
+}
+
+TEST_CASE("Regions are packed into the chunks they overlap", "[game]") {
+    // Across three chunks of a row, starting inside the first one
+    game::tile_rect const region{{-4, 8}, {game::tile_chunk::dimensions.x + 8, 4}};
+    std::vector<game::tile> tiles(static_cast<std::size_t>(region.size.x * region.size.y));
+    for(std::size_t i = 0; i < tiles.size(); ++i) {
+        tiles[i] = game::tile{static_cast<game::tile::id>(i + 1)};
+    }
+
+    std::vector<game::packed_chunk> chunks;
+    game::pack_region(region, tiles.data(), chunks);
+    // Three chunks of a row at the default size, more rows when the chunks are smaller than the region
+    math::vector2i const first = game::get_chunk_coordinates(region.position);
+    math::vector2i const last = game::get_chunk_coordinates(region.position + region.size - math::vector2i{1, 1});
+    REQUIRE(last.x - first.x == 2);
+    REQUIRE(chunks.size() == static_cast<std::size_t>((last.x - first.x + 1) * (last.y - first.y + 1)));
+    for(game::packed_chunk const& chunk : chunks) {
+        game::tile_chunk const unpacked = game::unpack_chunk(chunk);
+        for(std::size_t i = 0; i < game::tile_chunk::tile_count; ++i) {
+            math::vector2i const position = chunk.position + math::vector2i{static_cast<int>(i) % game::tile_chunk::dimensions.x, static_cast<int>(i) / game::tile_chunk::dimensions.x};
+            math::vector2i const in_region = position - region.position;
+            bool const inside = in_region.x >= 0 && in_region.x < region.size.x && in_region.y >= 0 && in_region.y < region.size.y;
+            game::tile::id const expected = inside ? tiles[static_cast<std::size_t>(in_region.y * region.size.x + in_region.x)].data : game::tile::id::none;
+            REQUIRE(unpacked.tiles[i].data == expected);
+        }
+    }
+    REQUIRE(chunks.front().position == element_multiply(first, game::tile_chunk::dimensions));
+    REQUIRE(chunks.back().position == element_multiply(last, game::tile_chunk::dimensions));
+
+    // A region over exactly one chunk gives that chunk
+    chunks.clear();
+    game::pack_region({{0, -game::tile_chunk::dimensions.y}, game::tile_chunk::dimensions}, tiles.data(), chunks);
+    REQUIRE(chunks.size() == 1);
+    REQUIRE(chunks[0].position == math::vector2i{0, -game::tile_chunk::dimensions.y});
+    REQUIRE(chunks[0].tiles->get_tile(game::tile_chunk::tile_count - 1).data == tiles[game::tile_chunk::tile_count - 1].data);
+}
+
+TEST_CASE("Chunks at the same position are merged", "[game]") {
+    game::tile_chunk left{{0, 0}, {}}, right{{0, 0}, {}};
+    for(std::size_t i = 0; i < game::tile_chunk::tile_count; ++i) {
+        bool const is_left = static_cast<int>(i) % game::tile_chunk::dimensions.x < game::tile_chunk::dimensions.x / 2;
+        (is_left ? left : right).tiles[i] = game::tile{is_left ? game::tile::id{1} : game::tile::id{2}};
+    }
+    left.tiles[game::tile_chunk::tile_count - 1] = game::tile{game::tile::id{3}};
+
+    game::layer::tile_data const data{{game::pack_chunk(left), game::pack_chunk(game::tile_chunk{{game::tile_chunk::dimensions.x, 0}, {}}), game::pack_chunk(right)}};
+    REQUIRE(data.get_chunks().size() == 2);
+    REQUIRE(data.get_chunks()[0].position == math::vector2i{0, 0});
+    REQUIRE(data.get_tile({0, 0}).data == game::tile::id{1});
+    REQUIRE(data.get_tile({game::tile_chunk::dimensions.x - 1, 0}).data == game::tile::id{2});
+    // Later chunks win, except where they have no tile
+    REQUIRE(data.get_tile(game::tile_chunk::dimensions - math::vector2i{1, 1}).data == game::tile::id{2});
+    REQUIRE(data.find_chunk({1, 0}) != nullptr);
+}
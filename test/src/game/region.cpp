@@ -0,0 +1,101 @@
+#include <catch.hpp>
+
+#include <game/chunk_store.h>
+#include <game/region.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace {
+    // Tile id telling the position of the tile, for tiles in [-64, 64)
+    auto get_position_id(math::vector2i position) -> game::tile::id {
+        return static_cast<game::tile::id>(1 + (position.x + 64) + (position.y + 64) * 128);
+    }
+
+    // Chunks at chunk coordinates -2 to 1 on both axes, but the one at (1, -2), with their tiles telling their position
+    auto make_tiles() -> game::layer::tile_data {
+        std::vector<game::packed_chunk> chunks;
+        for(int y = -2; y < 2; ++y) {
+            for(int x = -2; x < 2; ++x) {
+                if(x == 1 && y == -2) {
+                    continue;
+                }
+                game::tile_chunk chunk{element_multiply(math::vector2i{x, y}, game::tile_chunk::dimensions), {}};
+                for(std::size_t i = 0; i < game::tile_chunk::tile_count; ++i) {
+                    math::vector2i const offset{static_cast<int>(i) % game::tile_chunk::dimensions.x, static_cast<int>(i) / game::tile_chunk::dimensions.x};
+                    chunk.tiles[i] = game::tile{get_position_id(chunk.position + offset)};
+                }
+                chunks.push_back(game::pack_chunk(chunk));
+            }
+        }
+        return game::layer::tile_data(std::move(chunks));
+    }
+}
+
+TEST_CASE("Region views walk the tiles of their region chunk by chunk", "[game]") {
+    game::layer::tile_data const tiles = make_tiles();
+    game::tile_rect const region{{-20, -20}, {45, 30}};
+
+    std::vector<math::vector2i> seen;
+    for(game::tile_span const span : game::region_view(tiles, region)) {
+        // Spans stay inside a chunk
+        REQUIRE(span.size() > 0);
+        REQUIRE(game::get_chunk_coordinates(span.position) == game::get_chunk_coordinates(span.position + math::vector2i{static_cast<int>(span.size()) - 1, 0}));
+        for(std::size_t i = 0; i < span.size(); ++i) {
+            math::vector2i const position = span.position + math::vector2i{static_cast<int>(i), 0};
+            REQUIRE(span[i].data == get_position_id(position));
+            seen.push_back(position);
+        }
+    }
+
+    // Every tile of the region but those of the absent chunk, each once
+    std::size_t expected = 0;
+    for(int y = region.position.y; y < region.position.y + region.size.y; ++y) {
+        for(int x = region.position.x; x < region.position.x + region.size.x; ++x) {
+            if(tiles.find_chunk(game::get_chunk_coordinates({x, y})) != nullptr) {
+                ++expected;
+                REQUIRE(std::count(seen.begin(), seen.end(), math::vector2i{x, y}) == 1);
+            }
+        }
+    }
+    REQUIRE(seen.size() == expected);
+
+    std::size_t span_count = 0;
+    for(game::tile_span const span : game::region_view(tiles, {{0, 0}, {0, 5}})) {
+        span_count += span.size();
+    }
+    REQUIRE(span_count == 0);
+}
+
+TEST_CASE("Mutable region views write back only the chunks they changed", "[game]") {
+    game::tile_chunk filled{};
+    filled.tiles.fill(game::tile{game::tile::id{1}});
+    std::vector<game::packed_chunk> chunks{game::pack_chunk(filled), game::pack_chunk(filled), game::pack_chunk(filled)};
+    chunks[1].position = {game::tile_chunk::dimensions.x, 0};
+    chunks[2].position = {game::tile_chunk::dimensions.x * 2, 0};
+    game::chunk_store store;
+    store.intern(chunks);
+    game::layer::tile_data tiles(std::move(chunks));
+    auto const shared = tiles.get_chunks()[0].tiles;
+
+    // Over the first two chunks, only changing the second one
+    for(game::mutable_tile_span const span : game::mutable_region_view(tiles, {{0, 2}, {game::tile_chunk::dimensions.x * 2, 3}})) {
+        if(span.position.x >= game::tile_chunk::dimensions.x) {
+            std::fill(span.begin(), span.end(), game::tile{game::tile::id{2}});
+        }
+    }
+    REQUIRE(tiles.get_chunks()[0].tiles == shared);
+    REQUIRE(tiles.get_chunks()[1].tiles != shared);
+    REQUIRE(tiles.get_chunks()[2].tiles == shared);
+    REQUIRE(tiles.get_tile({game::tile_chunk::dimensions.x, 1}).data == game::tile::id{1});
+    REQUIRE(tiles.get_tile({game::tile_chunk::dimensions.x, 2}).data == game::tile::id{2});
+    REQUIRE(tiles.get_tile({game::tile_chunk::dimensions.x * 2 - 1, 4}).data == game::tile::id{2});
+    REQUIRE(tiles.get_tile({game::tile_chunk::dimensions.x * 2 - 1, 5}).data == game::tile::id{1});
+
+    // Leaving the walk early still writes the chunk back
+    {
+        game::mutable_region_view view(tiles, {{game::tile_chunk::dimensions.x * 2, 0}, {1, 1}});
+        (*view.begin())[0] = game::tile{game::tile::id{3}};
+    }
+    REQUIRE(tiles.get_tile({game::tile_chunk::dimensions.x * 2, 0}).data == game::tile::id{3});
+}
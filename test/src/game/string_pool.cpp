@@ -0,0 +1,48 @@
+#include <catch.hpp>
+
+#include <game/string_pool.h>
+
+#include <string>
+
+TEST_CASE("String pool interns each string once", "[game]") {
+    game::string_pool pool;
+    REQUIRE(pool.find("") == game::string_id::empty);
+    REQUIRE(pool.get(game::string_id::empty).empty());
+
+    game::string_id const area = pool.intern("area");
+    game::string_id const waypoint = pool.intern(std::string("way") + "point");
+    REQUIRE(area != waypoint);
+    REQUIRE(pool.intern(std::string("ar") + "ea") == area);
+    REQUIRE(pool.get(area) == "area");
+    REQUIRE(pool.find("waypoint") == waypoint);
+    REQUIRE(!pool.find("spawn"));
+    REQUIRE(pool.get_size() == 3);
+
+    // Handles stay valid as the pool grows
+    for(int i = 0; i < 1000; ++i) {
+        pool.intern("string " + std::to_string(i));
+    }
+    REQUIRE(pool.get(area) == "area");
+    REQUIRE(pool.intern("string 999") == pool.find("string 999"));
+
+    // Copies and moves keep the handles
+    game::string_pool const copy = pool;
+    REQUIRE(copy.find("waypoint") == waypoint);
+    game::string_pool const moved = std::move(pool);
+    REQUIRE(moved.get(area) == "area");
+    REQUIRE(moved.find("string 500") == copy.find("string 500"));
+
+    // The moved-from pools are left as new ones
+    REQUIRE(pool.get_size() == 1);
+    REQUIRE(pool.find("") == game::string_id::empty);
+    REQUIRE(!pool.find("area"));
+    REQUIRE(pool.intern("spawn") == static_cast<game::string_id>(1));
+
+    game::string_pool assigned;
+    game::string_pool source = copy;
+    assigned = std::move(source);
+    REQUIRE(assigned.find("waypoint") == waypoint);
+    REQUIRE(source.get_size() == 1);
+    REQUIRE(source.get(game::string_id::empty).empty());
+    REQUIRE(source.find("") == game::string_id::empty);
+}
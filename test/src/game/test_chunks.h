@@ -0,0 +1,10 @@
+#pragma once
+
+#include <game/packed_chunk.h>
+
+// Chunk at chunk coordinates (x, y), filled with tile id
+inline auto make_chunk(int x, int y, int id) -> game::packed_chunk {
+    game::tile_chunk chunk{element_multiply(math::vector2i{x, y}, game::tile_chunk::dimensions), {}};
+    chunk.tiles.fill(game::tile{static_cast<game::tile::id>(id)});
+    return game::pack_chunk(chunk);
+}
\ No newline at end of file
@@ -0,0 +1,70 @@
+#include <catch.hpp>
+
+#include <math/skyline_packer.h>
+
+#include <vector>
+
+namespace {
+    struct packed_rect {
+        math::vector2i position;
+        math::vector2i size;
+    };
+
+    auto overlaps(packed_rect const& l, packed_rect const& r) -> bool {
+        return l.position.x < r.position.x + r.size.x && r.position.x < l.position.x + l.size.x
+            && l.position.y < r.position.y + r.size.y && r.position.y < l.position.y + l.size.y;
+    }
+}
+
+TEST_CASE("Skyline packer fills its area exactly", "[math]") {
+    math::skyline_packer packer({64, 64});
+    std::vector<packed_rect> packed;
+    for(int i = 0; i < 16; ++i) {
+        auto const position = packer.insert({16, 16});
+        REQUIRE(position);
+        packed.push_back({*position, {16, 16}});
+    }
+    REQUIRE(!packer.insert({1, 1}));
+
+    for(std::size_t i = 0; i < packed.size(); ++i) {
+        for(std::size_t j = i + 1; j < packed.size(); ++j) {
+            REQUIRE(!overlaps(packed[i], packed[j]));
+        }
+    }
+}
+
+TEST_CASE("Skyline packer places mixed sizes without overlap", "[math]") {
+    math::skyline_packer packer({256, 256});
+    std::vector<packed_rect> packed;
+    int area = 0;
+    for(int i = 0; i < 200; ++i) {
+        math::vector2i const size{8 + (i * 37) % 56, 8 + (i * 23) % 40};
+        if(auto const position = packer.insert(size)) {
+            packed.push_back({*position, size});
+            area += size.x * size.y;
+        }
+    }
+
+    REQUIRE(packed.size() > 20);
+    // Skyline packing of these sizes wastes little of the area
+    REQUIRE(area > 256 * 256 * 3 / 4);
+    for(std::size_t i = 0; i < packed.size(); ++i) {
+        REQUIRE(packed[i].position.x >= 0);
+        REQUIRE(packed[i].position.y >= 0);
+        REQUIRE(packed[i].position.x + packed[i].size.x <= 256);
+        REQUIRE(packed[i].position.y + packed[i].size.y <= 256);
+        for(std::size_t j = i + 1; j < packed.size(); ++j) {
+            REQUIRE(!overlaps(packed[i], packed[j]));
+        }
+    }
+}
+
+TEST_CASE("Skyline packer rejects rectangles larger than its area", "[math]") {
+    math::skyline_packer packer({128, 64});
+    REQUIRE(!packer.insert({129, 1}));
+    REQUIRE(!packer.insert({1, 65}));
+    REQUIRE(!packer.insert({0, 10}));
+    auto const position = packer.insert({128, 64});
+    REQUIRE(position);
+    REQUIRE(*position == math::vector2i{0, 0});
+}
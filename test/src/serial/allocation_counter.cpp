@@ -0,0 +1,61 @@
+#include "serial/allocation_counter.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#if defined(_WIN32)
+#include <malloc.h>
+#endif
+
+// The replacement operators are alone in their file, so that they are not inlined where the compiler could pair an allocation
+// with the release of another overload
+
+namespace {
+    std::atomic<std::size_t> allocation_count{0};
+
+    auto counted(void* block) -> void* {
+        if(block == nullptr) {
+            throw std::bad_alloc();
+        }
+        allocation_count.fetch_add(1, std::memory_order_relaxed);
+        return block;
+    }
+
+    auto aligned_allocate(std::size_t size, std::align_val_t alignment) -> void* {
+        auto const bytes = static_cast<std::size_t>(alignment);
+#if defined(_WIN32)
+        return _aligned_malloc(std::max<std::size_t>(size, 1), bytes);
+#else
+        // aligned_alloc takes a multiple of the alignment
+        return std::aligned_alloc(bytes, (std::max<std::size_t>(size, 1) + bytes - 1) / bytes * bytes);
+#endif
+    }
+
+    void aligned_free(void* p) noexcept {
+#if defined(_WIN32)
+        _aligned_free(p);
+#else
+        std::free(p);
+#endif
+    }
+}
+
+auto get_allocation_count() noexcept -> std::size_t {
+    return allocation_count.load();
+}
+
+auto operator new(std::size_t size) -> void* { return counted(std::malloc(std::max<std::size_t>(size, 1))); }
+auto operator new[](std::size_t size) -> void* { return counted(std::malloc(std::max<std::size_t>(size, 1))); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+// Memory resources allocate with the alignment they are asked for
+auto operator new(std::size_t size, std::align_val_t alignment) -> void* { return counted(aligned_allocate(size, alignment)); }
+auto operator new[](std::size_t size, std::align_val_t alignment) -> void* { return counted(aligned_allocate(size, alignment)); }
+void operator delete(void* p, std::align_val_t) noexcept { aligned_free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { aligned_free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { aligned_free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { aligned_free(p); }
@@ -0,0 +1,7 @@
+#pragma once
+
+#include <cstddef>
+
+// Allocations made through the global operator new since the start of the program. Replacing the operator applies to the whole
+// executable: only the allocation tests are built with it
+auto get_allocation_count() noexcept -> std::size_t;
\ No newline at end of file
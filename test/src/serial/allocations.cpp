@@ -0,0 +1,130 @@
+#include <catch.hpp>
+
+#include <serial/binary_map.h>
+#include <serial/tiled_parse.h>
+#include "serial/allocation_counter.h"
+
+#include <nlohmann/json.hpp>
+
+#include <cstring>
+#include <string>
+
+namespace {
+    // Object layer with points or a long text in every object, so that nothing fits in the small string buffer. Names come from a
+    // small vocabulary, as in the maps
+    auto make_object_layer(game::map& map, int id, std::size_t object_count) -> game::layer {
+        game::layer::object_data data;
+        for(std::size_t i = 0; i < object_count; ++i) {
+            game::object object{};
+            object.id = static_cast<game::object::identifier>(i + 1);
+            object.name = map.strings.intern("an object name longer than the small string buffer " + std::to_string(i % 8));
+            object.type = map.strings.intern("an object type longer than the small string buffer");
+            if(i % 2 == 0) {
+                game::polygon_data polygon;
+                polygon.points = {{0, 0}, {16, 0}, {16, 16}, {0, 16}};
+                object.kind_data = std::move(polygon);
+            } else {
+                game::text_data text;
+                text.text = "a text longer than the small string buffer of the standard library";
+                text.font = map.strings.intern("a font family longer than the small string buffer");
+                text.valign = game::text_data::vertical_alignment::top;
+                text.halign = game::text_data::horizontal_alignment::left;
+                object.kind_data = std::move(text);
+            }
+            data.push_back(std::move(object));
+        }
+        return {game::layer::id_t{id}, std::move(data)};
+    }
+
+    // Allocations made by loading a compiled map of two object layers of 'object_count' objects each
+    auto count_load_allocations(std::size_t object_count) -> std::size_t {
+        game::map map;
+        map.layers.push_back(make_object_layer(map, 1, object_count));
+        map.layers.push_back(make_object_layer(map, 2, object_count));
+        auto const bytes = serial::compile_binary_map(map);
+        REQUIRE(bytes);
+        std::vector<std::uint64_t> storage((bytes->size() + 7) / 8);
+        std::memcpy(storage.data(), bytes->data(), bytes->size());
+        auto const view = serial::read_binary_map(reinterpret_cast<std::byte const*>(storage.data()), bytes->size());
+        REQUIRE(view);
+
+        std::size_t const before = get_allocation_count();
+        game::map const loaded = serial::load_binary_map(*view);
+        std::size_t const count = get_allocation_count() - before;
+
+        REQUIRE(loaded.layers.size() == 2);
+        auto const& objects = std::get<game::layer::object_data>(loaded.layers[1].data);
+        REQUIRE(objects.size() == object_count);
+        REQUIRE(loaded.strings.get(objects.get_names().back()) == map.strings.get(std::get<game::layer::object_data>(map.layers[1].data).get_names().back()));
+        return count;
+    }
+
+    // Tiled object layer of rectangles and texts, with the same long strings as make_object_layer
+    auto make_tiled_object_layer(int id, std::size_t object_count) -> nlohmann::json {
+        nlohmann::json objects = nlohmann::json::array();
+        for(std::size_t i = 0; i < object_count; ++i) {
+            nlohmann::json object = {
+                {"id", i + 1},
+                {"name", "an object name longer than the small string buffer " + std::to_string(i % 8)},
+                {"type", "an object type longer than the small string buffer"},
+                {"x", 16.0 * static_cast<double>(i)},
+                {"y", 0.0},
+                {"width", 16.0},
+                {"height", 16.0},
+            };
+            if(i % 2 != 0) {
+                object["text"] = {
+                    {"text", "a text longer than the small string buffer of the standard library"},
+                    {"fontfamily", "a font family longer than the small string buffer"},
+                };
+            }
+            objects.push_back(std::move(object));
+        }
+        return {{"id", id}, {"type", "objectgroup"}, {"objects", std::move(objects)}};
+    }
+
+    // Allocations made by converting the JSON document of a Tiled map of two object layers of 'object_count' objects each. The
+    // document is parsed before counting, so that only the conversion to a game::map is counted
+    auto count_parse_allocations(std::size_t object_count) -> std::size_t {
+        nlohmann::json const document = {
+            {"tiledversion", "1.2.2"},
+            {"infinite", true},
+            {"tilewidth", game::tile::dimensions.x},
+            {"tileheight", game::tile::dimensions.y},
+            {"renderorder", "right-down"},
+            {"layers", {make_tiled_object_layer(1, object_count), make_tiled_object_layer(2, object_count)}},
+            {"tilesets", nlohmann::json::array()},
+        };
+
+        std::size_t const before = get_allocation_count();
+        auto const parsed = serial::detail::parse_map(document);
+        std::size_t const count = get_allocation_count() - before;
+
+        REQUIRE(parsed);
+        REQUIRE(parsed->layers.size() == 2);
+        auto const& objects = std::get<game::layer::object_data>(parsed->layers[1].data);
+        REQUIRE(objects.size() == object_count);
+        REQUIRE(parsed->strings.get(objects.get_names().back()) == "an object name longer than the small string buffer " + std::to_string((object_count - 1) % 8));
+        return count;
+    }
+}
+
+TEST_CASE("Loaded objects are allocated from the arena of their map", "[serial]") {
+    std::size_t const few = count_load_allocations(16);
+    std::size_t const many = count_load_allocations(1024);
+
+    // The arena grows geometrically and the ten distinct strings are interned once: a handful of allocations per layer and
+    // string, not several per object
+    REQUIRE(few <= 40);
+    REQUIRE(many <= few + 16);
+}
+
+TEST_CASE("Parsed objects are allocated from the arena of their map", "[serial]") {
+    std::size_t const few = count_parse_allocations(16);
+    std::size_t const many = count_parse_allocations(1024);
+
+    // The layer vectors and the object arrays grow geometrically and the strings are interned once: the count does not grow
+    // with the objects
+    REQUIRE(few <= 64);
+    REQUIRE(many <= few + 16);
+}
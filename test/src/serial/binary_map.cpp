@@ -0,0 +1,168 @@
+#include <catch.hpp>
+
+#include <serial/binary_map.h>
+#include <serial/tiled.h>
+#include <sys/mapped_file.h>
+#include "serial/test_tiled_map.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <tuple>
+
+namespace {
+    constexpr std::size_t chunk_tile_count = game::tile_chunk::dimensions.x * game::tile_chunk::dimensions.y;
+
+    auto load_test_map(std::string_view map_string) -> game::map {
+        std::stringstream ss;
+        ss << map_string;
+        auto map = serial::load_tiled_json(ss);
+        REQUIRE(map);
+        return *std::move(map);
+    }
+
+    // Copies the bytes of a compiled map to 8 bytes aligned storage, as a mapped file would be
+    auto aligned_copy(std::vector<std::byte> const& bytes) -> std::vector<std::uint64_t> {
+        std::vector<std::uint64_t> result((bytes.size() + 7) / 8);
+        std::memcpy(result.data(), bytes.data(), bytes.size());
+        return result;
+    }
+
+    auto as_bytes(std::vector<std::uint64_t> const& storage) -> std::byte const* {
+        return reinterpret_cast<std::byte const*>(storage.data());
+    }
+
+    void require_same_tiles(game::layer::tile_data const& tiles, serial::binary_layer_view const& layer) {
+        REQUIRE(layer.get_type() == game::layer::type::tile);
+        REQUIRE(layer.get_chunk_count() == tiles.get_chunks().size());
+        for(game::packed_chunk const& packed : tiles.get_chunks()) {
+            game::tile_chunk const chunk = game::unpack_chunk(packed);
+            auto const view = layer.find_chunk(chunk.position);
+            REQUIRE(view);
+            REQUIRE(view->position == chunk.position);
+            REQUIRE(std::equal(chunk.tiles.begin(), chunk.tiles.end(), view->tiles, view->tiles + chunk_tile_count,
+                               [] (game::tile l, game::tile r) { return l.data == r.data; }));
+        }
+    }
+}
+
+TEST_CASE("Binary map views", "[serial]") {
+    game::map const map = load_test_map(test_tiled_map);
+    auto const bytes = serial::compile_binary_map(map);
+    REQUIRE(bytes);
+    auto const storage = aligned_copy(*bytes);
+
+    auto const view = serial::read_binary_map(as_bytes(storage), bytes->size());
+    REQUIRE(view);
+
+    REQUIRE(view->get_tileset_count() == map.tilesets.size());
+    for(std::size_t i = 0; i < map.tilesets.size(); ++i) {
+        REQUIRE(view->get_tileset(i).source == map.tilesets[i].source);
+        REQUIRE(view->get_tileset(i).starting_id == map.tilesets[i].starting_id);
+    }
+
+    REQUIRE(view->get_layer_count() == map.layers.size());
+    serial::binary_layer_view const layer = view->get_layer(0);
+    REQUIRE(layer.get_id() == map.layers[0].id);
+    require_same_tiles(std::get<game::layer::tile_data>(map.layers[0].data), layer);
+
+    // Chunks are sorted by row then column
+    for(std::size_t i = 1; i < layer.get_chunk_count(); ++i) {
+        auto const previous = layer.get_chunk(i - 1).position, current = layer.get_chunk(i).position;
+        REQUIRE(std::tie(previous.y, previous.x) < std::tie(current.y, current.x));
+    }
+    REQUIRE(!layer.find_chunk({1000, 1000}));
+}
+
+TEST_CASE("Binary map round trip", "[serial]") {
+    for(std::string_view const map_string : {test_tiled_map, test_tiled_object_map}) {
+        game::map const map = load_test_map(map_string);
+        auto const bytes = serial::compile_binary_map(map);
+        REQUIRE(bytes);
+        auto const storage = aligned_copy(*bytes);
+        auto const view = serial::read_binary_map(as_bytes(storage), bytes->size());
+        REQUIRE(view);
+
+        game::map const loaded = serial::load_binary_map(*view);
+        REQUIRE(loaded.layers.size() == map.layers.size());
+        for(std::size_t layer_index = 0; layer_index < map.layers.size(); ++layer_index) {
+            game::layer const& layer = map.layers[layer_index];
+            REQUIRE(loaded.layers[layer_index].id == layer.id);
+            REQUIRE(loaded.layers[layer_index].get_type() == layer.get_type());
+            if(layer.get_type() == game::layer::type::tile) {
+                require_same_tiles(std::get<game::layer::tile_data>(layer.data), view->get_layer(layer_index));
+                continue;
+            }
+
+            auto const& objects = std::get<game::layer::object_data>(layer.data);
+            auto const& loaded_objects = std::get<game::layer::object_data>(loaded.layers[layer_index].data);
+            REQUIRE(loaded_objects.size() == objects.size());
+            for(std::size_t i = 0; i < objects.size(); ++i) {
+                REQUIRE(loaded_objects.get_ids()[i] == objects.get_ids()[i]);
+                REQUIRE(loaded.strings.get(loaded_objects.get_names()[i]) == map.strings.get(objects.get_names()[i]));
+                REQUIRE(loaded.strings.get(loaded_objects.get_types()[i]) == map.strings.get(objects.get_types()[i]));
+                REQUIRE(loaded_objects.get_positions()[i] == objects.get_positions()[i]);
+                REQUIRE(loaded_objects.get_dimensions()[i] == objects.get_dimensions()[i]);
+                REQUIRE(loaded_objects.get_kinds()[i] == objects.get_kinds()[i]);
+                if(objects.get_kinds()[i] == game::object::kind::text) {
+                    auto const& text = objects.get_text(i);
+                    auto const& loaded_text = loaded_objects.get_text(i);
+                    REQUIRE(loaded_text.text == text.text);
+                    REQUIRE(loaded.strings.get(loaded_text.font) == map.strings.get(text.font));
+                    REQUIRE(loaded_text.color.r == text.color.r);
+                    REQUIRE(loaded_text.color.b == text.color.b);
+                    REQUIRE(loaded_text.halign == text.halign);
+                    REQUIRE(loaded_text.valign == text.valign);
+                    REQUIRE(loaded_text.bold == text.bold);
+                    REQUIRE(loaded_text.wrap == text.wrap);
+                    REQUIRE(loaded_text.italic == text.italic);
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("Binary map validation", "[serial]") {
+    auto const bytes = serial::compile_binary_map(load_test_map(test_tiled_map));
+    REQUIRE(bytes);
+
+    SECTION("Truncated") {
+        auto const storage = aligned_copy(*bytes);
+        REQUIRE(!serial::read_binary_map(as_bytes(storage), bytes->size() - 8));
+        REQUIRE(!serial::read_binary_map(as_bytes(storage), 16));
+    }
+
+    SECTION("Corrupted header") {
+        // magic, version, byte order, a table offset, then the chunk size and the tile dimensions
+        for(std::size_t const offset : {0, 4, 8, 16, 72, 76, 80}) {
+            auto storage = aligned_copy(*bytes);
+            reinterpret_cast<std::byte*>(storage.data())[offset + 1] ^= std::byte{0xFF};
+            REQUIRE(!serial::read_binary_map(as_bytes(storage), bytes->size()));
+        }
+    }
+}
+
+TEST_CASE("Binary map read from a mapped file", "[serial]") {
+    auto const bytes = serial::compile_binary_map(load_test_map(test_tiled_map));
+    REQUIRE(bytes);
+
+    auto const path = std::filesystem::temp_directory_path() / "telhar_test_map.ktmap";
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<char const*>(bytes->data()), static_cast<std::streamsize>(bytes->size()));
+        REQUIRE(file);
+    }
+
+    {
+        auto const file = sys::mapped_file::open(path);
+        REQUIRE(file);
+        REQUIRE(file->size() == bytes->size());
+        REQUIRE(std::equal(bytes->begin(), bytes->end(), file->data(), file->data() + file->size()));
+        REQUIRE(serial::read_binary_map(file->data(), file->size()));
+    }
+
+    std::filesystem::remove(path);
+    REQUIRE(!sys::mapped_file::open(path));
+}
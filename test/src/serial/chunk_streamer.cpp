@@ -0,0 +1,161 @@
+#include <catch.hpp>
+
+#include <serial/binary_map.h>
+#include <serial/chunk_streamer.h>
+#include <sys/thread_pool.h>
+
+#include <cstring>
+
+namespace {
+    constexpr int world_chunks = 32;
+    // One tile layer of world_chunks x world_chunks chunks, each filled with an id telling its position, and an object layer
+    auto make_world() -> game::map {
+        std::vector<game::packed_chunk> chunks;
+        for(int y = 0; y < world_chunks; ++y) {
+            for(int x = 0; x < world_chunks; ++x) {
+                auto const id = static_cast<game::tile::id>(1 + x + y * world_chunks);
+                game::tile_chunk chunk{element_multiply(math::vector2i{x, y}, game::tile_chunk::dimensions), {}};
+                chunk.tiles.fill(game::tile{id});
+                chunks.push_back(game::pack_chunk(chunk));
+            }
+        }
+
+        game::map map;
+        map.layers.push_back({game::layer::id_t{1}, game::layer::object_data{}});
+        map.layers.push_back({game::layer::id_t{2}, game::layer::tile_data(std::move(chunks))});
+        map.tilesets.push_back({"tileset.json", game::tile::id{1}});
+        return map;
+    }
+
+    struct compiled_world {
+        std::vector<std::uint64_t> storage;
+        serial::binary_map_view view;
+    };
+
+    auto compile_world() -> compiled_world {
+        auto const bytes = serial::compile_binary_map(make_world());
+        REQUIRE(bytes);
+        std::vector<std::uint64_t> storage((bytes->size() + 7) / 8);
+        std::memcpy(storage.data(), bytes->data(), bytes->size());
+        auto const view = serial::read_binary_map(reinterpret_cast<std::byte const*>(storage.data()), bytes->size());
+        REQUIRE(view);
+        return {std::move(storage), *view};
+    }
+
+    // Tiles of a view 'chunks' chunks wide and high, from chunk 'first'
+    auto chunk_view(math::vector2i first, int chunks) -> std::pair<math::vector2i, math::vector2i> {
+        auto const first_tile = element_multiply(first, game::tile_chunk::dimensions);
+        return {first_tile, first_tile + game::tile_chunk::dimensions * chunks};
+    }
+
+    auto chunk_position(int x, int y) -> math::vector2i {
+        return element_multiply(math::vector2i{x, y}, game::tile_chunk::dimensions);
+    }
+
+    void load_view(serial::chunk_streamer& streamer, std::pair<math::vector2i, math::vector2i> view) {
+        streamer.update(view.first, view.second);
+        streamer.wait();
+        streamer.update(view.first, view.second);
+    }
+}
+
+TEST_CASE("Chunk streamer loads the chunks in view", "[serial]") {
+    auto const world = compile_world();
+    sys::thread_pool pool(2);
+    serial::chunk_streamer streamer(world.view, pool);
+
+    // Half tiles in view still need their chunk
+    math::vector2i const half_chunk = {game::tile_chunk::dimensions.x / 2, game::tile_chunk::dimensions.y / 2};
+    streamer.update(chunk_position(2, 3) + half_chunk, chunk_position(4, 5) + half_chunk);
+    streamer.wait();
+    streamer.update(chunk_position(2, 3) + half_chunk, chunk_position(4, 5) + half_chunk);
+
+    auto const stats = streamer.get_stats();
+    REQUIRE(stats.resident_chunks == 9);
+    REQUIRE(stats.pending_loads == 0);
+
+    for(int y = 3; y <= 5; ++y) {
+        for(int x = 2; x <= 4; ++x) {
+            game::packed_chunk const* const chunk = streamer.find_chunk(1, chunk_position(x, y));
+            REQUIRE(chunk != nullptr);
+            REQUIRE(chunk->position == chunk_position(x, y));
+            REQUIRE(chunk->tiles->get_tile(0).data == static_cast<game::tile::id>(1 + x + y * world_chunks));
+        }
+    }
+    REQUIRE(streamer.find_chunk(1, chunk_position(5, 5)) == nullptr);
+    REQUIRE(streamer.find_chunk(0, chunk_position(2, 3)) == nullptr);
+
+    std::size_t visited = 0;
+    streamer.for_each_in_view([&visited] (std::size_t, game::packed_chunk const&) { ++visited; });
+    REQUIRE(visited == 9);
+
+    // Outside of the world, nothing is requested
+    load_view(streamer, chunk_view({-10, -10}, 2));
+    REQUIRE(streamer.get_stats().loaded_chunks == 9);
+}
+
+TEST_CASE("Chunk streamer requests the center of the view first", "[serial]") {
+    auto const world = compile_world();
+    sys::thread_pool pool(1);
+    serial::chunk_streamer_options options;
+    options.max_pending_loads = 1;
+    serial::chunk_streamer streamer(world.view, pool, options);
+
+    auto const view = chunk_view({10, 10}, 5);
+    streamer.update(view.first, view.second);
+    streamer.wait();
+    streamer.update(view.first, view.second);
+    REQUIRE(streamer.get_stats().resident_chunks == 1);
+    REQUIRE(streamer.find_chunk(1, chunk_position(12, 12)) != nullptr);
+}
+
+TEST_CASE("Chunk streamer prefetches in the scroll direction", "[serial]") {
+    auto const world = compile_world();
+    sys::thread_pool pool(2);
+    serial::chunk_streamer_options options;
+    options.prefetch_distance = 2;
+    serial::chunk_streamer streamer(world.view, pool, options);
+
+    load_view(streamer, chunk_view({4, 4}, 2));
+    REQUIRE(streamer.get_stats().resident_chunks == 4);
+
+    load_view(streamer, chunk_view({5, 4}, 2));
+    load_view(streamer, chunk_view({5, 4}, 2));
+    for(int x = 5; x <= 8; ++x) {
+        REQUIRE(streamer.find_chunk(1, chunk_position(x, 4)) != nullptr);
+        REQUIRE(streamer.find_chunk(1, chunk_position(x, 5)) != nullptr);
+    }
+    REQUIRE(streamer.find_chunk(1, chunk_position(9, 4)) == nullptr);
+    REQUIRE(streamer.find_chunk(1, chunk_position(5, 3)) == nullptr);
+}
+
+TEST_CASE("Chunk streamer stays within its memory budget", "[serial]") {
+    auto const world = compile_world();
+    sys::thread_pool pool(2);
+    serial::chunk_streamer_options options;
+    // Every chunk of the world is uniform, so that they all take the same memory
+    options.memory_budget = 12 * game::get_memory_usage(game::pack_chunk(game::tile_chunk{}));
+    options.prefetch_distance = 1;
+    serial::chunk_streamer streamer(world.view, pool, options);
+
+    for(int x = 0; x + 2 <= world_chunks; ++x) {
+        load_view(streamer, chunk_view({x, x / 2}, 2));
+        auto const stats = streamer.get_stats();
+        REQUIRE(stats.resident_bytes <= options.memory_budget);
+        for(int y = x / 2; y < x / 2 + 2; ++y) {
+            REQUIRE(streamer.find_chunk(1, chunk_position(x, y)) != nullptr);
+            REQUIRE(streamer.find_chunk(1, chunk_position(x + 1, y)) != nullptr);
+        }
+    }
+
+    auto const stats = streamer.get_stats();
+    REQUIRE(stats.evicted_chunks > 0);
+    REQUIRE(stats.resident_chunks + stats.evicted_chunks == stats.loaded_chunks);
+
+    // The view is kept resident even when it does not fit in the budget
+    load_view(streamer, chunk_view({10, 10}, 4));
+    REQUIRE(streamer.get_stats().resident_chunks >= 16);
+    std::size_t visited = 0;
+    streamer.for_each_in_view([&visited] (std::size_t, game::packed_chunk const&) { ++visited; });
+    REQUIRE(visited == 16);
+}
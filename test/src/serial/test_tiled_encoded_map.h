@@ -0,0 +1,216 @@
+#pragma once
+
+#include <string_view>
+
+// The same two chunks of tile data in each of the encodings supported by Tiled
+
+std::string_view const test_tiled_csv_map{
+	R"(
+{ "height":16,
+ "infinite":true,
+ "layers":[
+        {
+         "chunks":[
+                {
+                 "data":[1, 1, 1, 1, 0, 0, 0, 0, 4, 4, 4, 4, 4, 4, 4, 1, 1, 1, 1, 1, 0, 0, 0, 0, 4, 0, 0, 0, 0, 0, 4, 1, 1, 1, 1, 1, 0, 0, 0, 0, 4, 0, 0, 0, 0, 0, 4, 1, 1, 1, 1, 1, 1, 0, 0, 0, 4, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 4, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 4, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 4, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 4, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 4, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 4, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 4, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 4, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 4, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 4, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1],
+                 "height":16,
+                 "width":16,
+                 "x":-16,
+                 "y":0
+                }, 
+                {
+                 "data":[1, 1, 1, 1, 4, 4, 4, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 4, 4, 4, 4, 4, 4, 2, 2, 3, 3, 3, 3, 3, 3, 1, 4, 4, 4, 4, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 1, 1, 4, 4, 4, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3, 1, 3, 3, 4, 4, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3, 1, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 2, 3, 3, 3, 3, 1, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 2, 3, 3, 3, 3, 1, 3, 3, 3, 3, 3, 3, 3, 4, 4, 2, 2, 3, 3, 3, 3, 1, 3, 3, 3, 3, 4, 4, 4, 4, 4, 2, 2, 3, 3, 3, 3, 1, 3, 3, 3, 4, 4, 5, 5, 5, 4, 4, 2, 3, 3, 3, 3, 1, 3, 3, 3, 4, 4, 5, 5, 5, 4, 2, 2, 3, 6, 6, 3, 1, 3, 3, 3, 3, 4, 5, 5, 5, 4, 3, 3, 6, 6, 6, 3, 1, 3, 3, 3, 4, 4, 4, 4, 4, 3, 3, 3, 6, 6, 6, 3, 1, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 6, 6, 6, 3, 1, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 1, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3],
+                 "height":16,
+                 "width":16,
+                 "x":0,
+                 "y":0
+                }],
+         "encoding":"csv",
+         "height":16,
+         "id":1,
+         "name":"Ground",
+         "opacity":1,
+         "startx":-16,
+         "starty":0,
+         "type":"tilelayer",
+         "visible":true,
+         "width":32,
+         "x":0,
+         "y":0
+        }],
+ "nextlayerid":2,
+ "nextobjectid":1,
+ "orientation":"orthogonal",
+ "renderorder":"right-down",
+ "tiledversion":"1.2.2",
+ "tileheight":32,
+ "tilesets":[
+        {
+         "firstgid":1,
+         "source":"test_tileset.json"
+        }],
+ "tilewidth":32,
+ "type":"map",
+ "version":1.2,
+ "width":16
+})"
+};
+
+std::string_view const test_tiled_base64_map{
+	R"(
+{ "height":16,
+ "infinite":true,
+ "layers":[
+        {
+         "chunks":[
+                {
+                 "data":"AQAAAAEAAAABAAAAAQAAAAAAAAAAAAAAAAAAAAAAAAAEAAAABAAAAAQAAAAEAAAABAAAAAQAAAAEAAAAAQAAAAEAAAABAAAAAQAAAAEAAAAAAAAAAAAAAAAAAAAAAAAABAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAABAAAAAEAAAABAAAAAQAAAAEAAAABAAAAAAAAAAAAAAAAAAAAAAAAAAQAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAQAAAABAAAAAQAAAAEAAAABAAAAAQAAAAEAAAAAAAAAAAAAAAAAAAAEAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAABAAAAAQAAAAEAAAABAAAAAQAAAAEAAAABAAAAAAAAAAAAAAAAAAAABAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAQAAAAEAAAABAAAAAQAAAAEAAAABAAAAAQAAAAAAAAAAAAAAAAAAAAQAAAAAAAAAAAAAAAAAAAAAAAAAAQAAAAEAAAABAAAAAQAAAAEAAAABAAAAAQAAAAEAAAAAAAAAAAAAAAAAAAAEAAAAAAAAAAAAAAAAAAAAAQAAAAEAAAABAAAAAQAAAAEAAAABAAAAAQAAAAEAAAABAAAAAQAAAAAAAAAAAAAABAAAAAAAAAAAAAAAAAAAAAEAAAABAAAAAQAAAAEAAAABAAAAAQAAAAEAAAABAAAAAQAAAAEAAAAAAAAAAAAAAAQAAAAAAAAAAAAAAAEAAAABAAAAAQAAAAEAAAABAAAAAQAAAAEAAAABAAAAAQAAAAEAAAABAAAAAAAAAAAAAAAEAAAAAAAAAAAAAAABAAAAAQAAAAEAAAABAAAAAQAAAAEAAAABAAAAAQAAAAEAAAABAAAAAQAAAAEAAAAAAAAABAAAAAAAAAAAAAAAAQAAAAEAAAABAAAAAQAAAAEAAAABAAAAAQAAAAEAAAABAAAAAQAAAAEAAAABAAAAAAAAAAQAAAAAAAAAAQAAAAEAAAABAAAAAQAAAAEAAAABAAAAAQAAAAEAAAABAAAAAQAAAAEAAAABAAAAAQAAAAAAAAAEAAAAAAAAAAEAAAABAAAAAQAAAAEAAAABAAAAAQAAAAEAAAABAAAAAQAAAAEAAAABAAAAAQAAAAEAAAABAAAABAAAAAEAAAABAAAAAQAAAAEAAAABAAAAAQAAAAEAAAABAAAAAQAAAAEAAAABAAAAAQAAAAEAAAABAAAAAQAAAAEAAAABAAAAAQAAAAEAAAABAAAAAQAAAAEAAAABAAAAAQAAAAEAAAABAAAAAQAAAAEAAAABAAAAAQAAAAEAAAABAAAAAQAAAAEAAAABAAAAAQAAAAEAAAABAAAAAQAAAA==",
+                 "height":16,
+                 "width":16,
+                 "x":-16,
+                 "y":0
+                }, 
+                {
+                 "data":"AQAAAAEAAAABAAAAAQAAAAQAAAAEAAAABAAAAAEAAAABAAAAAQAAAAEAAAABAAAAAQAAAAEAAAABAAAAAQAAAAEAAAABAAAABAAAAAQAAAAEAAAABAAAAAQAAAAEAAAAAgAAAAIAAAADAAAAAwAAAAMAAAADAAAAAwAAAAMAAAABAAAABAAAAAQAAAAEAAAABAAAAAIAAAACAAAAAgAAAAIAAAADAAAAAwAAAAMAAAADAAAAAwAAAAMAAAADAAAAAQAAAAEAAAAEAAAABAAAAAQAAAACAAAAAgAAAAIAAAADAAAAAwAAAAMAAAADAAAAAwAAAAMAAAADAAAAAwAAAAEAAAADAAAAAwAAAAQAAAAEAAAAAgAAAAIAAAACAAAAAwAAAAMAAAADAAAAAwAAAAMAAAADAAAAAwAAAAMAAAABAAAAAwAAAAMAAAADAAAAAwAAAAMAAAADAAAAAwAAAAMAAAADAAAAAwAAAAIAAAADAAAAAwAAAAMAAAADAAAAAQAAAAMAAAADAAAAAwAAAAMAAAADAAAAAwAAAAMAAAADAAAAAwAAAAMAAAACAAAAAwAAAAMAAAADAAAAAwAAAAEAAAADAAAAAwAAAAMAAAADAAAAAwAAAAMAAAADAAAABAAAAAQAAAACAAAAAgAAAAMAAAADAAAAAwAAAAMAAAABAAAAAwAAAAMAAAADAAAAAwAAAAQAAAAEAAAABAAAAAQAAAAEAAAAAgAAAAIAAAADAAAAAwAAAAMAAAADAAAAAQAAAAMAAAADAAAAAwAAAAQAAAAEAAAABQAAAAUAAAAFAAAABAAAAAQAAAACAAAAAwAAAAMAAAADAAAAAwAAAAEAAAADAAAAAwAAAAMAAAAEAAAABAAAAAUAAAAFAAAABQAAAAQAAAACAAAAAgAAAAMAAAAGAAAABgAAAAMAAAABAAAAAwAAAAMAAAADAAAAAwAAAAQAAAAFAAAABQAAAAUAAAAEAAAAAwAAAAMAAAAGAAAABgAAAAYAAAADAAAAAQAAAAMAAAADAAAAAwAAAAQAAAAEAAAABAAAAAQAAAAEAAAAAwAAAAMAAAADAAAABgAAAAYAAAAGAAAAAwAAAAEAAAADAAAAAwAAAAMAAAADAAAAAwAAAAMAAAADAAAAAwAAAAMAAAADAAAAAwAAAAYAAAAGAAAABgAAAAMAAAABAAAAAwAAAAMAAAADAAAAAwAAAAMAAAADAAAAAwAAAAMAAAADAAAAAwAAAAMAAAADAAAAAwAAAAMAAAADAAAAAQAAAAMAAAADAAAAAwAAAAMAAAADAAAAAwAAAAMAAAADAAAAAwAAAAMAAAADAAAAAwAAAAMAAAADAAAAAwAAAA==",
+                 "height":16,
+                 "width":16,
+                 "x":0,
+                 "y":0
+                }],
+         "compression":"",
+         "encoding":"base64",
+         "height":16,
+         "id":1,
+         "name":"Ground",
+         "opacity":1,
+         "startx":-16,
+         "starty":0,
+         "type":"tilelayer",
+         "visible":true,
+         "width":32,
+         "x":0,
+         "y":0
+        }],
+ "nextlayerid":2,
+ "nextobjectid":1,
+ "orientation":"orthogonal",
+ "renderorder":"right-down",
+ "tiledversion":"1.2.2",
+ "tileheight":32,
+ "tilesets":[
+        {
+         "firstgid":1,
+         "source":"test_tileset.json"
+        }],
+ "tilewidth":32,
+ "type":"map",
+ "version":1.2,
+ "width":16
+})"
+};
+
+std::string_view const test_tiled_zlib_map{
+	R"(
+{ "height":16,
+ "infinite":true,
+ "layers":[
+        {
+         "chunks":[
+                {
+                 "data":"eNrN0kEKACAIRNH50P3P3DZCSygz4W+EtxskMTRfW4SR5eX8MzxBT6HnwBMsw/PQc9lT4Nns9Ic6/k8A/A==",
+                 "height":16,
+                 "width":16,
+                 "x":-16,
+                 "y":0
+                }, 
+                {
+                 "data":"eNrF0kEKQCEIRVFNa/9L/pOER6RWDv7gQoNOBsVExJBCfJE6tZk4cWAyK878U2ve1lWf1X7w2TtwYPTB2/4O4RmvHuePWXT/1ctiRzIfkwufVfWV/7PrA7hfAwo=",
+                 "height":16,
+                 "width":16,
+                 "x":0,
+                 "y":0
+                }],
+         "compression":"zlib",
+         "encoding":"base64",
+         "height":16,
+         "id":1,
+         "name":"Ground",
+         "opacity":1,
+         "startx":-16,
+         "starty":0,
+         "type":"tilelayer",
+         "visible":true,
+         "width":32,
+         "x":0,
+         "y":0
+        }],
+ "nextlayerid":2,
+ "nextobjectid":1,
+ "orientation":"orthogonal",
+ "renderorder":"right-down",
+ "tiledversion":"1.2.2",
+ "tileheight":32,
+ "tilesets":[
+        {
+         "firstgid":1,
+         "source":"test_tileset.json"
+        }],
+ "tilewidth":32,
+ "type":"map",
+ "version":1.2,
+ "width":16
+})"
+};
+
+std::string_view const test_tiled_gzip_map{
+	R"(
+{ "height":16,
+ "infinite":true,
+ "layers":[
+        {
+         "chunks":[
+                {
+                 "data":"H4sIAAAAAAACA83SQQoAIAhE0fnQ/c/cNkJLKDPhb4S3GyQxNF9bhJHl5fwzPEFPoefAEyzD89Bz2VPg2ez0hzoPpLu8AAQAAA==",
+                 "height":16,
+                 "width":16,
+                 "x":-16,
+                 "y":0
+                }, 
+                {
+                 "data":"H4sIAAAAAAACA8XSQQpAIQhFUU1r/0v+k4RHpFYO/uBCg04GxUTEkEJ8kTq1mThxYDIrzvxTa97WVZ/VfvDZO3Bg9MHb/g7hGa8e549ZdP/Vy2JHMh+TC59V9ZX/s+sDTEXR9wAEAAA=",
+                 "height":16,
+                 "width":16,
+                 "x":0,
+                 "y":0
+                }],
+         "compression":"gzip",
+         "encoding":"base64",
+         "height":16,
+         "id":1,
+         "name":"Ground",
+         "opacity":1,
+         "startx":-16,
+         "starty":0,
+         "type":"tilelayer",
+         "visible":true,
+         "width":32,
+         "x":0,
+         "y":0
+        }],
+ "nextlayerid":2,
+ "nextobjectid":1,
+ "orientation":"orthogonal",
+ "renderorder":"right-down",
+ "tiledversion":"1.2.2",
+ "tileheight":32,
+ "tilesets":[
+        {
+         "firstgid":1,
+         "source":"test_tileset.json"
+        }],
+ "tilewidth":32,
+ "type":"map",
+ "version":1.2,
+ "width":16
+})"
+};
@@ -112,4 +112,83 @@ std::string_view const test_tiled_map{
  "width":16
 }
 	)"
-};
\ No newline at end of file
+};
+
+std::string_view const test_tiled_object_map{
+	R"(
+{ "height":16,
+ "infinite":true,
+ "layers":[
+        {
+         "draworder":"topdown",
+         "id":2,
+         "name":"Object Layer 1",
+         "objects":[
+                {
+                 "height":64,
+                 "id":1,
+                 "name":"spawn",
+                 "properties":[
+                        {
+                         "name":"team",
+                         "type":"int",
+                         "value":2
+                        }],
+                 "rotation":0,
+                 "type":"area",
+                 "visible":true,
+                 "width":96,
+                 "x":32,
+                 "y":-64
+                }, 
+                {
+                 "height":0,
+                 "id":2,
+                 "name":"",
+                 "point":true,
+                 "rotation":0,
+                 "type":"waypoint",
+                 "visible":true,
+                 "width":0,
+                 "x":128.5,
+                 "y":16
+                }, 
+                {
+                 "height":19,
+                 "id":3,
+                 "name":"sign",
+                 "rotation":90,
+                 "text":
+                    {
+                     "bold":true,
+                     "color":"#ff00ff",
+                     "halign":"center",
+                     "text":"Hello",
+                     "wrap":true
+                    },
+                 "type":"",
+                 "visible":true,
+                 "width":80,
+                 "x":0,
+                 "y":0
+                }],
+         "opacity":1,
+         "type":"objectgroup",
+         "visible":true,
+         "x":0,
+         "y":0
+        }],
+ "nextlayerid":3,
+ "nextobjectid":4,
+ "orientation":"orthogonal",
+ "renderorder":"right-down",
+ "tiledversion":"1.2.2",
+ "tileheight":32,
+ "tilesets":[],
+ "tilewidth":32,
+ "type":"map",
+ "version":1.2,
+ "width":16
+}
+	)"
+};
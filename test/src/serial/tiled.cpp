@@ -1,11 +1,85 @@
 #include <catch.hpp>
 
 #include <serial/tiled.h>
+#include <sys/thread_pool.h>
 #include "serial/test_tiled_map.h"
+#include "serial/test_tiled_encoded_map.h"
 #include "serial/test_tileset.h"
 
+#include <algorithm>
+#include <cstdint>
 #include <sstream>
 #include <fstream>
+#include <set>
+#include <string>
+#include <utility>
+
+namespace {
+    // Tiled chunks of the fixture maps, whatever the chunk size of the build
+    constexpr std::size_t fixture_chunk_tiles = 16 * 16;
+
+    // Chunks of the build holding tiles of any of 'regions'
+    auto count_chunks_over(std::initializer_list<game::tile_rect> regions) -> std::size_t {
+        std::set<std::pair<int, int>> chunks;
+        for(game::tile_rect const& region : regions) {
+            math::vector2i const first = game::get_chunk_coordinates(region.position);
+            math::vector2i const last = game::get_chunk_coordinates(region.position + region.size - math::vector2i{1, 1});
+            for(int y = first.y; y <= last.y; ++y) {
+                for(int x = first.x; x <= last.x; ++x) {
+                    chunks.emplace(x, y);
+                }
+            }
+        }
+        return chunks.size();
+    }
+
+    auto replace_first(std::string_view source, std::string_view from, std::string_view to) -> std::string {
+        std::string result(source);
+        auto const position = result.find(from);
+        REQUIRE(position != std::string::npos);
+        return result.replace(position, from.size(), to);
+    }
+
+    void require_same_map(game::map const& lhs, game::map const& rhs) {
+        REQUIRE(lhs.layers.size() == rhs.layers.size());
+        for(std::size_t layer_index = 0; layer_index < lhs.layers.size(); ++layer_index) {
+            game::layer const& lhs_layer = lhs.layers[layer_index];
+            game::layer const& rhs_layer = rhs.layers[layer_index];
+            REQUIRE(lhs_layer.id == rhs_layer.id);
+            REQUIRE(lhs_layer.get_type() == rhs_layer.get_type());
+            if(lhs_layer.get_type() == game::layer::type::tile) {
+                auto const& lhs_chunks = std::get<game::layer::tile_data>(lhs_layer.data).get_chunks();
+                auto const& rhs_chunks = std::get<game::layer::tile_data>(rhs_layer.data).get_chunks();
+                REQUIRE(lhs_chunks.size() == rhs_chunks.size());
+                for(std::size_t chunk_index = 0; chunk_index < lhs_chunks.size(); ++chunk_index) {
+                    REQUIRE(lhs_chunks[chunk_index].position == rhs_chunks[chunk_index].position);
+                    REQUIRE(*lhs_chunks[chunk_index].tiles == *rhs_chunks[chunk_index].tiles);
+                }
+            } else {
+                auto const& lhs_objects = std::get<game::layer::object_data>(lhs_layer.data);
+                auto const& rhs_objects = std::get<game::layer::object_data>(rhs_layer.data);
+                REQUIRE(lhs_objects.size() == rhs_objects.size());
+                for(std::size_t object_index = 0; object_index < lhs_objects.size(); ++object_index) {
+                    game::object const lhs_object = lhs_objects.get_object(object_index);
+                    game::object const rhs_object = rhs_objects.get_object(object_index);
+                    REQUIRE(lhs_object.id == rhs_object.id);
+                    REQUIRE(lhs.strings.get(lhs_object.name) == rhs.strings.get(rhs_object.name));
+                    REQUIRE(lhs.strings.get(lhs_object.type) == rhs.strings.get(rhs_object.type));
+                    REQUIRE(lhs_object.position == rhs_object.position);
+                    REQUIRE(lhs_object.dimensions == rhs_object.dimensions);
+                    REQUIRE(lhs_object.rotation == rhs_object.rotation);
+                    REQUIRE(lhs_object.get_kind() == rhs_object.get_kind());
+                }
+            }
+        }
+
+        REQUIRE(lhs.tilesets.size() == rhs.tilesets.size());
+        for(std::size_t tileset_index = 0; tileset_index < lhs.tilesets.size(); ++tileset_index) {
+            REQUIRE(lhs.tilesets[tileset_index].source == rhs.tilesets[tileset_index].source);
+            REQUIRE(lhs.tilesets[tileset_index].starting_id == rhs.tilesets[tileset_index].starting_id);
+        }
+    }
+}
 
 TEST_CASE("Tiled Basic JSON", "[serial]") {
     std::stringstream ss;
@@ -30,12 +104,12 @@ TEST_CASE("Tiled valid map", "[serial]") {
     REQUIRE(tile_layer.id == game::layer::id_t{1});
     REQUIRE(tile_layer.get_type() == game::layer::type::tile);
     auto const& data = std::get<game::layer::tile_data>(tile_layer.data);
-    REQUIRE(data.chunks.size() == 10);
-    auto const it_found = std::find_if(data.chunks.begin(), data.chunks.end(), 
-                 [] (game::tile_chunk const& chunk) { return chunk.position == math::vector2i{0, 0}; });
-    REQUIRE(it_found != data.chunks.end());
-    game::tile_chunk const& middle_chunk = *it_found;
-    REQUIRE(middle_chunk.tiles.size() == game::tile_chunk::dimensions.x * game::tile_chunk::dimensions.y);
+    // Tiles cover 80x32 tiles from (-32, 0)
+    REQUIRE(data.get_chunks().size() == count_chunks_over({{{-32, 0}, {80, 32}}}));
+    game::packed_chunk const* const found = data.find_chunk({0, 0});
+    REQUIRE(found != nullptr);
+    REQUIRE(found->position == math::vector2i{0, 0});
+    game::tile_chunk const middle_chunk = game::unpack_chunk(*found);
     REQUIRE(std::all_of(middle_chunk.tiles.begin(), middle_chunk.tiles.end(), 
                         [] (game::tile t) { return static_cast<int>(t.data) >= 1 && static_cast<int>(t.data) <= 8; }));
 
@@ -49,6 +123,263 @@ TEST_CASE("Tiled valid map", "[serial]") {
 	REQUIRE(it_test_tileset->starting_id == game::tile::id(1));
 }
 
+TEST_CASE("Tiled streaming, document and parallel loaders agree", "[serial]") {
+    sys::thread_pool pool(4);
+    for(std::string_view const map_string : {test_tiled_map, test_tiled_object_map, test_tiled_zlib_map}) {
+        std::stringstream stream_ss, document_ss, parallel_ss;
+        stream_ss << map_string;
+        document_ss << map_string;
+        parallel_ss << map_string;
+
+        auto const streamed = serial::load_tiled_json(stream_ss);
+        auto const document = serial::load_tiled_json_document(document_ss);
+        auto const parallel = serial::load_tiled_json_parallel(parallel_ss, pool);
+        REQUIRE(streamed);
+        REQUIRE(document);
+        REQUIRE(parallel);
+        require_same_map(*streamed, *document);
+        require_same_map(*parallel, *document);
+    }
+}
+
+TEST_CASE("Tiled chunks of another size are split and merged", "[serial]") {
+    std::stringstream original_ss;
+    original_ss << test_tiled_map;
+    auto const original = serial::load_tiled_json_document(original_ss);
+    REQUIRE(original);
+    auto const& original_data = std::get<game::layer::tile_data>(original->layers[0].data);
+
+    // The same tiles, over [-32, 48) x [0, 32), in Tiled chunks of 'side' tiles
+    std::string const chunks_begin = "\"chunks\":[";
+    auto const chunks_first = test_tiled_map.find(chunks_begin) + chunks_begin.size();
+    auto const chunks_last = test_tiled_map.find("}],\n         \"height\":32") + 1;
+    sys::thread_pool pool(4);
+    for(int const side : {game::tile_chunk::dimensions.x / 2, game::tile_chunk::dimensions.x * 2}) {
+        std::string chunks;
+        for(int y = 0; y < 32; y += side) {
+            for(int x = -32; x < 48; x += side) {
+                chunks += chunks.empty() ? "{\"data\":[" : ", {\"data\":[";
+                for(int i = 0; i < side * side; ++i) {
+                    chunks += (i == 0 ? "" : ",") + std::to_string(static_cast<std::uint32_t>(original_data.get_tile({x + i % side, y + i / side}).data));
+                }
+                chunks += "], \"height\":" + std::to_string(side) + ", \"width\":" + std::to_string(side)
+                    + ", \"x\":" + std::to_string(x) + ", \"y\":" + std::to_string(y) + "}";
+            }
+        }
+        std::string const map_string = std::string(test_tiled_map.substr(0, chunks_first)) + chunks + std::string(test_tiled_map.substr(chunks_last));
+
+        std::stringstream stream_ss, document_ss, parallel_ss;
+        stream_ss << map_string;
+        document_ss << map_string;
+        parallel_ss << map_string;
+        for(auto const& result : {serial::load_tiled_json(stream_ss), serial::load_tiled_json_document(document_ss), serial::load_tiled_json_parallel(parallel_ss, pool)}) {
+            REQUIRE(result);
+            auto const& data = std::get<game::layer::tile_data>(result->layers[0].data);
+            REQUIRE(data.get_chunks().size() == original_data.get_chunks().size());
+            for(game::packed_chunk const& chunk : original_data.get_chunks()) {
+                game::packed_chunk const* const found = data.find_chunk(game::get_chunk_coordinates(chunk.position));
+                REQUIRE(found != nullptr);
+                REQUIRE(*found->tiles == *chunk.tiles);
+            }
+        }
+    }
+}
+
+TEST_CASE("Tiled tiles keep their flip flags", "[serial]") {
+    // Horizontally flipped 1, vertically flipped 2, diagonally flipped 3 and 4 flipped every way
+    std::string const map_string = replace_first(test_tiled_map, "\"data\":[1, 1, 1, 1,", "\"data\":[2147483649, 1073741826, 536870915, 3758096388,");
+    sys::thread_pool pool(2);
+    std::stringstream stream_ss, document_ss, parallel_ss;
+    stream_ss << map_string;
+    document_ss << map_string;
+    parallel_ss << map_string;
+
+    for(auto const& map : {serial::load_tiled_json(stream_ss), serial::load_tiled_json_document(document_ss), serial::load_tiled_json_parallel(parallel_ss, pool)}) {
+        REQUIRE(map);
+        auto const tiles = game::unpack_chunk(std::get<game::layer::tile_data>(map->layers[0].data).get_chunks()[0]).tiles;
+        REQUIRE(tiles[0].get_id() == game::tile::id{1});
+        REQUIRE(tiles[0].get_flips() == game::tile::flip_horizontal);
+        REQUIRE(tiles[1].get_id() == game::tile::id{2});
+        REQUIRE(tiles[1].get_flips() == game::tile::flip_vertical);
+        REQUIRE(tiles[2].get_id() == game::tile::id{3});
+        REQUIRE(tiles[2].get_flips() == game::tile::flip_diagonal);
+        REQUIRE(tiles[3].get_id() == game::tile::id{4});
+        REQUIRE(tiles[3].get_flips() == game::tile::flip_flags);
+        REQUIRE(tiles[4].get_id() == game::tile::id{1});
+        REQUIRE(tiles[4].get_flips() == 0);
+    }
+}
+
+TEST_CASE("Tiled loaders drop the empty chunks", "[serial]") {
+    // The first chunk of the map cleared, the 16x16 tiles from (-32, 0)
+    std::string map_string(test_tiled_map);
+    auto const first = map_string.find("\"data\":[") + 8;
+    auto const last = map_string.find(']', first);
+    std::string empty_data = "0";
+    for(std::size_t i = 1; i < fixture_chunk_tiles; ++i) {
+        empty_data += ", 0";
+    }
+    map_string.replace(first, last - first, empty_data);
+
+    sys::thread_pool pool(2);
+    std::stringstream stream_ss, document_ss, parallel_ss;
+    stream_ss << map_string;
+    document_ss << map_string;
+    parallel_ss << map_string;
+
+    for(auto const& map : {serial::load_tiled_json(stream_ss), serial::load_tiled_json_document(document_ss), serial::load_tiled_json_parallel(parallel_ss, pool)}) {
+        REQUIRE(map);
+        auto const& chunks = std::get<game::layer::tile_data>(map->layers[0].data).get_chunks();
+        REQUIRE(chunks.size() == count_chunks_over({{{-16, 0}, {64, 16}}, {{-32, 16}, {80, 16}}}));
+        REQUIRE(std::none_of(chunks.begin(), chunks.end(), [] (game::packed_chunk const& chunk) { return chunk.tiles->is_empty(); }));
+    }
+}
+
+TEST_CASE("Tiled maps of another tile size keep their tiles", "[serial]") {
+    std::stringstream original_ss;
+    original_ss << test_tiled_map;
+    auto const original = serial::load_tiled_json_document(original_ss);
+    REQUIRE(original);
+    REQUIRE(original->tile_dimensions == game::tile::dimensions);
+
+    // Neither a multiple nor a divisor of the tile size of the build
+    std::string const map_string = replace_first(replace_first(test_tiled_map, "\"tilewidth\":32", "\"tilewidth\":48"), "\"tileheight\":32", "\"tileheight\":24");
+    sys::thread_pool pool(2);
+    std::stringstream stream_ss, document_ss, parallel_ss;
+    stream_ss << map_string;
+    document_ss << map_string;
+    parallel_ss << map_string;
+
+    for(auto const& map : {serial::load_tiled_json(stream_ss), serial::load_tiled_json_document(document_ss), serial::load_tiled_json_parallel(parallel_ss, pool)}) {
+        REQUIRE(map);
+        REQUIRE(map->tile_dimensions == math::vector2i{48, 24});
+        require_same_map(*map, *original);
+    }
+}
+
+TEST_CASE("Tiled encoded tile data", "[serial]") {
+    std::stringstream csv_ss;
+    csv_ss << test_tiled_csv_map;
+    auto const csv_map = serial::load_tiled_json(csv_ss);
+    REQUIRE(csv_map);
+
+    for(std::string_view const map_string : {test_tiled_base64_map, test_tiled_zlib_map, test_tiled_gzip_map}) {
+        std::stringstream stream_ss, document_ss;
+        stream_ss << map_string;
+        document_ss << map_string;
+
+        auto const streamed = serial::load_tiled_json(stream_ss);
+        auto const document = serial::load_tiled_json_document(document_ss);
+        REQUIRE(streamed);
+        REQUIRE(document);
+        require_same_map(*streamed, *csv_map);
+        require_same_map(*document, *csv_map);
+    }
+}
+
+TEST_CASE("Tiled object layer", "[serial]") {
+    std::stringstream ss;
+    ss << test_tiled_object_map;
+
+    auto const result = serial::load_tiled_json(ss);
+    REQUIRE(result);
+    REQUIRE(result->layers.size() == 1);
+    REQUIRE(result->layers[0].get_type() == game::layer::type::object);
+
+    auto const& objects = std::get<game::layer::object_data>(result->layers[0].data);
+    REQUIRE(objects.size() == 3);
+    REQUIRE(result->strings.get(objects.get_names()[0]) == "spawn");
+    REQUIRE(result->strings.get(objects.get_types()[0]) == "area");
+    REQUIRE(objects.get_kinds()[0] == game::object::kind::rectangle);
+    REQUIRE(objects.get_positions()[0] == math::vector2i{32, -64});
+    REQUIRE(objects.get_dimensions()[0] == math::vector2i{96, 64});
+    REQUIRE(objects.get_kinds()[1] == game::object::kind::point);
+    REQUIRE(objects.get_positions()[1] == math::vector2i{128, 16});
+    REQUIRE(objects.get_kinds()[2] == game::object::kind::text);
+
+    auto const& text = objects.get_text(2);
+    REQUIRE(text.text == "Hello");
+    REQUIRE(text.halign == game::text_data::horizontal_alignment::center);
+    REQUIRE(text.bold);
+    REQUIRE(text.wrap);
+    REQUIRE(text.color.r == 0xFF);
+    REQUIRE(text.color.g == 0x00);
+    REQUIRE(text.color.b == 0xFF);
+    REQUIRE(objects.get_object(2).get_kind() == game::object::kind::text);
+    REQUIRE(std::get<game::text_data>(objects.get_object(2).kind_data).text == "Hello");
+
+    // Objects of a type are found by handle, and objects in an area from their bounds
+    auto const areas = game::find_objects_of_type(*result, "area");
+    REQUIRE(areas.size() == 1);
+    REQUIRE(areas[0].layer_index == 0);
+    REQUIRE(areas[0].object_index == 0);
+    REQUIRE(game::find_objects_of_type(*result, "unknown").empty());
+    auto const in_area = game::find_objects_in(*result, {100, -8}, {64, 64});
+    REQUIRE(in_area.size() == 2);
+    REQUIRE(in_area[0].object_index == 0);
+    REQUIRE(in_area[1].object_index == 1);
+}
+
+TEST_CASE("Tiled streaming and parallel loaders report the document loader errors", "[serial]") {
+    std::string const invalid_maps[] = {
+        replace_first(test_tiled_map, "\"infinite\":true", "\"infinite\":false"),
+        replace_first(test_tiled_map, "\"tiledversion\":\"1.2.2\"", "\"tiledversion\":\"0.9.0\""),
+        replace_first(test_tiled_map, "\"width\":16", "\"width\":15"),
+        replace_first(test_tiled_map, "\"tilewidth\":32", "\"tilewidth\":0"),
+        replace_first(test_tiled_map, "\"tileheight\":32", "\"tileheight\":\"32\""),
+        replace_first(test_tiled_map, "\"x\":-32", "\"x\":\"left\""),
+        replace_first(test_tiled_map, "\"data\":[1,", "\"data\":[-1,"),
+        replace_first(test_tiled_map, "\"data\":[1,", "\"data\":[[1],"),
+        replace_first(test_tiled_map, "\"data\":[1,", "\"data\":[4294967296,"),
+        replace_first(test_tiled_map, "\"data\":[1,", "\"data\":["),
+        replace_first(test_tiled_map, "\"data\":[1,", "\"data\":[1, 1,"),
+        replace_first(test_tiled_map, "\"data\":[1,", "\"data\":[-1, 1,"),
+        replace_first(test_tiled_map, "\"data\":", "\"tiles\":"),
+        replace_first(test_tiled_map, "\"chunks\":", "\"chunkz\":"),
+        replace_first(test_tiled_map, "\"tilelayer\"", "\"imagelayer\""),
+        replace_first(test_tiled_map, "\"id\":1", "\"id\":\"one\""),
+        replace_first(test_tiled_map, "\"layers\":[", "\"layers\":[5, "),
+        replace_first(test_tiled_map, "\"firstgid\":5", "\"firstgid\":\"5\""),
+        replace_first(test_tiled_map, "\"tilesets\":", "\"tilesetz\":"),
+        replace_first(test_tiled_object_map, "\"id\":1,", ""),
+        replace_first(test_tiled_object_map, "\"#ff00ff\"", "\"pink\""),
+        std::string("[1, 2, 3]"),
+        replace_first(test_tiled_base64_map, "\"encoding\":\"base64\"", "\"encoding\":\"base32\""),
+        replace_first(test_tiled_base64_map, "\"encoding\":\"base64\"", "\"encoding\":\"csv\""),
+        replace_first(test_tiled_csv_map, "\"encoding\":\"csv\"", "\"encoding\":\"base64\""),
+        replace_first(replace_first(test_tiled_csv_map, "\"encoding\":\"csv\"", "\"encoding\":\"base64\""), "\"data\":[1,", "\"data\":[-1,"),
+        replace_first(test_tiled_zlib_map, "\"compression\":\"zlib\"", "\"compression\":\"lzma\""),
+        replace_first(test_tiled_zlib_map, "\"compression\":\"zlib\"", "\"compression\":\"gzip\""),
+        replace_first(test_tiled_zlib_map, "\"compression\":\"zlib\"", "\"compression\":\"zstd\""),
+        replace_first(test_tiled_zlib_map, "\"data\":\"eNr", "\"data\":\"AAA"),
+        replace_first(test_tiled_gzip_map, "\"data\":\"H4s", "\"data\":\"H4s!"),
+        replace_first(test_tiled_base64_map, "\"data\":\"", "\"data\":\"AAAA"),
+        replace_first(test_tiled_base64_map, "\"data\":\"AQAA", "\"data\":\"AQ=="),
+        // Several errors: the first one in document order is reported
+        replace_first(replace_first(test_tiled_map, "\"x\":16", "\"x\":\"right\""), "\"data\":[1,", "\"data\":[-1,"),
+        replace_first(replace_first(test_tiled_map, "\"tilesets\":", "\"tilesetz\":"), "\"x\":16", "\"x\":\"right\""),
+        replace_first(replace_first(test_tiled_map, "\"layers\":[", "\"layers\":[{\"id\":9, \"type\":\"imagelayer\"}, "), "\"data\":[1,", "\"data\":[-1,"),
+        replace_first(replace_first(test_tiled_map, "}],\n \"nextlayerid\"", "}, {\"id\":9, \"type\":\"imagelayer\"}],\n \"nextlayerid\""), "\"data\":[1,", "\"data\":[-1,"),
+    };
+
+    sys::thread_pool pool(4);
+    for(std::string const& invalid_map : invalid_maps) {
+        std::stringstream stream_ss, document_ss, parallel_ss;
+        stream_ss << invalid_map;
+        document_ss << invalid_map;
+        parallel_ss << invalid_map;
+
+        auto const streamed = serial::load_tiled_json(stream_ss);
+        auto const document = serial::load_tiled_json_document(document_ss);
+        auto const parallel = serial::load_tiled_json_parallel(parallel_ss, pool);
+        REQUIRE(!streamed);
+        REQUIRE(!document);
+        REQUIRE(!parallel);
+        REQUIRE(streamed.error().description == document.error().description);
+        REQUIRE(parallel.error().description == document.error().description);
+    }
+}
+
 TEST_CASE("Tiled valid tileset", "[serial]") {
 	std::stringstream ss;
 	ss << test_tileset;
@@ -59,4 +390,25 @@ TEST_CASE("Tiled valid tileset", "[serial]") {
 
     auto const& image_file = *result;
     REQUIRE(image_file == "test_tileset.png");
+
+    std::stringstream info_ss;
+    info_ss << test_tileset;
+    auto const info = serial::get_tiled_tileset_info(info_ss);
+    REQUIRE(info);
+    REQUIRE(info->image == "test_tileset.png");
+    REQUIRE(info->tile_dimensions == game::tile::dimensions);
+    REQUIRE(info->tile_count == 4);
+    REQUIRE(info->columns == 2);
+}
+
+TEST_CASE("Tiled tileset of another tile size", "[serial]") {
+    std::stringstream ss;
+    ss << replace_first(replace_first(test_tileset, "\"tileheight\":32", "\"tileheight\":16"), "\"tilewidth\":32", "\"tilewidth\":64");
+    auto const info = serial::get_tiled_tileset_info(ss);
+    REQUIRE(info);
+    REQUIRE(info->tile_dimensions == math::vector2i{64, 16});
+
+    std::stringstream invalid_ss;
+    invalid_ss << replace_first(test_tileset, "\"tilewidth\":32", "\"tilewidth\":-32");
+    REQUIRE(!serial::get_tiled_tileset_info(invalid_ss));
 }
\ No newline at end of file
@@ -0,0 +1,49 @@
+#include <catch.hpp>
+
+#include <serial/tileset_cache.h>
+
+#include <sstream>
+
+TEST_CASE("Tileset cache finds the tilesets of the same stamp", "[serial]") {
+    serial::tileset_cache cache;
+    REQUIRE(!cache.is_modified());
+    cache.insert("tilesets/forest tiles.json", {1234, 5678}, {"forest tiles.png", {32, 32}, 64, 8});
+    REQUIRE(cache.is_modified());
+
+    auto const info = cache.find("tilesets/forest tiles.json", {1234, 5678});
+    REQUIRE(info != nullptr);
+    REQUIRE(info->image == "forest tiles.png");
+    REQUIRE(cache.find("tilesets/forest tiles.json", {1234, 5679}) == nullptr);
+    REQUIRE(cache.find("tilesets/forest tiles.json", {1235, 5678}) == nullptr);
+    REQUIRE(cache.find("tileset.json", {1234, 5678}) == nullptr);
+}
+
+TEST_CASE("Tileset cache is saved and loaded back", "[serial]") {
+    serial::tileset_cache cache;
+    cache.insert("tilesets/forest tiles.json", {1234, -5678}, {"forest tiles.png", {32, 32}, 64, 8});
+    cache.insert("tileset.json", {1, 2}, {"tileset.png", {32, 32}, 4, 2});
+    std::stringstream ss;
+    cache.save(ss);
+    REQUIRE(!cache.is_modified());
+
+    auto const loaded = serial::tileset_cache::load(ss);
+    REQUIRE(loaded);
+    REQUIRE(!loaded->is_modified());
+    auto const info = loaded->find("tilesets/forest tiles.json", {1234, -5678});
+    REQUIRE(info != nullptr);
+    REQUIRE(info->image == "forest tiles.png");
+    REQUIRE(info->tile_dimensions == math::vector2i{32, 32});
+    REQUIRE(info->tile_count == 64);
+    REQUIRE(info->columns == 8);
+    REQUIRE(loaded->find("tileset.json", {1, 2}) != nullptr);
+}
+
+TEST_CASE("Tileset cache drops caches of another format", "[serial]") {
+    std::stringstream other_version("TelharTactical tileset cache 0\n1 2 32 32 4 2\ttileset.json\ttileset.png\n");
+    auto const loaded = serial::tileset_cache::load(other_version);
+    REQUIRE(loaded);
+    REQUIRE(loaded->find("tileset.json", {1, 2}) == nullptr);
+
+    std::stringstream invalid("TelharTactical tileset cache 1\n1 2 32\ttileset.json\n");
+    REQUIRE(!serial::tileset_cache::load(invalid));
+}
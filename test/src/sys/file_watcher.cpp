@@ -0,0 +1,56 @@
+#include <catch.hpp>
+
+#include <sys/file_watcher.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+namespace {
+    void write_file(std::filesystem::path const& path, char const* contents) {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << contents;
+    }
+
+    // Modification times may be as coarse as a second on the platforms which compare them
+    auto poll_until_modified(sys::file_watcher& watcher) -> std::vector<std::filesystem::path> {
+        auto const deadline = std::chrono::steady_clock::now() + std::chrono::seconds(3);
+        auto modified = watcher.poll();
+        while(modified.empty() && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            modified = watcher.poll();
+        }
+        return modified;
+    }
+}
+
+TEST_CASE("File watcher reports modified files only", "[sys]") {
+    auto const directory = std::filesystem::temp_directory_path() / "telhar_file_watcher_test";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+    write_file(directory / "map.json", "{}");
+    write_file(directory / "other.json", "{}");
+
+    sys::file_watcher watcher;
+    REQUIRE(watcher.watch({directory / "map.json", directory / "tileset.json"}));
+    REQUIRE(watcher.poll().empty());
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+    write_file(directory / "other.json", "[]");
+    write_file(directory / "map.json", "[]");
+    write_file(directory / "map.json", "[[]]");
+    auto modified = poll_until_modified(watcher);
+    REQUIRE(modified.size() == 1);
+    REQUIRE(modified[0].filename() == "map.json");
+    REQUIRE(watcher.poll().empty());
+
+    // Saved by replacing the file, and created after being watched
+    write_file(directory / "tileset.json.tmp", "{}");
+    std::filesystem::rename(directory / "tileset.json.tmp", directory / "tileset.json");
+    modified = poll_until_modified(watcher);
+    REQUIRE(modified.size() == 1);
+    REQUIRE(modified[0].filename() == "tileset.json");
+
+    std::filesystem::remove_all(directory);
+}
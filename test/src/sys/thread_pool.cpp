@@ -0,0 +1,29 @@
+#include <catch.hpp>
+
+#include <sys/thread_pool.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+TEST_CASE("Thread pool runs every task", "[sys]") {
+    std::atomic<int> count{0};
+    std::vector<std::future<int>> results;
+    {
+        sys::thread_pool pool(4);
+        REQUIRE(pool.get_thread_count() == 4);
+        for(int i = 0; i < 100; ++i) {
+            results.push_back(pool.submit([i, &count] { ++count; return i * 2; }));
+        }
+        for(int i = 0; i < 100; ++i) {
+            REQUIRE(results[i].get() == i * 2);
+        }
+    }
+    REQUIRE(count == 100);
+}
+
+TEST_CASE("Thread pool forwards exceptions", "[sys]") {
+    sys::thread_pool pool(1);
+    auto result = pool.submit([] () -> int { throw std::runtime_error("task failed"); });
+    REQUIRE_THROWS_AS(result.get(), std::runtime_error);
+}
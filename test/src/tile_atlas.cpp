@@ -0,0 +1,70 @@
+#include <catch.hpp>
+
+#include "tile_atlas.h"
+#include "tile_lookup.h"
+#include <sdl/resource.h>
+
+#include <SDL_render.h>
+#include <SDL_surface.h>
+
+namespace {
+    auto make_image(int width, int height) -> sdl::unique_surface {
+        sdl::unique_surface image(SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_ARGB8888));
+        REQUIRE(image != nullptr);
+        return image;
+    }
+}
+
+TEST_CASE("Reloaded tileset images do not grow the atlas", "[render]") {
+    sdl::unique_surface const target = make_image(16, 16);
+    sdl::unique_renderer const renderer(SDL_CreateSoftwareRenderer(target.get()));
+    REQUIRE(renderer != nullptr);
+    tile_atlas atlas(*renderer);
+
+    // More than half a page wide and high, so that a page only holds one
+    int const side = 2100;
+    sdl::unique_surface const image = make_image(side, side);
+    REQUIRE(atlas.add("tileset.json", *image, game::tile::dimensions));
+    SDL_Rect const rect = atlas.find("tileset.json")->rect;
+    std::size_t const texture_count = atlas.get_texture_count();
+
+    // Images of the same size go where the previous one was
+    for(int i = 0; i < 4; ++i) {
+        REQUIRE(atlas.add("tileset.json", *image, game::tile::dimensions));
+        REQUIRE(atlas.get_texture_count() == texture_count);
+        REQUIRE(atlas.find("tileset.json")->rect.x == rect.x);
+        REQUIRE(atlas.find("tileset.json")->rect.y == rect.y);
+    }
+
+    // Images of another size leave the area of the previous one unused, until the atlas should be cleared
+    sdl::unique_surface const larger = make_image(side + 100, side + 100);
+    REQUIRE(atlas.add("tileset.json", *larger, game::tile::dimensions));
+    REQUIRE(atlas.find("tileset.json")->rect.w == side + 100);
+    REQUIRE(!atlas.add("tileset.json", *image, game::tile::dimensions));
+
+    atlas.clear();
+    REQUIRE(atlas.get_texture_count() == 0);
+    REQUIRE(atlas.find("tileset.json") == nullptr);
+}
+
+TEST_CASE("Tiles of another size are looked up at their size in the tileset image", "[render]") {
+    sdl::unique_surface const target = make_image(16, 16);
+    sdl::unique_renderer const renderer(SDL_CreateSoftwareRenderer(target.get()));
+    REQUIRE(renderer != nullptr);
+    tile_atlas atlas(*renderer);
+
+    // Three columns and two rows of tiles twice the game size
+    math::vector2i const tile_dimensions = game::tile::dimensions * 2;
+    sdl::unique_surface const image = make_image(tile_dimensions.x * 3, tile_dimensions.y * 2);
+    REQUIRE(atlas.add("tileset.json", *image, tile_dimensions));
+    SDL_Rect const rect = atlas.find("tileset.json")->rect;
+
+    tile_lookup const lookup({game::tileset{"tileset.json", game::tile::id(1)}}, atlas);
+    tile_lookup::tile_source const last = lookup.get_source(game::tile::id(6));
+    REQUIRE(last.texture != nullptr);
+    REQUIRE(last.rect.x == rect.x + tile_dimensions.x * 2);
+    REQUIRE(last.rect.y == rect.y + tile_dimensions.y);
+    REQUIRE(last.rect.w == tile_dimensions.x);
+    REQUIRE(last.rect.h == tile_dimensions.y);
+    REQUIRE(lookup.get_source(game::tile::id(7)).texture == nullptr);
+}
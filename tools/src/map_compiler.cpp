@@ -0,0 +1,136 @@
+#include "serial/binary_map.h"
+#include "serial/tiled.h"
+#include "sys/thread_pool.h"
+
+#include <fmt/format.h>
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+	constexpr std::string_view binary_map_extension = ".ktmap";
+
+	struct compile_job {
+		fs::path source;
+		fs::path destination;
+	};
+
+	void print_usage() {
+		fmt::print("Usage: MapCompiler [-j <threads>] <output directory> <map or directory>...\n"
+		           "Compiles Tiled JSON maps into binary maps. Directories are searched recursively for maps, and keep their structure in the output directory\n");
+	}
+
+	auto is_map_file(fs::path const& path) -> bool {
+		if(path.extension() != ".json") {
+			return false;
+		}
+		std::ifstream data(path);
+		return data && serial::is_tiled_map(data);
+	}
+
+	// Tilesets and other JSON files of a directory are skipped
+	void add_jobs(fs::path const& input, fs::path const& output_directory, std::vector<compile_job>& jobs) {
+		if(!fs::is_directory(input)) {
+			jobs.push_back({input, (output_directory / input.filename()).replace_extension(binary_map_extension)});
+			return;
+		}
+
+		for(fs::directory_entry const& entry : fs::recursive_directory_iterator(input)) {
+			if(entry.is_regular_file() && is_map_file(entry.path())) {
+				auto const relative = fs::relative(entry.path(), input);
+				jobs.push_back({entry.path(), (output_directory / relative).replace_extension(binary_map_extension)});
+			}
+		}
+	}
+
+	// Returns an error message, or an empty string on success
+	auto compile(compile_job const& job) -> std::string {
+		std::ifstream map_data(job.source);
+		if(!map_data) {
+			return fmt::format("Could not open '{}'", job.source.string());
+		}
+
+		auto const map = serial::load_tiled_json(map_data);
+		if(!map) {
+			return fmt::format("Failed to load '{}': {}", job.source.string(), map.error().description);
+		}
+
+		auto const binary = serial::compile_binary_map(*map);
+		if(!binary) {
+			return fmt::format("Failed to compile '{}': {}", job.source.string(), binary.error().description);
+		}
+
+		// Written next to the destination first, so that a running game never maps a partial file
+		std::error_code ec;
+		fs::create_directories(job.destination.parent_path(), ec);
+		fs::path temporary = job.destination;
+		temporary += ".tmp";
+		{
+			std::ofstream output(temporary, std::ios::binary | std::ios::trunc);
+			output.write(reinterpret_cast<char const*>(binary->data()), static_cast<std::streamsize>(binary->size()));
+			if(!output) {
+				return fmt::format("Could not write '{}'", temporary.string());
+			}
+		}
+
+		fs::rename(temporary, job.destination, ec);
+		if(ec) {
+			fs::remove(temporary, ec);
+			return fmt::format("Could not write '{}': {}", job.destination.string(), ec.message());
+		}
+
+		return {};
+	}
+}
+
+int main(int argc, char** argv) try {
+	unsigned thread_count = 0;
+	std::vector<std::string_view> args(argv + 1, argv + argc);
+	if(args.size() >= 2 && args[0] == "-j") {
+		thread_count = static_cast<unsigned>(std::strtoul(std::string(args[1]).c_str(), nullptr, 10));
+		args.erase(args.begin(), args.begin() + 2);
+	}
+
+	if(args.size() < 2) {
+		print_usage();
+		return EXIT_FAILURE;
+	}
+
+	fs::path const output_directory(args[0]);
+	std::vector<compile_job> jobs;
+	for(auto it = args.begin() + 1; it != args.end(); ++it) {
+		add_jobs(fs::path(*it), output_directory, jobs);
+	}
+
+	sys::thread_pool pool(thread_count);
+	std::vector<std::future<std::string>> results;
+	results.reserve(jobs.size());
+	for(compile_job const& job : jobs) {
+		results.push_back(pool.submit([&job] { return compile(job); }));
+	}
+
+	int failures = 0;
+	for(std::size_t i = 0; i < jobs.size(); ++i) {
+		std::string const result = results[i].get();
+		if(result.empty()) {
+			fmt::print("Compiled '{}' to '{}'\n", jobs[i].source.string(), jobs[i].destination.string());
+		} else {
+			fmt::print("{}\n", result);
+			++failures;
+		}
+	}
+
+	fmt::print("{} maps compiled, {} failed, on {} threads\n", jobs.size() - failures, failures, pool.get_thread_count());
+	return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+} catch(std::exception const& e) {
+	fmt::print("Uncaught exception: {}\n", e.what());
+	return EXIT_FAILURE;
+}